@@ -6,6 +6,133 @@
 namespace base {
 using bela::MapView;
 using bela::MemView;
+
+// WindowView map arbitrary windows (offset, length) of file on demand. Recently used windows are
+// cached (LRU), so resident memory is bounded by capacity windows no matter how large the file is.
+// NOTE: MemView returned by Window is valid until its window is evicted, that is, after capacity
+// other windows are mapped.
+class WindowView {
+public:
+  static constexpr size_t capacity = 4;
+  WindowView() = default;
+  WindowView(const WindowView &) = delete;
+  WindowView &operator=(const WindowView &) = delete;
+  ~WindowView() {
+    for (auto &w : windows) {
+      unmap(w);
+    }
+    if (FileMap != nullptr) {
+      CloseHandle(FileMap);
+    }
+    if (FileHandle != INVALID_HANDLE_VALUE) {
+      CloseHandle(FileHandle);
+    }
+  }
+  bool Open(std::wstring_view file, bela::error_code &ec, uint64_t minsize = 1);
+  // Attach memory such as decompressed archive member, windows are slices of it
+  void Attach(MemView mv) {
+    memory = mv.data();
+    size_ = mv.size();
+  }
+  MemView Window(uint64_t off, size_t len, bela::error_code &ec);
+  // Tail map last len bytes of file, such as ZIP end of central directory or DMG koly block
+  MemView Tail(size_t len, bela::error_code &ec) {
+    auto off = size_ > len ? size_ - len : 0;
+    return Window(off, len, ec);
+  }
+  // ReadAt copy bytes to buffer, return bytes read, 0 when window cannot be mapped
+  size_t ReadAt(uint64_t off, void *buffer, size_t len, bela::error_code &ec) {
+    auto mv = Window(off, len, ec);
+    if (mv.size() == 0) {
+      return 0;
+    }
+    memcpy(buffer, mv.data(), mv.size());
+    return mv.size();
+  }
+  uint64_t size() const { return size_; }
+
+private:
+  struct window_t {
+    uint64_t offset{0};
+    uint64_t length{0};
+    uint8_t *data{nullptr};
+    uint64_t stamp{0};
+  };
+  static void unmap(window_t &w) {
+    if (w.data != nullptr) {
+      ::UnmapViewOfFile(w.data);
+      w.data = nullptr;
+    }
+  }
+  HANDLE FileHandle{INVALID_HANDLE_VALUE};
+  HANDLE FileMap{nullptr};
+  window_t windows[capacity];
+  const uint8_t *memory{nullptr};
+  uint64_t size_{0};
+  uint64_t clock{0};
+  uint64_t granularity{64 * 1024};
+};
+
+inline bool WindowView::Open(std::wstring_view file, bela::error_code &ec, uint64_t minsize) {
+  if ((FileHandle = CreateFileW(file.data(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                                nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr)) ==
+      INVALID_HANDLE_VALUE) {
+    ec = bela::make_system_error_code();
+    return false;
+  }
+  LARGE_INTEGER li;
+  if (GetFileSizeEx(FileHandle, &li) != TRUE || (uint64_t)li.QuadPart < minsize) {
+    ec = bela::make_error_code(bela::FileSizeTooSmall, L"File size too small, size: ", li.QuadPart);
+    return false;
+  }
+  size_ = static_cast<uint64_t>(li.QuadPart);
+  if ((FileMap = CreateFileMappingW(FileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr)) ==
+      nullptr) {
+    ec = bela::make_system_error_code();
+    return false;
+  }
+  SYSTEM_INFO si;
+  GetSystemInfo(&si);
+  granularity = si.dwAllocationGranularity;
+  return true;
+}
+
+inline MemView WindowView::Window(uint64_t off, size_t len, bela::error_code &ec) {
+  if (off >= size_) {
+    ec = bela::make_error_code(bela::FileSizeTooSmall, L"offset out of file range: ", off);
+    return MemView();
+  }
+  uint64_t n = (std::min)(static_cast<uint64_t>(len), size_ - off);
+  if (memory != nullptr) {
+    return MemView(memory + off, static_cast<size_t>(n));
+  }
+  window_t *victim = &windows[0];
+  for (auto &w : windows) {
+    if (w.data != nullptr && w.offset <= off && off + n <= w.offset + w.length) {
+      w.stamp = ++clock;
+      return MemView(w.data + (off - w.offset), static_cast<size_t>(n));
+    }
+    if (w.stamp < victim->stamp) {
+      victim = &w;
+    }
+  }
+  unmap(*victim);
+  // align to allocation granularity, adjacent small reads will hit the same window
+  auto begin = off - off % granularity;
+  auto end = (std::min)((off + n + granularity - 1) / granularity * granularity, size_);
+  auto baseAddr = MapViewOfFile(FileMap, FILE_MAP_READ, static_cast<DWORD>(begin >> 32),
+                                static_cast<DWORD>(begin), static_cast<size_t>(end - begin));
+  if (baseAddr == nullptr) {
+    victim->stamp = 0;
+    ec = bela::make_system_error_code();
+    return MemView();
+  }
+  victim->data = reinterpret_cast<uint8_t *>(baseAddr);
+  victim->offset = begin;
+  victim->length = end - begin;
+  victim->stamp = ++clock;
+  return MemView(victim->data + (off - begin), static_cast<size_t>(n));
+}
 } // namespace base
 
 #endif
\ No newline at end of file
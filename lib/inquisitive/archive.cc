@@ -4,6 +4,9 @@
 #include <optional>
 #include <bela/strcat.hpp>
 #include "inquisitive.hpp"
+#include "inflate.hpp"
+#include "tar.hpp"
+#include "cab.hpp"
 
 namespace inquisitive {
 // 7z details:
@@ -40,7 +43,8 @@ status_t inquisitive_rarinternal(base::MemView mv, inquisitive_result_t &ir) {
   /*RAR 5.0 signature consists of 8 bytes: 0x52 0x61 0x72 0x21 0x1A 0x07 0x01
    * 0x00. You need to search for this signature in supposed archive from
    * beginning and up to maximum SFX module size. Just for comparison this is
-   * RAR 4.x 7 byte length signature: 0x52 0x61 0x72 0x21 0x1A 0x07 0x00.*/
+   * RAR 4.x 7 byte length signature: 0x52 0x61 0x72 0x21 0x1A 0x07 0x00.
+   * Only offset 0 is checked here, executables are searched by sfx_locate.*/
   constexpr const byte_t rarSignature[] = {0x52, 0x61, 0x72, 0x21, 0x1A, 0x07, 0x01, 0x00};
   constexpr const byte_t rar4Signature[] = {0x52, 0x61, 0x72, 0x21, 0x1A, 0x07, 0x00};
   if (mv.StartsWith(rarSignature)) {
@@ -159,6 +163,12 @@ status_t inquisitive_pdfinternal(base::MemView mv, inquisitive_result_t &ir) {
     return None;
   }
   ir.assign(std::move(buf), types::pdf);
+  // linearization dictionary is the first object, it must lie within the first 1024 bytes
+  constexpr std::string_view linearized = "/Linearized";
+  if (byte_search(mv.data(), (std::min)(mv.size(), size_t(1024)), linearized.data(),
+                  linearized.size()) != nullptr) {
+    ir.add(L"Linearized", std::wstring_view(L"yes"));
+  }
   return Found;
 }
 
@@ -258,37 +268,6 @@ status_t inquisitive_wiminternal(base::MemView mv, inquisitive_result_t &ir) {
 }
 
 // cab Microsoft Cabinet Format
-// https://docs.microsoft.com/en-us/previous-versions//bb267310(v=vs.85)
-
-struct cabinet_header_t {
-  uint8_t signature[4]; // M','S','C','F'
-  uint32_t reserved1;   //// 00000
-  uint32_t cbCabinet;
-  uint32_t reserved2;
-  uint32_t coffFiles;   /* offset of the first CFFILE entry */
-  uint32_t reserved3;   /* reserved */
-  uint8_t versionMinor; /* cabinet file format version, minor */
-  uint8_t versionMajor; /* cabinet file format version, major */
-  uint16_t cFolders;    /* number of CFFOLDER entries in this */
-                        /*    cabinet */
-  uint16_t cFiles;      /* number of CFFILE entries in this cabinet */
-  uint16_t flags;       /* cabinet file option indicators */
-  uint16_t setID;       /* must be the same for all cabinets in a */
-                        /*    set */
-  uint16_t iCabinet;    /* number of this cabinet file in a set */
-  uint16_t cbCFHeader;  /* (optional) size of per-cabinet reserved */
-                        /*    area */
-  uint8_t cbCFFolder;   /* (optional) size of per-folder reserved */
-                        /*    area */
-  uint8_t cbCFData;     /* (optional) size of per-datablock reserved */
-                        /*    area */
-  // uint8_t  abReserve[];      /* (optional) per-cabinet reserved area */
-  // uint8_t  szCabinetPrev[];  /* (optional) name of previous cabinet file */
-  // uint8_t  szDiskPrev[];     /* (optional) name of previous disk */
-  // uint8_t  szCabinetNext[];  /* (optional) name of next cabinet file */
-  // uint8_t  szDiskNext[];     /* (optional) name of next disk */
-};
-
 status_t inquisitive_cabinetinternal(base::MemView mv, inquisitive_result_t &ir) {
   constexpr const byte_t cabMagic[] = {'M', 'S', 'C', 'F', 0, 0, 0, 0};
   if (!mv.StartsWith(cabMagic)) {
@@ -306,65 +285,6 @@ status_t inquisitive_cabinetinternal(base::MemView mv, inquisitive_result_t &ir)
 
 // TAR
 // https://github.com/libarchive/libarchive/blob/master/libarchive/archive_read_support_format_tar.c#L54
-
-#pragma pack(1)
-struct ustar_header_t {
-  char name[100];
-  char mode[8];
-  char uid[8];
-  char gid[8];
-  char size[12];
-  char mtime[12];
-  char checksum[8];
-  char typeflag;
-  char linkname[100]; /* "old format" header ends here */
-  char magic[6];      /* For POSIX: "ustar\0" */
-  char version[2];    /* For POSIX: "00" */
-  char uname[32];
-  char gname[32];
-  char rdevmajor[8];
-  char rdevminor[8];
-  char prefix[155];
-};
-
-/*
- * Structure of GNU tar header
- */
-struct gnu_sparse_t {
-  char offset[12];
-  char numbytes[12];
-};
-
-struct gnutar_header_t {
-  char name[100];
-  char mode[8];
-  char uid[8];
-  char gid[8];
-  char size[12];
-  char mtime[12];
-  char checksum[8];
-  char typeflag;
-  char linkname[100];
-  char magic[8]; /* "ustar  \0" (note blank/blank/null at end) */
-  char uname[32];
-  char gname[32];
-  char rdevmajor[8];
-  char rdevminor[8];
-  char atime[12];
-  char ctime[12];
-  char offset[12];
-  char longnames[4];
-  char unused;
-  gnu_sparse_t sparse[4];
-  char isextended;
-  char realsize[12];
-  /*
-   * Old GNU format doesn't use POSIX 'prefix' field; they use
-   * the 'L' (longname) entry instead.
-   */
-};
-#pragma pack()
-
 status_t inquisitive_tarinternal(base::MemView mv, inquisitive_result_t &ir) {
   auto hd = mv.cast<ustar_header_t>(0);
   if (hd == nullptr) {
@@ -384,11 +304,56 @@ status_t inquisitive_tarinternal(base::MemView mv, inquisitive_result_t &ir) {
   return None;
 }
 
+// https://www.sqlite.org/fileformat.html#the_database_header
+#pragma pack(1)
 struct sqlite_header_t {
   uint8_t sigver[16];
-  uint16_t pagesize;
-  uint16_t version;
+  uint16_t pagesize; /// 1 means 65536
+  uint8_t writeversion;
+  uint8_t readversion; /// 1 legacy, 2 WAL
+  uint8_t reserved;    /// unused bytes at end of each page
+  uint8_t maxpayload;
+  uint8_t minpayload;
+  uint8_t leafpayload;
+  uint32_t changecounter;
+  uint32_t pagecount; /// valid only when versionvalidfor equals changecounter
+  uint32_t freelisttrunk;
+  uint32_t freelistcount;
+  uint32_t schemacookie;
+  uint32_t schemaformat;
+  uint32_t cachesize;
+  uint32_t autovacuumtop;
+  uint32_t textencoding;
+  uint32_t userversion;
+  uint32_t incrementalvacuum;
+  uint32_t applicationid;
+  uint8_t unused[20];
+  uint32_t versionvalidfor;
+  uint32_t sqliteversion;
 };
+#pragma pack()
+
+// PRAGMA application_id of well known formats
+// https://www.sqlite.org/src/artifact?ci=trunk&filename=magic.txt
+const wchar_t *sqlite_application(uint32_t id) {
+  switch (id) {
+  case 0x47504B47: // GPKG
+  case 0x47503130: // GP10
+  case 0x47503131: // GP11
+    return L"GeoPackage";
+  case 0x4D504258: // MPBX
+    return L"MBTiles";
+  case 0x0F055111:
+    return L"Fossil repository";
+  case 0x0F055112:
+    return L"Fossil checkout";
+  case 0x0F055113:
+    return L"Fossil global configuration";
+  default:
+    break;
+  }
+  return nullptr;
+}
 
 status_t inquisitive_sqliteinternal(base::MemView mv, inquisitive_result_t &ir) {
   constexpr const byte_t sqliteMagic[] = {'S', 'Q', 'L', 'i', 't', 'e', ' ',
@@ -400,8 +365,43 @@ status_t inquisitive_sqliteinternal(base::MemView mv, inquisitive_result_t &ir)
   if (hd == nullptr || hd->sigver[15] != 0) {
     return None;
   }
-  std::wstring name = bela::StringCat(L"SQLite DB, format ", (int)hd->sigver[14]);
+  std::wstring name = bela::StringCat(L"SQLite DB, format ", static_cast<wchar_t>(hd->sigver[14]));
+  auto application = sqlite_application(bela::swapbe(hd->applicationid));
+  if (application != nullptr) {
+    name.append(L", ").append(application);
+  }
   ir.assign(std::move(name), types::sqlite);
+  ir.add(L"Page Size", sqlite_page_size(bela::swapbe(hd->pagesize)));
+  auto changecounter = bela::swapbe(hd->changecounter);
+  auto pagecount = bela::swapbe(hd->pagecount);
+  // written by SQLite older than 3.7.0 when stale
+  if (pagecount != 0 && bela::swapbe(hd->versionvalidfor) == changecounter) {
+    ir.add(L"Pages", pagecount);
+  }
+  ir.add(L"Freelist Pages", bela::swapbe(hd->freelistcount));
+  switch (bela::swapbe(hd->textencoding)) {
+  case 1:
+    ir.add(L"Text Encoding", std::wstring_view(L"UTF-8"));
+    break;
+  case 2:
+    ir.add(L"Text Encoding", std::wstring_view(L"UTF-16le"));
+    break;
+  case 3:
+    ir.add(L"Text Encoding", std::wstring_view(L"UTF-16be"));
+    break;
+  default:
+    break;
+  }
+  ir.add(L"User Version", bela::swapbe(hd->userversion));
+  ir.add(L"Application ID", bela::StringCat(L"0x", bela::Hex(bela::swapbe(hd->applicationid),
+                                                            bela::kZeroPad8)));
+  ir.add(L"Journal Mode", std::wstring_view(hd->readversion == 2 && hd->writeversion == 2
+                                                ? L"WAL"
+                                                : L"rollback"));
+  if (auto version = bela::swapbe(hd->sqliteversion); version != 0) {
+    ir.add(L"SQLite Version", bela::StringCat(version / 1000000, L".", version / 1000 % 1000,
+                                              L".", version % 1000));
+  }
   return Found;
 }
 
@@ -468,6 +468,24 @@ status_t inquisitive_archivesinternal(base::MemView mv, inquisitive_result_t &ir
     return Found;
   }
 
+  // Zstandard and LZ4 frames. Data frame after skippable frame tells which, when it is beyond
+  // prefix zstd is assumed (pzstd writes skippable frames)
+  // https://github.com/facebook/zstd/blob/dev/doc/zstd_compression_format.md
+  // https://github.com/lz4/lz4/blob/dev/doc/lz4_Frame_format.md
+  auto magic = mv.size() >= 4 ? bela::readle<uint32_t>(mv.data()) : 0;
+  if ((magic & 0xFFFFFFF0) == 0x184D2A50 && mv.size() >= 12) {
+    auto skip = bela::readle<uint32_t>(mv.data() + 4);
+    magic = skip <= mv.size() - 12 ? bela::readle<uint32_t>(mv.data() + 8 + skip) : 0xFD2FB528;
+  }
+  if (magic == 0xFD2FB528) {
+    ir.assign(L"Zstandard compressed data", types::zstd);
+    return Found;
+  }
+  if (magic == 0x184D2204 || magic == 0x184C2102) {
+    ir.assign(L"LZ4 compressed data", types::lz4);
+    return Found;
+  }
+
   // NES
   constexpr const byte_t nesMagic[] = {0x41, 0x45, 0x53, 0x1A};
   if (mv.StartsWith(nesMagic)) {
@@ -501,6 +519,87 @@ status_t inquisitive_archivesinternal(base::MemView mv, inquisitive_result_t &ir
   return None;
 }
 
+// GZIP member header
+// https://www.rfc-editor.org/rfc/rfc1952
+#pragma pack(1)
+struct gzip_header_t {
+  uint8_t id1; // 0x1F
+  uint8_t id2; // 0x8B
+  uint8_t method;
+  uint8_t flags;
+  uint32_t mtime;
+  uint8_t xflags;
+  uint8_t os;
+};
+#pragma pack()
+constexpr uint8_t gzipHeaderCRC = 0x02;
+constexpr uint8_t gzipExtra = 0x04;
+constexpr uint8_t gzipName = 0x08;
+constexpr uint8_t gzipComment = 0x10;
+
+// offset of DEFLATE data, 0 when header is invalid or truncated
+size_t gzip_data_offset(base::MemView mv) {
+  auto hd = mv.cast<gzip_header_t>(0);
+  if (hd == nullptr || hd->id1 != 0x1F || hd->id2 != 0x8B || hd->method != 8) {
+    return 0;
+  }
+  size_t offset = sizeof(gzip_header_t);
+  if ((hd->flags & gzipExtra) != 0) {
+    if (offset + 2 > mv.size()) {
+      return 0;
+    }
+    offset += 2 + bela::readle<uint16_t>(mv.data() + offset);
+  }
+  for (auto f : {gzipName, gzipComment}) {
+    if ((hd->flags & f) == 0) {
+      continue;
+    }
+    if (offset >= mv.size()) {
+      return 0;
+    }
+    offset += byte_strnlen(mv.data() + offset, mv.size() - offset) + 1;
+  }
+  if ((hd->flags & gzipHeaderCRC) != 0) {
+    offset += 2;
+  }
+  return offset < mv.size() ? offset : 0;
+}
+
+std::string_view gzip_member_name(base::MemView mv) {
+  auto hd = mv.cast<gzip_header_t>(0);
+  if (hd == nullptr || hd->id1 != 0x1F || hd->id2 != 0x8B || (hd->flags & gzipName) == 0) {
+    return std::string_view();
+  }
+  size_t offset = sizeof(gzip_header_t);
+  if ((hd->flags & gzipExtra) != 0) {
+    if (offset + 2 > mv.size()) {
+      return std::string_view();
+    }
+    offset += 2 + bela::readle<uint16_t>(mv.data() + offset);
+  }
+  if (offset >= mv.size()) {
+    return std::string_view();
+  }
+  auto name = reinterpret_cast<const char *>(mv.data() + offset);
+  return std::string_view(name, byte_strnlen(name, mv.size() - offset));
+}
+
+status_t inquisitive_gzip_content(base::MemView mv, inquisitive_result_t &ir) {
+  auto offset = gzip_data_offset(mv);
+  if (offset == 0) {
+    return None;
+  }
+  inflate_stream s;
+  s.reset(mv.data() + offset, mv.size() - offset);
+  auto out = s.read(inflate_sniff_size);
+  inquisitive_result_t content;
+  if (out.size() == 0 || inquisitive_memview(out, content) != Found) {
+    return None;
+  }
+  ir.add(L"Content", content.description());
+  return Found;
+}
+
 status_t inquisitive_archives(base::MemView mv, inquisitive_result_t &ir) {
   if (inquisitive_7zinternal(mv, ir) == Found) {
     return Found;
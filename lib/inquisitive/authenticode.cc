@@ -0,0 +1,99 @@
+/// PE Authenticode image digest
+#include <atomic>
+#include <thread>
+#include <bela/hash.hpp>
+#include <bela/peview.hpp>
+#include "inquisitive.hpp"
+
+// https://download.microsoft.com/download/9/c/5/9c5b2167-8017-4bae-9fde-d599bac8184a/Authenticode_PE.docx
+
+namespace inquisitive {
+
+// walk certificate table, each WIN_CERTIFICATE is 8-byte aligned
+void authenticode_certificates(const bela::pe::ImageView &iv, pe_authenticode_t &pa) {
+  auto dd = iv.Directory(bela::pe::DirectorySecurity);
+  if (dd.VirtualAddress == 0 || dd.Size == 0) {
+    return;
+  }
+  uint64_t off = dd.VirtualAddress; // file offset, not RVA
+  uint64_t end = off + dd.Size;
+  while (off + sizeof(bela::pe::WinCertificate) <= end) {
+    auto wc = iv.FileCast<bela::pe::WinCertificate>(off);
+    if (wc == nullptr) {
+      break;
+    }
+    auto length = bela::swaple(wc->Length);
+    if (length < sizeof(bela::pe::WinCertificate) || off + length > end) {
+      break;
+    }
+    pa.certificates.emplace_back(pe_certificate_t{off, length, bela::swaple(wc->Revision),
+                                                  bela::swaple(wc->CertificateType)});
+    off += (static_cast<uint64_t>(length) + 7) & ~uint64_t(7);
+  }
+}
+
+std::optional<pe_authenticode_t> inquisitive_authenticode(std::wstring_view sv,
+                                                          bela::error_code &ec) {
+  base::MapView mmv;
+  if (!mmv.MappingView(sv, ec, sizeof(bela::pe::DosHeader) + sizeof(bela::pe::FileHeader))) {
+    return std::nullopt;
+  }
+  bela::pe::ImageView iv;
+  if (auto status = iv.Parse(mmv.subview()); status != bela::pe::ParseStatus::OK) {
+    ec = bela::make_error_code(bela::FileSizeTooSmall, bela::pe::ParseStatusMessage(status));
+    return std::nullopt;
+  }
+  std::vector<bela::pe::FileRange> ranges;
+  if (!iv.AuthenticodeRanges(ranges)) {
+    ec = bela::make_error_code(bela::ParseBroken, L"PE headers or sections out of file range");
+    return std::nullopt;
+  }
+  // one pass over mapped image, every chunk feeds both hashers while it is still in cache
+  constexpr size_t chunksize = 64 * 1024;
+  bela::hash::sha256::Hasher h256;
+  bela::hash::sha512::Hasher h512;
+  h256.Initialize();
+  h512.Initialize();
+  auto base = iv.Image().data();
+  for (const auto &r : ranges) {
+    for (uint64_t off = 0; off < r.Size; off += chunksize) {
+      auto n = static_cast<size_t>((std::min)(static_cast<uint64_t>(chunksize), r.Size - off));
+      h256.Update(base + r.Offset + off, n);
+      h512.Update(base + r.Offset + off, n);
+    }
+  }
+  pe_authenticode_t pa;
+  pa.sha256 = h256.Finalize();
+  pa.sha512 = h512.Finalize();
+  authenticode_certificates(iv, pa);
+  return std::make_optional(std::move(pa));
+}
+
+std::vector<pe_authenticode_result_t>
+inquisitive_authenticode(const std::vector<std::wstring> &files, uint32_t concurrency) {
+  std::vector<pe_authenticode_result_t> results(files.size());
+  if (concurrency == 0) {
+    concurrency = (std::max)(std::thread::hardware_concurrency(), 1u);
+  }
+  concurrency = (std::min)(concurrency, static_cast<uint32_t>(files.size()));
+  // workers take next file by atomic index, results are stored in input order
+  std::atomic_size_t next{0};
+  auto worker = [&]() {
+    for (auto i = next++; i < files.size(); i = next++) {
+      auto &r = results[i];
+      r.file = files[i];
+      r.authenticode = inquisitive_authenticode(files[i], r.ec);
+    }
+  };
+  std::vector<std::thread> workers;
+  workers.reserve(concurrency);
+  for (uint32_t i = 0; i < concurrency; i++) {
+    workers.emplace_back(worker);
+  }
+  for (auto &w : workers) {
+    w.join();
+  }
+  return results;
+}
+
+} // namespace inquisitive
@@ -0,0 +1,363 @@
+/// byte search shared by detectors
+#include <bela/bits.hpp>
+#include "inquisitive.hpp"
+
+// SIMD substring search filters candidates by first and last byte of needle, only candidates are
+// compared with memcmp.
+// http://0x80.pl/articles/simd-strfind.html
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+#define INQUISITIVE_SEARCH_X86 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#include <immintrin.h>
+#endif
+
+#if defined(INQUISITIVE_SEARCH_X86) && (defined(__GNUC__) || defined(__clang__))
+#define SEARCH_TARGET_SSE2 __attribute__((target("sse2")))
+#define SEARCH_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define SEARCH_TARGET_SSE2
+#define SEARCH_TARGET_AVX2
+#endif
+
+namespace inquisitive {
+using bela::base_internal::CountLeadingZeros32;
+using bela::base_internal::CountTrailingZerosNonZero32;
+
+using search_fn_t = const uint8_t *(*)(const uint8_t *, size_t, const uint8_t *, size_t);
+using search_any_fn_t = const uint8_t *(*)(const uint8_t *, size_t, const std::string_view *,
+                                           size_t, size_t &);
+
+// needle fits at pos and matches
+inline bool needle_at(const uint8_t *haystack, size_t haylen, size_t pos, std::string_view n) {
+  return n.size() <= haylen - pos && memcmp(haystack + pos, n.data(), n.size()) == 0;
+}
+
+const uint8_t *search_scalar(const uint8_t *haystack, size_t haylen, const uint8_t *needle,
+                             size_t neelen) {
+  if (haylen < neelen) {
+    return nullptr;
+  }
+  auto p = haystack;
+  auto last = haystack + haylen - neelen;
+  while (p <= last) {
+    // CRT memchr is already vectorized, scalar fallback leans on it
+    p = reinterpret_cast<const uint8_t *>(memchr(p, needle[0], last - p + 1));
+    if (p == nullptr) {
+      return nullptr;
+    }
+    if (memcmp(p + 1, needle + 1, neelen - 1) == 0) {
+      return p;
+    }
+    p++;
+  }
+  return nullptr;
+}
+
+const uint8_t *rsearch_scalar(const uint8_t *haystack, size_t haylen, const uint8_t *needle,
+                              size_t neelen) {
+  if (haylen < neelen) {
+    return nullptr;
+  }
+  for (size_t pos = haylen - neelen + 1; pos-- > 0;) {
+    if (haystack[pos] == needle[0] && memcmp(haystack + pos + 1, needle + 1, neelen - 1) == 0) {
+      return haystack + pos;
+    }
+  }
+  return nullptr;
+}
+
+const uint8_t *search_any_scalar(const uint8_t *haystack, size_t haylen,
+                                 const std::string_view *needles, size_t count, size_t &which) {
+  for (size_t pos = 0; pos < haylen; pos++) {
+    for (size_t k = 0; k < count; k++) {
+      if (!needles[k].empty() && static_cast<uint8_t>(needles[k][0]) == haystack[pos] &&
+          needle_at(haystack, haylen, pos, needles[k])) {
+        which = k;
+        return haystack + pos;
+      }
+    }
+  }
+  return nullptr;
+}
+
+#if defined(INQUISITIVE_SEARCH_X86)
+SEARCH_TARGET_SSE2 const uint8_t *search_sse2(const uint8_t *haystack, size_t haylen,
+                                              const uint8_t *needle, size_t neelen) {
+  constexpr size_t width = 16;
+  if (haylen < neelen) {
+    return nullptr;
+  }
+  const auto first = _mm_set1_epi8(static_cast<char>(needle[0]));
+  const auto last = _mm_set1_epi8(static_cast<char>(needle[neelen - 1]));
+  size_t i = 0;
+  for (; i + width + neelen - 1 <= haylen; i += width) {
+    auto b0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(haystack + i));
+    auto b1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(haystack + i + neelen - 1));
+    auto mask = static_cast<uint32_t>(
+        _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(b0, first), _mm_cmpeq_epi8(b1, last))));
+    while (mask != 0) {
+      auto pos = i + CountTrailingZerosNonZero32(mask);
+      if (neelen <= 2 || memcmp(haystack + pos + 1, needle + 1, neelen - 2) == 0) {
+        return haystack + pos;
+      }
+      mask &= mask - 1;
+    }
+  }
+  return search_scalar(haystack + i, haylen - i, needle, neelen);
+}
+
+SEARCH_TARGET_AVX2 const uint8_t *search_avx2(const uint8_t *haystack, size_t haylen,
+                                              const uint8_t *needle, size_t neelen) {
+  constexpr size_t width = 32;
+  if (haylen < neelen) {
+    return nullptr;
+  }
+  const auto first = _mm256_set1_epi8(static_cast<char>(needle[0]));
+  const auto last = _mm256_set1_epi8(static_cast<char>(needle[neelen - 1]));
+  size_t i = 0;
+  for (; i + width + neelen - 1 <= haylen; i += width) {
+    auto b0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(haystack + i));
+    auto b1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(haystack + i + neelen - 1));
+    auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(
+        _mm256_and_si256(_mm256_cmpeq_epi8(b0, first), _mm256_cmpeq_epi8(b1, last))));
+    while (mask != 0) {
+      auto pos = i + CountTrailingZerosNonZero32(mask);
+      if (neelen <= 2 || memcmp(haystack + pos + 1, needle + 1, neelen - 2) == 0) {
+        return haystack + pos;
+      }
+      mask &= mask - 1;
+    }
+  }
+  return search_scalar(haystack + i, haylen - i, needle, neelen);
+}
+
+// blocks are visited from the end and candidates from the highest bit, head is left to scalar
+SEARCH_TARGET_SSE2 const uint8_t *rsearch_sse2(const uint8_t *haystack, size_t haylen,
+                                               const uint8_t *needle, size_t neelen) {
+  constexpr size_t width = 16;
+  if (haylen < neelen) {
+    return nullptr;
+  }
+  const auto first = _mm_set1_epi8(static_cast<char>(needle[0]));
+  const auto last = _mm_set1_epi8(static_cast<char>(needle[neelen - 1]));
+  // candidate positions not yet visited are [0, count)
+  size_t count = haylen - neelen + 1;
+  for (; count >= width; count -= width) {
+    auto i = count - width;
+    auto b0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(haystack + i));
+    auto b1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(haystack + i + neelen - 1));
+    auto mask = static_cast<uint32_t>(
+        _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(b0, first), _mm_cmpeq_epi8(b1, last))));
+    while (mask != 0) {
+      auto bit = 31 - CountLeadingZeros32(mask);
+      auto pos = i + bit;
+      if (neelen <= 2 || memcmp(haystack + pos + 1, needle + 1, neelen - 2) == 0) {
+        return haystack + pos;
+      }
+      mask &= ~(1u << bit);
+    }
+  }
+  return rsearch_scalar(haystack, count + neelen - 1, needle, neelen);
+}
+
+SEARCH_TARGET_AVX2 const uint8_t *rsearch_avx2(const uint8_t *haystack, size_t haylen,
+                                               const uint8_t *needle, size_t neelen) {
+  constexpr size_t width = 32;
+  if (haylen < neelen) {
+    return nullptr;
+  }
+  const auto first = _mm256_set1_epi8(static_cast<char>(needle[0]));
+  const auto last = _mm256_set1_epi8(static_cast<char>(needle[neelen - 1]));
+  size_t count = haylen - neelen + 1;
+  for (; count >= width; count -= width) {
+    auto i = count - width;
+    auto b0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(haystack + i));
+    auto b1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(haystack + i + neelen - 1));
+    auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(
+        _mm256_and_si256(_mm256_cmpeq_epi8(b0, first), _mm256_cmpeq_epi8(b1, last))));
+    while (mask != 0) {
+      auto bit = 31 - CountLeadingZeros32(mask);
+      auto pos = i + bit;
+      if (neelen <= 2 || memcmp(haystack + pos + 1, needle + 1, neelen - 2) == 0) {
+        return haystack + pos;
+      }
+      mask &= ~(1u << bit);
+    }
+  }
+  return rsearch_scalar(haystack, count + neelen - 1, needle, neelen);
+}
+
+// candidates of every needle are merged, so the earliest match wins and ties go to lower index
+SEARCH_TARGET_SSE2 const uint8_t *search_any_sse2(const uint8_t *haystack, size_t haylen,
+                                                  const std::string_view *needles, size_t count,
+                                                  size_t &which) {
+  constexpr size_t width = 16;
+  size_t maxlen = 1;
+  for (size_t k = 0; k < count; k++) {
+    maxlen = (std::max)(maxlen, needles[k].size());
+  }
+  size_t i = 0;
+  for (; i + width + maxlen - 1 <= haylen; i += width) {
+    auto b0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(haystack + i));
+    uint32_t mask = 0;
+    for (size_t k = 0; k < count; k++) {
+      const auto &n = needles[k];
+      if (n.empty()) {
+        continue;
+      }
+      auto b1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(haystack + i + n.size() - 1));
+      auto eq0 = _mm_cmpeq_epi8(b0, _mm_set1_epi8(n.front()));
+      auto eq1 = _mm_cmpeq_epi8(b1, _mm_set1_epi8(n.back()));
+      mask |= static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(eq0, eq1)));
+    }
+    while (mask != 0) {
+      auto pos = i + CountTrailingZerosNonZero32(mask);
+      for (size_t k = 0; k < count; k++) {
+        if (!needles[k].empty() && needle_at(haystack, haylen, pos, needles[k])) {
+          which = k;
+          return haystack + pos;
+        }
+      }
+      mask &= mask - 1;
+    }
+  }
+  return search_any_scalar(haystack + i, haylen - i, needles, count, which);
+}
+
+SEARCH_TARGET_AVX2 const uint8_t *search_any_avx2(const uint8_t *haystack, size_t haylen,
+                                                  const std::string_view *needles, size_t count,
+                                                  size_t &which) {
+  constexpr size_t width = 32;
+  size_t maxlen = 1;
+  for (size_t k = 0; k < count; k++) {
+    maxlen = (std::max)(maxlen, needles[k].size());
+  }
+  size_t i = 0;
+  for (; i + width + maxlen - 1 <= haylen; i += width) {
+    auto b0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(haystack + i));
+    uint32_t mask = 0;
+    for (size_t k = 0; k < count; k++) {
+      const auto &n = needles[k];
+      if (n.empty()) {
+        continue;
+      }
+      auto b1 =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i *>(haystack + i + n.size() - 1));
+      auto eq0 = _mm256_cmpeq_epi8(b0, _mm256_set1_epi8(n.front()));
+      auto eq1 = _mm256_cmpeq_epi8(b1, _mm256_set1_epi8(n.back()));
+      mask |= static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(eq0, eq1)));
+    }
+    while (mask != 0) {
+      auto pos = i + CountTrailingZerosNonZero32(mask);
+      for (size_t k = 0; k < count; k++) {
+        if (!needles[k].empty() && needle_at(haystack, haylen, pos, needles[k])) {
+          which = k;
+          return haystack + pos;
+        }
+      }
+      mask &= mask - 1;
+    }
+  }
+  return search_any_scalar(haystack + i, haylen - i, needles, count, which);
+}
+
+bool cpu_has_avx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+  int regs[4] = {0};
+  __cpuid(regs, 0);
+  if (regs[0] < 7) {
+    return false;
+  }
+  __cpuid(regs, 1);
+  // OSXSAVE and AVX, then OS must save YMM state
+  constexpr int osxsave_avx = (1 << 27) | (1 << 28);
+  if ((regs[2] & osxsave_avx) != osxsave_avx || (_xgetbv(0) & 6) != 6) {
+    return false;
+  }
+  __cpuidex(regs, 7, 0);
+  return (regs[1] & (1 << 5)) != 0;
+#else
+  return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+
+bool cpu_has_sse2() {
+#if defined(_M_X64) || defined(__x86_64__)
+  return true;
+#elif defined(_MSC_VER) && !defined(__clang__)
+  int regs[4] = {0};
+  __cpuid(regs, 1);
+  return (regs[3] & (1 << 26)) != 0;
+#else
+  return __builtin_cpu_supports("sse2") != 0;
+#endif
+}
+#endif
+
+struct search_dispatch_t {
+  search_fn_t search{search_scalar};
+  search_fn_t rsearch{rsearch_scalar};
+  search_any_fn_t search_any{search_any_scalar};
+};
+
+// resolved once, ARM64 and other targets keep scalar fallback
+const search_dispatch_t &search_dispatch() {
+  static const search_dispatch_t dispatch = []() {
+    search_dispatch_t d;
+#if defined(INQUISITIVE_SEARCH_X86)
+    if (cpu_has_avx2()) {
+      d.search = search_avx2;
+      d.rsearch = rsearch_avx2;
+      d.search_any = search_any_avx2;
+    } else if (cpu_has_sse2()) {
+      d.search = search_sse2;
+      d.rsearch = rsearch_sse2;
+      d.search_any = search_any_sse2;
+    }
+#endif
+    return d;
+  }();
+  return dispatch;
+}
+
+const uint8_t *byte_search(const uint8_t *haystack, size_t haylen, const void *needle,
+                           size_t neelen) {
+  if (neelen == 0) {
+    return haystack;
+  }
+  return search_dispatch().search(haystack, haylen, reinterpret_cast<const uint8_t *>(needle),
+                                  neelen);
+}
+
+const uint8_t *byte_rsearch(const uint8_t *haystack, size_t haylen, const void *needle,
+                            size_t neelen) {
+  if (haylen < neelen) {
+    return nullptr;
+  }
+  if (neelen == 0) {
+    return haystack + haylen;
+  }
+  return search_dispatch().rsearch(haystack, haylen, reinterpret_cast<const uint8_t *>(needle),
+                                   neelen);
+}
+
+const uint8_t *byte_search_any(const uint8_t *haystack, size_t haylen,
+                               const std::string_view *needles, size_t count, size_t &which) {
+  if (count == 1) {
+    which = 0;
+    return byte_search(haystack, haylen, needles[0].data(), needles[0].size());
+  }
+  return search_dispatch().search_any(haystack, haylen, needles, count, which);
+}
+
+size_t byte_strnlen(const void *p, size_t maxlen) {
+  constexpr uint8_t nul = 0;
+  auto b = reinterpret_cast<const uint8_t *>(p);
+  auto e = search_dispatch().search(b, maxlen, &nul, 1);
+  return e == nullptr ? maxlen : static_cast<size_t>(e - b);
+}
+
+} // namespace inquisitive
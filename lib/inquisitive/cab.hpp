@@ -0,0 +1,78 @@
+//// CAB
+#ifndef INQUISITIVE_CAB_HPP
+#define INQUISITIVE_CAB_HPP
+#include <cstddef>
+#include <cstdint>
+// https://docs.microsoft.com/en-us/previous-versions//bb267310(v=vs.85)
+
+namespace inquisitive {
+struct cabinet_header_t {
+  uint8_t signature[4]; // M','S','C','F'
+  uint32_t reserved1;   //// 00000
+  uint32_t cbCabinet;
+  uint32_t reserved2;
+  uint32_t coffFiles;   /* offset of the first CFFILE entry */
+  uint32_t reserved3;   /* reserved */
+  uint8_t versionMinor; /* cabinet file format version, minor */
+  uint8_t versionMajor; /* cabinet file format version, major */
+  uint16_t cFolders;    /* number of CFFOLDER entries in this */
+                        /*    cabinet */
+  uint16_t cFiles;      /* number of CFFILE entries in this cabinet */
+  uint16_t flags;       /* cabinet file option indicators */
+  uint16_t setID;       /* must be the same for all cabinets in a */
+                        /*    set */
+  uint16_t iCabinet;    /* number of this cabinet file in a set */
+  uint16_t cbCFHeader;  /* (optional) size of per-cabinet reserved */
+                        /*    area */
+  uint8_t cbCFFolder;   /* (optional) size of per-folder reserved */
+                        /*    area */
+  uint8_t cbCFData;     /* (optional) size of per-datablock reserved */
+                        /*    area */
+  // uint8_t  abReserve[];      /* (optional) per-cabinet reserved area */
+  // uint8_t  szCabinetPrev[];  /* (optional) name of previous cabinet file */
+  // uint8_t  szDiskPrev[];     /* (optional) name of previous disk */
+  // uint8_t  szCabinetNext[];  /* (optional) name of next cabinet file */
+  // uint8_t  szDiskNext[];     /* (optional) name of next disk */
+};
+
+#pragma pack(1)
+struct cabinet_folder_t {
+  uint32_t coffCabStart; /* offset of the first CFDATA block in this folder */
+  uint16_t cCFData;      /* number of CFDATA blocks in this folder */
+  uint16_t typeCompress; /* compression type indicator */
+  // uint8_t  abReserve[];  /* (optional) per-folder reserved area */
+};
+
+struct cabinet_file_t {
+  uint32_t cbFile;          /* uncompressed size of this file in bytes */
+  uint32_t uoffFolderStart; /* uncompressed offset of this file in the folder */
+  uint16_t iFolder;         /* index into the CFFOLDER area */
+  uint16_t date;            /* date stamp for this file */
+  uint16_t time;            /* time stamp for this file */
+  uint16_t attribs;         /* attribute flags for this file */
+  // uint8_t  szName[];     /* name of this file */
+};
+
+struct cabinet_data_t {
+  uint32_t csum;     /* checksum of this CFDATA entry */
+  uint16_t cbData;   /* number of compressed bytes in this block */
+  uint16_t cbUncomp; /* number of uncompressed bytes in this block */
+  // uint8_t  abReserve[];  /* (optional) per-datablock reserved area */
+  // uint8_t  ab[cbData];   /* compressed data bytes */
+};
+#pragma pack()
+
+// header ends at cbCFHeader, reserve sizes are present only with cabinet_flag_reserve
+constexpr size_t cabinet_header_size = 36;
+constexpr uint16_t cabinet_flag_prev = 0x0001;
+constexpr uint16_t cabinet_flag_next = 0x0002;
+constexpr uint16_t cabinet_flag_reserve = 0x0004;
+constexpr uint16_t cabinet_compress_mask = 0x000F;
+constexpr uint16_t cabinet_compress_none = 0;
+constexpr uint16_t cabinet_compress_mszip = 1;
+// iFolder of files continued from or to other cabinets
+constexpr uint16_t cabinet_folder_continued = 0xFFFD;
+
+} // namespace inquisitive
+
+#endif
@@ -0,0 +1,543 @@
+/// compressed stream headers and trailers: gzip, xz, bzip2, zstd and lz4
+#include <bela/codecvt.hpp>
+#include <bela/strcat.hpp>
+#include "inquisitive.hpp"
+
+namespace inquisitive {
+// gzip header with extra field, name and comment fits in it
+constexpr size_t compressed_header_max = 64 * 1024;
+// BGZF header: fixed 12 bytes, XLEN 6 and BC subfield 6
+constexpr size_t bgzf_header_size = 18;
+// xz index of larger stream is not mapped
+constexpr uint64_t xz_index_max = 64 * 1024 * 1024;
+constexpr size_t xz_header_size = 12;
+constexpr uint32_t zstd_magic = 0xFD2FB528;
+constexpr uint32_t zstd_block_max = 128 * 1024;
+constexpr uint32_t lz4_magic = 0x184D2204;
+constexpr uint32_t lz4_legacy_magic = 0x184C2102;
+constexpr uint32_t lz4_legacy_block_max = 8 * 1024 * 1024;
+// zstd and lz4 skippable frames are 0x184D2A50 to 0x184D2A5F
+inline bool skippable_magic(uint32_t magic) { return (magic & 0xFFFFFFF0) == 0x184D2A50; }
+
+// https://www.rfc-editor.org/rfc/rfc1952#page-7
+const wchar_t *gzip_os_name(uint8_t os) {
+  constexpr const wchar_t *names[] = {L"FAT",      L"Amiga",     L"VMS",     L"Unix",
+                                      L"VM/CMS",   L"Atari TOS", L"HPFS",    L"Macintosh",
+                                      L"Z-System", L"CP/M",      L"TOPS-20", L"NTFS",
+                                      L"QDOS",     L"Acorn RISCOS"};
+  if (os < ArrayLength(names)) {
+    return names[os];
+  }
+  return os == 255 ? L"unknown" : L"";
+}
+
+// BGZF (SAMtools) member carries 'BC' extra subfield, BSIZE is member size minus 1
+// https://samtools.github.io/hts-specs/SAMv1.pdf
+bool bgzf_block_size(base::MemView hv, uint64_t &bsize) {
+  constexpr uint8_t gzipExtra = 0x04;
+  if (hv.size() < 12 || hv[0] != 0x1F || hv[1] != 0x8B || (hv[3] & gzipExtra) == 0) {
+    return false;
+  }
+  size_t end = 12 + bela::readle<uint16_t>(hv.data() + 10);
+  if (end > hv.size()) {
+    return false;
+  }
+  for (size_t pos = 12; pos + 4 <= end;) {
+    size_t slen = bela::readle<uint16_t>(hv.data() + pos + 2);
+    if (hv[pos] == 'B' && hv[pos + 1] == 'C' && slen == 2 && pos + 6 <= end) {
+      bsize = uint64_t(bela::readle<uint16_t>(hv.data() + pos + 4)) + 1;
+      return true;
+    }
+    pos += 4 + slen;
+  }
+  return false;
+}
+
+// sum ISIZE of every BGZF block, each one is at most 64K so ISIZE is exact
+bool bgzf_blocks(base::WindowView &wv, compressed_stream_t &cs) {
+  bela::error_code ec;
+  uint64_t total = 0;
+  uint32_t blocks = 0;
+  for (uint64_t pos = 0; pos < wv.size();) {
+    uint8_t hd[bgzf_header_size];
+    uint8_t trailer[4];
+    uint64_t bsize = 0;
+    if (wv.ReadAt(pos, hd, sizeof(hd), ec) != sizeof(hd) ||
+        !bgzf_block_size(base::MemView(hd, sizeof(hd)), bsize) || bsize < sizeof(hd) + 8 ||
+        bsize > wv.size() - pos || wv.ReadAt(pos + bsize - 4, trailer, 4, ec) != 4) {
+      return false;
+    }
+    total += bela::readle<uint32_t>(trailer);
+    blocks++;
+    pos += bsize;
+  }
+  cs.frames = blocks;
+  cs.uncompressed = total;
+  return true;
+}
+
+bool compressed_gzip(base::WindowView &wv, compressed_stream_t &cs) {
+  bela::error_code ec;
+  auto hv = wv.Window(0, compressed_header_max, ec);
+  auto offset = gzip_data_offset(hv);
+  // CRC-32 and ISIZE trailer
+  if (offset == 0 || wv.size() < offset + 8) {
+    return false;
+  }
+  cs.t = types::gz;
+  cs.frames = 1;
+  cs.name = bela::ToWide(gzip_member_name(hv));
+  cs.mtime = bela::readle<uint32_t>(hv.data() + 4);
+  cs.os = gzip_os_name(hv[9]);
+  uint64_t bsize = 0;
+  if (bgzf_block_size(hv, bsize)) {
+    if (bgzf_blocks(wv, cs)) {
+      return true;
+    }
+    cs.frames = 1;
+  }
+  // ISIZE is size modulo 2^32 of last member only, concatenated members cannot be told apart
+  // without inflating, so it is reported as what it is
+  uint8_t trailer[4];
+  if (wv.ReadAt(wv.size() - 4, trailer, sizeof(trailer), ec) == sizeof(trailer)) {
+    cs.isize = bela::readle<uint32_t>(trailer);
+  }
+  return true;
+}
+
+// xz variable-length integer, 7 bits per byte, at most 9 bytes
+bool xz_vli(base::MemView mv, size_t &pos, uint64_t &v) {
+  v = 0;
+  for (int i = 0; i < 9; i++) {
+    if (pos >= mv.size()) {
+      return false;
+    }
+    auto b = mv[pos++];
+    v |= static_cast<uint64_t>(b & 0x7F) << (i * 7);
+    if ((b & 0x80) == 0) {
+      return b != 0 || i == 0;
+    }
+  }
+  return false;
+}
+
+const wchar_t *xz_check_name(uint8_t check) {
+  switch (check) {
+  case 0x00:
+    return L"None";
+  case 0x01:
+    return L"CRC32";
+  case 0x04:
+    return L"CRC64";
+  case 0x0A:
+    return L"SHA-256";
+  default:
+    break;
+  }
+  return L"reserved";
+}
+
+// https://tukaani.org/xz/xz-file-format.txt
+// Streams are walked backward from footer through index, blocks are never read.
+bool compressed_xz(base::WindowView &wv, compressed_stream_t &cs) {
+  constexpr const uint8_t xzMagic[] = {0xFD, '7', 'z', 'X', 'Z', 0x00};
+  bela::error_code ec;
+  uint8_t header[xz_header_size];
+  if (wv.ReadAt(0, header, sizeof(header), ec) != sizeof(header) ||
+      memcmp(header, xzMagic, sizeof(xzMagic)) != 0) {
+    return false;
+  }
+  cs.t = types::xz;
+  cs.check = xz_check_name(header[7] & 0x0F);
+  uint64_t total = 0;
+  auto end = wv.size();
+  while (end != 0) {
+    // stream padding is zero bytes in multiples of four
+    uint8_t padding[4];
+    while (end >= 4 && wv.ReadAt(end - 4, padding, 4, ec) == 4 &&
+           bela::readle<uint32_t>(padding) == 0) {
+      end -= 4;
+    }
+    uint8_t footer[xz_header_size];
+    if (end < xz_header_size * 2 ||
+        wv.ReadAt(end - xz_header_size, footer, sizeof(footer), ec) != sizeof(footer) ||
+        footer[10] != 'Y' || footer[11] != 'Z' ||
+        byte_crc32(footer + 4, 6) != bela::readle<uint32_t>(footer)) {
+      cs.damaged = true;
+      return true;
+    }
+    auto indexsize = (static_cast<uint64_t>(bela::readle<uint32_t>(footer + 4)) + 1) * 4;
+    if (indexsize > xz_index_max || indexsize > end - xz_header_size * 2) {
+      cs.damaged = true;
+      return true;
+    }
+    auto indexoffset = end - xz_header_size - indexsize;
+    auto iv = wv.Window(indexoffset, static_cast<size_t>(indexsize), ec);
+    if (iv.size() != indexsize || iv[0] != 0 ||
+        byte_crc32(iv.data(), iv.size() - 4) !=
+            bela::readle<uint32_t>(iv.data() + iv.size() - 4)) {
+      cs.damaged = true;
+      return true;
+    }
+    // records end before CRC32
+    auto rv = base::MemView(iv.data(), iv.size() - 4);
+    size_t pos = 1;
+    uint64_t records = 0;
+    uint64_t blocks = 0;
+    uint64_t uncompressed = 0;
+    if (!xz_vli(rv, pos, records)) {
+      cs.damaged = true;
+      return true;
+    }
+    for (uint64_t i = 0; i < records; i++) {
+      uint64_t unpadded = 0;
+      uint64_t size = 0;
+      if (!xz_vli(rv, pos, unpadded) || !xz_vli(rv, pos, size)) {
+        cs.damaged = true;
+        return true;
+      }
+      // blocks are padded to four bytes
+      blocks += (unpadded + 3) & ~uint64_t(3);
+      uncompressed += size;
+    }
+    if (blocks > indexoffset - xz_header_size) {
+      cs.damaged = true;
+      return true;
+    }
+    auto start = indexoffset - blocks - xz_header_size;
+    // stream flags of header and footer must agree
+    if (wv.ReadAt(start, header, sizeof(header), ec) != sizeof(header) ||
+        memcmp(header, xzMagic, sizeof(xzMagic)) != 0 || header[6] != footer[8] ||
+        header[7] != footer[9]) {
+      cs.damaged = true;
+      return true;
+    }
+    cs.frames++;
+    cs.blocks += records;
+    total += uncompressed;
+    end = start;
+  }
+  cs.uncompressed = total;
+  return true;
+}
+
+// https://github.com/dsnet/compress/blob/master/doc/bzip2-format.pdf
+bool compressed_bzip2(base::WindowView &wv, compressed_stream_t &cs) {
+  bela::error_code ec;
+  uint8_t header[10];
+  if (wv.ReadAt(0, header, sizeof(header), ec) != sizeof(header) || header[0] != 'B' ||
+      header[1] != 'Z' || header[2] != 'h' || header[3] < '1' || header[3] > '9') {
+    return false;
+  }
+  // first block magic (BCD pi) or end of stream magic (BCD sqrt(pi)) of empty stream
+  constexpr const uint8_t blockMagic[] = {0x31, 0x41, 0x59, 0x26, 0x53, 0x59};
+  constexpr const uint8_t endMagic[] = {0x17, 0x72, 0x45, 0x38, 0x50, 0x90};
+  if (memcmp(header + 4, blockMagic, 6) != 0 && memcmp(header + 4, endMagic, 6) != 0) {
+    return false;
+  }
+  cs.t = types::bz2;
+  cs.frames = 1;
+  cs.blocksize = static_cast<uint64_t>(header[3] - '0') * 100000;
+  return true;
+}
+
+// https://github.com/facebook/zstd/blob/dev/doc/zstd_compression_format.md#frames
+bool zstd_frame(base::WindowView &wv, uint64_t &pos, compressed_stream_t &cs,
+                std::optional<uint64_t> &content) {
+  bela::error_code ec;
+  // magic, descriptor, window, dictionary ID and content size
+  uint8_t hd[4 + 1 + 1 + 4 + 8] = {0};
+  auto n = wv.ReadAt(pos, hd, sizeof(hd), ec);
+  if (n < 6) {
+    return false;
+  }
+  auto fhd = hd[4];
+  if ((fhd & 0x08) != 0) {
+    return false;
+  }
+  bool single = (fhd & 0x20) != 0;
+  size_t off = 5;
+  uint64_t window = 0;
+  if (!single) {
+    auto wd = hd[off++];
+    auto base = uint64_t(1) << (10 + (wd >> 3));
+    window = base + (base / 8) * (wd & 7);
+  }
+  constexpr size_t dictsizes[] = {0, 1, 2, 4};
+  uint32_t dictionary = 0;
+  auto dictsize = dictsizes[fhd & 3];
+  for (size_t i = 0; i < dictsize; i++) {
+    dictionary |= static_cast<uint32_t>(hd[off + i]) << (i * 8);
+  }
+  off += dictsize;
+  auto fcsflag = fhd >> 6;
+  size_t fcssize = fcsflag == 0 ? (single ? 1 : 0) : (size_t(1) << fcsflag);
+  if (off + fcssize > n) {
+    return false;
+  }
+  if (fcssize != 0) {
+    uint64_t v = 0;
+    for (size_t i = 0; i < fcssize; i++) {
+      v |= static_cast<uint64_t>(hd[off + i]) << (i * 8);
+    }
+    // two byte field is offset by 256
+    content = fcssize == 2 ? v + 256 : v;
+  }
+  off += fcssize;
+  if (single) {
+    window = content.value_or(0);
+  }
+  cs.windowsize = (std::max)(cs.windowsize, window);
+  if (cs.dictionary == 0) {
+    cs.dictionary = dictionary;
+  }
+  if ((fhd & 0x04) != 0) {
+    cs.check = L"XXH64";
+  }
+  // block headers are hopped by size, RLE block stores one byte
+  pos += off;
+  for (;;) {
+    uint8_t bh[3];
+    if (wv.ReadAt(pos, bh, 3, ec) != 3) {
+      return false;
+    }
+    auto v = bh[0] | (static_cast<uint32_t>(bh[1]) << 8) | (static_cast<uint32_t>(bh[2]) << 16);
+    auto type = (v >> 1) & 3;
+    auto size = v >> 3;
+    if (type == 3 || size > zstd_block_max) {
+      return false;
+    }
+    pos += 3 + (type == 1 ? 1 : size);
+    if (pos > wv.size()) {
+      return false;
+    }
+    if ((v & 1) != 0) {
+      break;
+    }
+  }
+  pos += (fhd & 0x04) != 0 ? 4 : 0;
+  return pos <= wv.size();
+}
+
+// https://github.com/lz4/lz4/blob/dev/doc/lz4_Frame_format.md
+bool lz4_frame(base::WindowView &wv, uint64_t &pos, compressed_stream_t &cs,
+               std::optional<uint64_t> &content) {
+  bela::error_code ec;
+  // magic, FLG, BD, content size, dictionary ID and header checksum
+  uint8_t hd[4 + 2 + 8 + 4 + 1] = {0};
+  auto n = wv.ReadAt(pos, hd, sizeof(hd), ec);
+  if (n < 7) {
+    return false;
+  }
+  auto flg = hd[4];
+  auto bd = hd[5];
+  auto code = (bd >> 4) & 7;
+  if ((flg >> 6) != 1 || code < 4) {
+    return false;
+  }
+  uint64_t blockmax = uint64_t(64 * 1024) << (2 * (code - 4));
+  cs.blocksize = (std::max)(cs.blocksize, blockmax);
+  size_t off = 6;
+  if ((flg & 0x08) != 0) {
+    if (off + 8 > n) {
+      return false;
+    }
+    content = bela::readle<uint64_t>(hd + off);
+    off += 8;
+  }
+  if ((flg & 0x01) != 0) {
+    if (off + 4 > n) {
+      return false;
+    }
+    if (cs.dictionary == 0) {
+      cs.dictionary = bela::readle<uint32_t>(hd + off);
+    }
+    off += 4;
+  }
+  if (off + 1 > n) {
+    return false;
+  }
+  if ((flg & 0x04) != 0) {
+    cs.check = L"XXH32";
+  }
+  pos += off + 1;
+  // block size high bit marks uncompressed block, zero size is end mark
+  uint64_t blockcheck = (flg & 0x10) != 0 ? 4 : 0;
+  for (;;) {
+    uint8_t bs[4];
+    if (wv.ReadAt(pos, bs, 4, ec) != 4) {
+      return false;
+    }
+    auto size = bela::readle<uint32_t>(bs) & 0x7FFFFFFF;
+    pos += 4;
+    if (size == 0) {
+      break;
+    }
+    if (size > blockmax) {
+      return false;
+    }
+    pos += size + blockcheck;
+    if (pos > wv.size()) {
+      return false;
+    }
+  }
+  pos += (flg & 0x04) != 0 ? 4 : 0;
+  return pos <= wv.size();
+}
+
+// legacy frame has no end mark, it ends at end of file or at next magic
+bool lz4_legacy_frame(base::WindowView &wv, uint64_t &pos, compressed_stream_t &cs) {
+  bela::error_code ec;
+  cs.blocksize = (std::max)(cs.blocksize, uint64_t(lz4_legacy_block_max));
+  pos += 4;
+  while (pos < wv.size()) {
+    uint8_t bs[4];
+    if (wv.ReadAt(pos, bs, 4, ec) != 4) {
+      return false;
+    }
+    auto size = bela::readle<uint32_t>(bs);
+    if (size == lz4_legacy_magic || size == lz4_magic || skippable_magic(size)) {
+      break;
+    }
+    // compress bound of 8 MiB block
+    if (size > lz4_legacy_block_max + lz4_legacy_block_max / 255 + 16) {
+      return false;
+    }
+    pos += 4 + size;
+  }
+  return pos <= wv.size();
+}
+
+// zstd and lz4 files are concatenated frames, whole size is known only when every frame
+// records its content size
+bool compressed_frames(base::WindowView &wv, compressed_stream_t &cs) {
+  bela::error_code ec;
+  uint64_t pos = 0;
+  uint64_t total = 0;
+  bool known = true;
+  while (pos < wv.size()) {
+    uint8_t hd[8];
+    auto n = wv.ReadAt(pos, hd, sizeof(hd), ec);
+    if (n < 4) {
+      cs.damaged = true;
+      break;
+    }
+    auto magic = bela::readle<uint32_t>(hd);
+    if (skippable_magic(magic)) {
+      if (n < 8 || bela::readle<uint32_t>(hd + 4) > wv.size() - pos - 8) {
+        cs.damaged = true;
+        break;
+      }
+      pos += 8 + bela::readle<uint32_t>(hd + 4);
+      cs.skippable++;
+      continue;
+    }
+    std::optional<uint64_t> content;
+    bool ok = false;
+    auto t = types::none;
+    if (magic == zstd_magic) {
+      t = types::zstd;
+      ok = zstd_frame(wv, pos, cs, content);
+    } else if (magic == lz4_magic) {
+      t = types::lz4;
+      ok = lz4_frame(wv, pos, cs, content);
+    } else if (magic == lz4_legacy_magic) {
+      t = types::lz4;
+      ok = lz4_legacy_frame(wv, pos, cs);
+    }
+    if (t == types::none) {
+      // leading skippable frames without data frame are not ours
+      if (cs.frames == 0) {
+        return false;
+      }
+      cs.damaged = true;
+      break;
+    }
+    if (cs.t == types::none) {
+      cs.t = t;
+    }
+    cs.frames++;
+    if (!ok) {
+      cs.damaged = true;
+      break;
+    }
+    if (content) {
+      total += *content;
+    } else {
+      known = false;
+    }
+  }
+  if (cs.frames == 0) {
+    return false;
+  }
+  if (known && !cs.damaged) {
+    cs.uncompressed = total;
+  }
+  return true;
+}
+
+std::optional<compressed_stream_t> inquisitive_compressed(std::wstring_view sv,
+                                                          bela::error_code &ec) {
+  base::WindowView wv;
+  if (!wv.Open(sv, ec, 4)) {
+    return std::nullopt;
+  }
+  compressed_stream_t cs;
+  if (compressed_gzip(wv, cs) || compressed_xz(wv, cs) || compressed_bzip2(wv, cs) ||
+      compressed_frames(wv, cs)) {
+    return std::make_optional(std::move(cs));
+  }
+  ec = bela::make_error_code(L"not a gzip, xz, bzip2, zstd or lz4 file");
+  return std::nullopt;
+}
+
+status_t inquisitive_compressed_container(std::wstring_view sv, inquisitive_result_t &ir) {
+  bela::error_code ec;
+  auto cs = inquisitive_compressed(sv, ec);
+  if (!cs) {
+    return None;
+  }
+  if (!cs->name.empty()) {
+    ir.add(L"Name", cs->name);
+  }
+  if (cs->mtime != 0) {
+    ir.add(L"Modified", bela::StringCat(cs->mtime, L" (Unix time)"));
+  }
+  if (!cs->os.empty()) {
+    ir.add(L"OS", cs->os);
+  }
+  if (!cs->check.empty()) {
+    ir.add(L"Check", cs->check);
+  }
+  if (cs->blocksize != 0) {
+    ir.add(L"Block Size", cs->blocksize);
+  }
+  if (cs->windowsize != 0) {
+    ir.add(L"Window Size", cs->windowsize);
+  }
+  if (cs->dictionary != 0) {
+    ir.add(L"Dictionary ID", cs->dictionary);
+  }
+  if (cs->t == types::xz && cs->frames != 0) {
+    ir.add(L"Streams", cs->frames);
+    ir.add(L"Blocks", cs->blocks);
+  } else if (cs->t == types::zstd || cs->t == types::lz4) {
+    ir.add(L"Frames", cs->frames);
+  } else if (cs->t == types::gz && cs->frames > 1) {
+    ir.add(L"BGZF Blocks", cs->frames);
+  }
+  if (cs->skippable != 0) {
+    ir.add(L"Skippable Frames", cs->skippable);
+  }
+  if (cs->uncompressed) {
+    ir.add(L"Uncompressed Size", *cs->uncompressed);
+  } else if (cs->isize) {
+    ir.add(L"Last Member Size (mod 2^32)", *cs->isize);
+  }
+  if (cs->damaged) {
+    ir.add(L"Damaged", std::wstring_view(L"trailer, index or frame chain is inconsistent"));
+  }
+  return Found;
+}
+
+} // namespace inquisitive
@@ -0,0 +1,188 @@
+/// CRC-32 shared by ZIP and gzip
+#include <bela/endian.hpp>
+#include "inquisitive.hpp"
+
+// Carry-less multiplication folds 64 bytes per iteration, ARMv8 has CRC-32 instructions, others
+// use slicing-by-8 tables.
+// https://www.intel.com/content/dam/www/public/us/en/documents/white-papers/fast-crc-computation-generic-polynomials-pclmulqdq-paper.pdf
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+#define INQUISITIVE_CRC32_X86 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#include <immintrin.h>
+#elif defined(_M_ARM64) || defined(__aarch64__)
+#define INQUISITIVE_CRC32_ARM64 1
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#else
+#include <arm_acle.h>
+#endif
+#endif
+
+#if defined(INQUISITIVE_CRC32_X86) && (defined(__GNUC__) || defined(__clang__))
+#define CRC32_TARGET_PCLMUL __attribute__((target("sse2,pclmul")))
+#else
+#define CRC32_TARGET_PCLMUL
+#endif
+
+#if defined(INQUISITIVE_CRC32_ARM64) && (defined(__GNUC__) || defined(__clang__))
+#define CRC32_TARGET_ARM __attribute__((target("+crc")))
+#else
+#define CRC32_TARGET_ARM
+#endif
+
+namespace inquisitive {
+using crc32_fn_t = uint32_t (*)(const uint8_t *, size_t, uint32_t);
+
+// table k maps a byte to its CRC after k more zero bytes
+struct crc32_tables_t {
+  uint32_t v[8][256];
+  constexpr crc32_tables_t() : v() {
+    for (uint32_t i = 0; i < 256; i++) {
+      auto c = i;
+      for (int k = 0; k < 8; k++) {
+        c = (c & 1) != 0 ? (0xEDB88320 ^ (c >> 1)) : (c >> 1);
+      }
+      v[0][i] = c;
+    }
+    for (uint32_t i = 0; i < 256; i++) {
+      for (int t = 1; t < 8; t++) {
+        v[t][i] = (v[t - 1][i] >> 8) ^ v[0][v[t - 1][i] & 0xFF];
+      }
+    }
+  }
+};
+constexpr crc32_tables_t crc32_tables;
+
+// crc is pre-inverted in every kernel
+uint32_t crc32_slicing8(const uint8_t *p, size_t len, uint32_t crc) {
+  const auto &t = crc32_tables.v;
+  for (; len >= 8; p += 8, len -= 8) {
+    auto lo = bela::readle<uint32_t>(p) ^ crc;
+    auto hi = bela::readle<uint32_t>(p + 4);
+    crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^
+          t[3][hi & 0xFF] ^ t[2][(hi >> 8) & 0xFF] ^ t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
+  }
+  for (; len > 0; p++, len--) {
+    crc = t[0][(crc ^ *p) & 0xFF] ^ (crc >> 8);
+  }
+  return crc;
+}
+
+#if defined(INQUISITIVE_CRC32_X86)
+// fold constants x^(k) mod P(x), bit-reflected, from the paper above
+alignas(16) constexpr uint64_t crc32_k1k2[] = {0x0154442bd4, 0x01c6e41596};
+alignas(16) constexpr uint64_t crc32_k3k4[] = {0x01751997d0, 0x00ccaa009e};
+alignas(16) constexpr uint64_t crc32_k5k0[] = {0x0163cd6124, 0x0000000000};
+alignas(16) constexpr uint64_t crc32_poly[] = {0x01db710641, 0x01f7011641};
+
+// x * x^(k) mod P(x) folded onto next 128 bits
+CRC32_TARGET_PCLMUL inline __m128i crc32_fold(__m128i x, __m128i k, __m128i next) {
+  auto lo = _mm_clmulepi64_si128(x, k, 0x00);
+  auto hi = _mm_clmulepi64_si128(x, k, 0x11);
+  return _mm_xor_si128(_mm_xor_si128(hi, lo), next);
+}
+
+CRC32_TARGET_PCLMUL uint32_t crc32_pclmul(const uint8_t *p, size_t len, uint32_t crc) {
+  if (len < 64) {
+    return crc32_slicing8(p, len, crc);
+  }
+  // 64 bytes are folded into four 128-bit lanes, tail under 16 bytes goes to tables
+  auto tail = len & 15;
+  len -= tail;
+  auto x1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+  auto x2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 16));
+  auto x3 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 32));
+  auto x4 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 48));
+  x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(static_cast<int>(crc)));
+  auto k = _mm_load_si128(reinterpret_cast<const __m128i *>(crc32_k1k2));
+  p += 64;
+  len -= 64;
+  for (; len >= 64; p += 64, len -= 64) {
+    x1 = crc32_fold(x1, k, _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)));
+    x2 = crc32_fold(x2, k, _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 16)));
+    x3 = crc32_fold(x3, k, _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 32)));
+    x4 = crc32_fold(x4, k, _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 48)));
+  }
+  // four lanes into one
+  k = _mm_load_si128(reinterpret_cast<const __m128i *>(crc32_k3k4));
+  x1 = crc32_fold(x1, k, x2);
+  x1 = crc32_fold(x1, k, x3);
+  x1 = crc32_fold(x1, k, x4);
+  for (; len >= 16; p += 16, len -= 16) {
+    x1 = crc32_fold(x1, k, _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)));
+  }
+  // 128 bits to 64 bits
+  auto mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+  x2 = _mm_clmulepi64_si128(x1, k, 0x10);
+  x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+  k = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(crc32_k5k0));
+  x2 = _mm_srli_si128(x1, 4);
+  x1 = _mm_xor_si128(_mm_clmulepi64_si128(_mm_and_si128(x1, mask32), k, 0x00), x2);
+  // Barrett reduction to 32 bits
+  k = _mm_load_si128(reinterpret_cast<const __m128i *>(crc32_poly));
+  x2 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask32), k, 0x10);
+  x2 = _mm_clmulepi64_si128(_mm_and_si128(x2, mask32), k, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+  crc = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(x1, 4)));
+  return crc32_slicing8(p, tail, crc);
+}
+
+bool cpu_has_pclmul() {
+#if defined(_MSC_VER) && !defined(__clang__)
+  int regs[4] = {0};
+  __cpuid(regs, 1);
+  // PCLMULQDQ and SSE2
+  return (regs[2] & (1 << 1)) != 0 && (regs[3] & (1 << 26)) != 0;
+#else
+  return __builtin_cpu_supports("pclmul") != 0 && __builtin_cpu_supports("sse2") != 0;
+#endif
+}
+#endif
+
+#if defined(INQUISITIVE_CRC32_ARM64)
+CRC32_TARGET_ARM uint32_t crc32_arm64(const uint8_t *p, size_t len, uint32_t crc) {
+  for (; len >= 8; p += 8, len -= 8) {
+    crc = __crc32d(crc, bela::readle<uint64_t>(p));
+  }
+  for (; len > 0; p++, len--) {
+    crc = __crc32b(crc, *p);
+  }
+  return crc;
+}
+
+bool cpu_has_crc32() {
+#if defined(_WIN32)
+  return IsProcessorFeaturePresent(PF_ARM_V8_CRC32_INSTRUCTIONS_AVAILABLE) != FALSE;
+#elif defined(__ARM_FEATURE_CRC32)
+  return true;
+#else
+  return false;
+#endif
+}
+#endif
+
+// resolved once like byte search
+crc32_fn_t crc32_dispatch() {
+  static const crc32_fn_t fn = []() -> crc32_fn_t {
+#if defined(INQUISITIVE_CRC32_X86)
+    if (cpu_has_pclmul()) {
+      return crc32_pclmul;
+    }
+#elif defined(INQUISITIVE_CRC32_ARM64)
+    if (cpu_has_crc32()) {
+      return crc32_arm64;
+    }
+#endif
+    return crc32_slicing8;
+  }();
+  return fn;
+}
+
+uint32_t byte_crc32(const void *data, size_t len, uint32_t crc) {
+  return ~crc32_dispatch()(reinterpret_cast<const uint8_t *>(data), len, ~crc);
+}
+
+} // namespace inquisitive
@@ -289,16 +289,100 @@ inline endian::endian_t Endian(uint8_t t) {
   return endian::None;
 }
 
+#ifndef ELFCOMPRESS_ZSTD
+#define ELFCOMPRESS_ZSTD 2
+#endif
+
+#ifndef SHT_RELR
+#define SHT_RELR 19
+#endif
+
+// Elf32/Elf64 layout, the field names are the same, so we can use template
+struct elf32_layout_t {
+  using Ehdr = Elf32_Ehdr;
+  using Phdr = Elf32_Phdr;
+  using Shdr = Elf32_Shdr;
+  using Chdr = Elf32_Chdr;
+  using Dyn = Elf32_Dyn;
+  using Verneed = Elf32_Verneed;
+  using Vernaux = Elf32_Vernaux;
+  using Verdef = Elf32_Verdef;
+  using Verdaux = Elf32_Verdaux;
+};
+
+struct elf64_layout_t {
+  using Ehdr = Elf64_Ehdr;
+  using Phdr = Elf64_Phdr;
+  using Shdr = Elf64_Shdr;
+  using Chdr = Elf64_Chdr;
+  using Dyn = Elf64_Dyn;
+  using Verneed = Elf64_Verneed;
+  using Vernaux = Elf64_Vernaux;
+  using Verdef = Elf64_Verdef;
+  using Verdaux = Elf64_Verdaux;
+};
+
+// DT_VERNEED/DT_VERDEF/DT_VERSYM from dynamic section, value is virtual address
+struct elf_version_tags_t {
+  uint64_t verneed{0};
+  uint64_t verneednum{0};
+  uint64_t verdef{0};
+  uint64_t verdefnum{0};
+  uint64_t versym{0};
+};
+
+// GLIBC_2.17 GLIBCXX_3.4.21 compare numeric components
+inline bool elf_version_less(std::string_view a, std::string_view b) {
+  auto next = [](std::string_view &sv) -> uint32_t {
+    uint32_t n = 0;
+    size_t i = 0;
+    for (; i < sv.size() && sv[i] >= '0' && sv[i] <= '9'; i++) {
+      n = n * 10 + (sv[i] - '0');
+    }
+    sv.remove_prefix((std::min)(i + 1, sv.size()));
+    return n;
+  };
+  while (!a.empty() || !b.empty()) {
+    auto x = next(a);
+    auto y = next(b);
+    if (x != y) {
+      return x < y;
+    }
+  }
+  return false;
+}
+
+// Record maximum version of prefix, GLIBC_PRIVATE will be ignored
+inline void elf_version_max(std::string_view name, std::string_view prefix,
+                            std::string_view &vmax) {
+  if (name.size() <= prefix.size() || name.compare(0, prefix.size(), prefix) != 0) {
+    return;
+  }
+  auto ch = name[prefix.size()];
+  if (ch < '0' || ch > '9') {
+    return;
+  }
+  if (vmax.empty() || elf_version_less(vmax.substr(prefix.size()), name.substr(prefix.size()))) {
+    vmax = name;
+  }
+}
+
+inline bool elf_debug_section(std::string_view name) {
+  constexpr std::string_view debug(".debug");
+  constexpr std::string_view zdebug(".zdebug");
+  return name.compare(0, debug.size(), debug) == 0 || name.compare(0, zdebug.size(), zdebug) == 0;
+}
+
 class elf_memview {
 public:
-  elf_memview(base::MemView mv)
-      : data_(reinterpret_cast<const char *>(mv.data())), size_(mv.size()) {
+  elf_memview(base::MemView mv, uint32_t options = ElfDefault)
+      : data_(reinterpret_cast<const char *>(mv.data())), size_(mv.size()), options_(options) {
     //
   }
   const char *data() const { return data_; }
   size_t size() const { return size_; }
   template <typename T> const T *cast(size_t off) const {
-    if (off + sizeof(T) >= size_) {
+    if (off > size_ || sizeof(T) > size_ - off) {
       return nullptr;
     }
     return reinterpret_cast<const T *>(data_ + off);
@@ -309,46 +393,255 @@ public:
     }
     return bela::bswap(i);
   }
-  std::string stroffset(size_t off, size_t end);
+  std::string_view strview(size_t off, size_t end) const;
   bool inquisitive(elf_minutiae_t &em, bela::error_code &ec);
-  bool inquisitive64(elf_minutiae_t &em, bela::error_code &ec);
 
 private:
   const char *data_{nullptr};
   size_t size_{0};
+  uint32_t options_{ElfDefault};
   bool resiveable{false};
+  template <typename L> bool inquisitive_layout(elf_minutiae_t &em, bela::error_code &ec);
+  template <typename L>
+  const typename L::Shdr *vaddr_section(const typename L::Shdr *sects, size_t shnum, uint64_t va);
+  template <typename L>
+  void version_resolve(const typename L::Shdr *sects, size_t shnum, const elf_version_tags_t &vt,
+                       size_t soff, size_t send, elf_minutiae_t &em);
+  template <typename L>
+  void sections_resolve(const typename L::Ehdr *h, const typename L::Shdr *sects, size_t shnum,
+                        elf_sections_t &es);
 };
-std::string elf_memview::stroffset(size_t off, size_t end) {
-  std::string s;
-  for (size_t i = off; i < end; i++) {
-    if (data_[i] == 0) {
-      break;
+
+// zero copy, string view point to mapped .dynstr
+std::string_view elf_memview::strview(size_t off, size_t end) const {
+  end = (std::min)(end, size_);
+  if (off >= end) {
+    return std::string_view();
+  }
+  auto p = data_ + off;
+  return std::string_view(p, byte_strnlen(p, end - off));
+}
+
+// Find section which contains virtual address
+template <typename L>
+const typename L::Shdr *elf_memview::vaddr_section(const typename L::Shdr *sects, size_t shnum,
+                                                   uint64_t va) {
+  for (size_t i = 0; i < shnum; i++) {
+    uint64_t addr = resive(sects[i].sh_addr);
+    uint64_t sz = resive(sects[i].sh_size);
+    if (resive(sects[i].sh_type) == SHT_NOBITS || addr == 0) {
+      continue;
+    }
+    if (addr <= va && va < addr + sz) {
+      return &sects[i];
+    }
+  }
+  return nullptr;
+}
+
+// Symbol versioning
+// https://refspecs.linuxfoundation.org/LSB_5.0.0/LSB-Core-generic/LSB-Core-generic/symversion.html
+template <typename L>
+void elf_memview::version_resolve(const typename L::Shdr *sects, size_t shnum,
+                                  const elf_version_tags_t &vt, size_t soff, size_t send,
+                                  elf_minutiae_t &em) {
+  // DT_VERSYM: count how many dynamic symbols reference each version index
+  std::vector<uint32_t> symbols;
+  if (auto sh = vaddr_section<L>(sects, shnum, vt.versym); sh != nullptr) {
+    uint64_t off = resive(sh->sh_offset) + (vt.versym - resive(sh->sh_addr));
+    uint64_t end = (std::min)(static_cast<uint64_t>(resive(sh->sh_offset)), uint64_t(size_));
+    end += (std::min)(static_cast<uint64_t>(resive(sh->sh_size)), uint64_t(size_) - end);
+    for (; off <= end && end - off >= sizeof(uint16_t); off += sizeof(uint16_t)) {
+      size_t index = resive(bela::unalignedloadT<uint16_t>(data_ + off)) & 0x7fff;
+      if (index >= symbols.size()) {
+        symbols.resize(index + 1, 0);
+      }
+      symbols[index]++;
+    }
+  }
+  std::string_view glibc;
+  std::string_view glibcxx;
+  // DT_VERNEED
+  if (auto sh = vaddr_section<L>(sects, shnum, vt.verneed); sh != nullptr) {
+    size_t vnoff = resive(sh->sh_offset) + (vt.verneed - resive(sh->sh_addr));
+    for (uint64_t i = 0; i < vt.verneednum; i++) {
+      auto vn = cast<typename L::Verneed>(vnoff);
+      if (vn == nullptr) {
+        break;
+      }
+      elf_version_need_t need;
+      need.file = bela::ToWide(strview(soff + resive(vn->vn_file), send));
+      size_t aoff = vnoff + resive(vn->vn_aux);
+      auto cnt = resive(vn->vn_cnt);
+      for (decltype(cnt) j = 0; j < cnt; j++) {
+        auto va = cast<typename L::Vernaux>(aoff);
+        if (va == nullptr) {
+          break;
+        }
+        auto name = strview(soff + resive(va->vna_name), send);
+        elf_version_t ev;
+        ev.name = bela::ToWide(name);
+        ev.weak = (resive(va->vna_flags) & VER_FLG_WEAK) != 0;
+        if (auto index = resive(va->vna_other); index < symbols.size()) {
+          ev.symbols = symbols[index];
+        }
+        need.versions.emplace_back(std::move(ev));
+        elf_version_max(name, "GLIBC_", glibc);
+        elf_version_max(name, "GLIBCXX_", glibcxx);
+        auto next = resive(va->vna_next);
+        if (next == 0) {
+          break;
+        }
+        aoff += next;
+      }
+      em.verneeds.emplace_back(std::move(need));
+      auto next = resive(vn->vn_next);
+      if (next == 0) {
+        break;
+      }
+      vnoff += next;
+    }
+  }
+  em.glibc = bela::ToWide(glibc);
+  em.glibcxx = bela::ToWide(glibcxx);
+  // DT_VERDEF
+  if (auto sh = vaddr_section<L>(sects, shnum, vt.verdef); sh != nullptr) {
+    size_t vdoff = resive(sh->sh_offset) + (vt.verdef - resive(sh->sh_addr));
+    for (uint64_t i = 0; i < vt.verdefnum; i++) {
+      auto vd = cast<typename L::Verdef>(vdoff);
+      if (vd == nullptr) {
+        break;
+      }
+      // VER_FLG_BASE is file version (SONAME) ignore
+      if ((resive(vd->vd_flags) & VER_FLG_BASE) == 0 && resive(vd->vd_cnt) != 0) {
+        if (auto vda = cast<typename L::Verdaux>(vdoff + resive(vd->vd_aux)); vda != nullptr) {
+          em.verdefs.emplace_back(bela::ToWide(strview(soff + resive(vda->vda_name), send)));
+        }
+      }
+      auto next = resive(vd->vd_next);
+      if (next == 0) {
+        break;
+      }
+      vdoff += next;
+    }
+  }
+}
+
+// Section size breakdown, section bodies are not read, except Elf_Chdr of compressed sections
+template <typename L>
+void elf_memview::sections_resolve(const typename L::Ehdr *h, const typename L::Shdr *sects,
+                                   size_t shnum, elf_sections_t &es) {
+  uint64_t phoff = resive(h->e_phoff);
+  uint64_t phnum = resive(h->e_phnum);
+  if (phoff != 0 && phoff <= size_ && phnum <= (size_ - phoff) / sizeof(typename L::Phdr)) {
+    auto phdrs = reinterpret_cast<const typename L::Phdr *>(data_ + phoff);
+    for (uint64_t i = 0; i < phnum; i++) {
+      if (resive(phdrs[i].p_type) == PT_LOAD) {
+        es.loadfile += resive(phdrs[i].p_filesz);
+        es.loadmemory += resive(phdrs[i].p_memsz);
+      }
+    }
+  }
+  size_t noff = 0;
+  size_t nend = 0;
+  if (auto shstrndx = resive(h->e_shstrndx); shstrndx < shnum) {
+    noff = resive(sects[shstrndx].sh_offset);
+    nend = noff + resive(sects[shstrndx].sh_size);
+  }
+  for (size_t i = 0; i < shnum; i++) {
+    const auto &sh = sects[i];
+    auto type = resive(sh.sh_type);
+    uint64_t flags = resive(sh.sh_flags);
+    uint64_t size = resive(sh.sh_size);
+    auto name = (noff == 0) ? std::string_view() : strview(noff + resive(sh.sh_name), nend);
+    if (type == SHT_NULL) {
+      continue;
+    }
+    if (type == SHT_NOBITS) {
+      es.bss += size;
+      continue;
+    }
+    if (elf_debug_section(name)) {
+      es.debug += size;
+      es.strippable += size;
+    } else if (type == SHT_REL || type == SHT_RELA || type == SHT_RELR) {
+      es.relocations += size;
+    } else if (type == SHT_SYMTAB || type == SHT_DYNSYM || type == SHT_HASH ||
+               type == SHT_GNU_HASH || type == SHT_GNU_versym || type == SHT_GNU_verneed ||
+               type == SHT_GNU_verdef || (type == SHT_STRTAB && (flags & SHF_ALLOC) != 0)) {
+      es.symbols += size;
+    } else if (type == SHT_STRTAB && name == ".strtab") {
+      es.symbols += size;
+      es.strippable += size;
+    } else if ((flags & SHF_EXECINSTR) != 0) {
+      es.text += size;
+    } else if ((flags & SHF_ALLOC) != 0) {
+      if ((flags & SHF_WRITE) != 0) {
+        es.data += size;
+      } else {
+        es.rodata += size;
+      }
+    } else {
+      es.other += size;
+    }
+    if (type == SHT_SYMTAB) {
+      es.strippable += size;
+    }
+    uint64_t off = resive(sh.sh_offset);
+    if ((flags & SHF_COMPRESSED) != 0) {
+      elf_compressed_section_t cs;
+      cs.name = bela::ToWide(name);
+      cs.size = size;
+      if (auto ch = cast<typename L::Chdr>(off); ch != nullptr) {
+        cs.uncompressed = resive(ch->ch_size);
+        switch (resive(ch->ch_type)) {
+        case ELFCOMPRESS_ZLIB:
+          cs.compression = L"zlib";
+          break;
+        case ELFCOMPRESS_ZSTD:
+          cs.compression = L"zstd";
+          break;
+        default:
+          cs.compression = bela::StringCat(L"unknown (", resive(ch->ch_type), L")");
+          break;
+        }
+      }
+      es.compressed.emplace_back(std::move(cs));
+      continue;
+    }
+    // GNU legacy format: "ZLIB" + 64-bit big-endian uncompressed size
+    if (name.compare(0, 8, ".zdebug_") == 0 && off <= size_ && size_ - off >= 12 &&
+        memcmp(data_ + off, "ZLIB", 4) == 0) {
+      elf_compressed_section_t cs;
+      cs.name = bela::ToWide(name);
+      cs.compression = L"zlib (GNU .zdebug)";
+      cs.size = size;
+      cs.uncompressed = bela::readbe<uint64_t>(data_ + off + 4);
+      es.compressed.emplace_back(std::move(cs));
     }
-    s.push_back(data_[i]);
   }
-  return s;
 }
 
-//
-bool elf_memview::inquisitive64(elf_minutiae_t &em, bela::error_code &ec) {
-  auto h = cast<Elf64_Ehdr>(0);
+template <typename L>
+bool elf_memview::inquisitive_layout(elf_minutiae_t &em, bela::error_code &ec) {
+  auto h = cast<typename L::Ehdr>(0);
   if (h == nullptr) {
     return false;
   }
   em.machine = elf_machine(resive(h->e_machine));
   em.etype = elf_object_type(resive(h->e_type));
-  auto off = resive(h->e_shoff);
-  auto sects = cast<Elf64_Shdr>(off);
-  auto shnum = resive(h->e_shnum);
-  if (shnum * sizeof(Elf64_Shdr) + off > size_) {
+  uint64_t off = resive(h->e_shoff);
+  auto sects = cast<typename L::Shdr>(off);
+  uint64_t shnum = resive(h->e_shnum);
+  if (off > size_ || shnum > (size_ - off) / sizeof(typename L::Shdr)) {
     ec = bela::make_error_code(L"ELF file size too small");
     return false;
   }
-  Elf64_Off sh_offset = 0;
-  Elf64_Xword sh_entsize = 0;
-  Elf64_Xword sh_size = 0;
-  Elf64_Word sh_link = 0;
-  for (Elf64_Word i = 0; i < shnum; i++) {
+  uint64_t sh_offset = 0;
+  uint64_t sh_entsize = 0;
+  uint64_t sh_size = 0;
+  uint64_t sh_link = 0;
+  for (uint64_t i = 0; i < shnum; i++) {
     auto st = resive(sects[i].sh_type);
     if (st == SHT_DYNAMIC) {
       sh_entsize = resive(sects[i].sh_entsize);
@@ -358,41 +651,64 @@ bool elf_memview::inquisitive64(elf_minutiae_t &em, bela::error_code &ec) {
       continue;
     }
   }
+  if ((options_ & ElfSections) != 0) {
+    elf_sections_t es;
+    sections_resolve<L>(h, sects, static_cast<size_t>(shnum), es);
+    em.sections = std::make_optional<elf_sections_t>(std::move(es));
+  }
 
   if (sh_offset == 0 || sh_entsize == 0 || sh_offset >= size_) {
     return true;
   }
-  auto strtab = &sects[sh_link];
   if (sh_link >= shnum) {
     ec = bela::make_error_code(L"ELF file size too small");
     return false;
   }
+  auto strtab = &sects[sh_link];
 
-  Elf64_Off soff = resive(strtab->sh_offset);
-  Elf64_Off send = soff + resive(strtab->sh_size);
-  auto n = sh_size / sh_entsize;
-  auto dyn = cast<Elf64_Dyn>(sh_offset);
+  size_t soff = resive(strtab->sh_offset);
+  size_t send = soff + resive(strtab->sh_size);
+  auto n = (std::min)(sh_size, size_ - sh_offset) / sh_entsize;
+  auto dyn = cast<typename L::Dyn>(sh_offset);
+  if (dyn == nullptr) {
+    return true;
+  }
+  elf_version_tags_t vt;
   for (decltype(n) i = 0; i < n; i++) {
     auto first = resive(dyn[i].d_un.d_val);
     switch (resive(dyn[i].d_tag)) {
-    case DT_NEEDED: {
-      auto deps = stroffset(soff + first, send);
-      em.depends.push_back(bela::ToWide(deps));
-    } break;
+    case DT_NEEDED:
+      em.depends.emplace_back(bela::ToWide(strview(soff + first, send)));
+      break;
     case DT_SONAME:
-      em.soname = bela::ToWide(stroffset(soff + first, send));
+      em.soname = bela::ToWide(strview(soff + first, send));
       break;
     case DT_RUNPATH:
-      em.rupath = bela::ToWide(stroffset(soff + first, send));
+      em.rupath = bela::ToWide(strview(soff + first, send));
       break;
     case DT_RPATH:
-      em.rpath = bela::ToWide(stroffset(soff + first, send));
+      em.rpath = bela::ToWide(strview(soff + first, send));
+      break;
+    case DT_VERNEED:
+      vt.verneed = first;
+      break;
+    case DT_VERNEEDNUM:
+      vt.verneednum = first;
+      break;
+    case DT_VERDEF:
+      vt.verdef = first;
+      break;
+    case DT_VERDEFNUM:
+      vt.verdefnum = first;
+      break;
+    case DT_VERSYM:
+      vt.versym = first;
       break;
     default:
       break;
     }
   }
-
+  version_resolve<L>(sects, static_cast<size_t>(shnum), vt, soff, send, em);
   return true;
 }
 
@@ -405,78 +721,22 @@ bool elf_memview::inquisitive(elf_minutiae_t &em, bela::error_code &ec) {
   int eic = data_[EI_CLASS];
   if (eic == ELFCLASS64) {
     em.bit64 = true;
-    return inquisitive64(em, ec);
+    return inquisitive_layout<elf64_layout_t>(em, ec);
   }
   if (eic != ELFCLASS32) {
     ec = bela::make_error_code(1, L"EI_CLASS invalid:", eic);
     return false;
   }
-  auto h = cast<Elf32_Ehdr>(0);
-  em.machine = elf_machine(resive(h->e_machine));
-  em.etype = elf_object_type(resive(h->e_type));
-  auto off = resive(h->e_shoff);
-  auto sects = cast<Elf32_Shdr>(off);
-  auto shnum = resive(h->e_shnum);
-  if (shnum * sizeof(Elf32_Shdr) + off > size_) {
-    ec = bela::make_error_code(L"ELF file size too small");
-    return false;
-  }
-  Elf32_Off sh_offset = 0;
-  Elf32_Xword sh_entsize = 0;
-  Elf32_Xword sh_size = 0;
-  Elf32_Word sh_link = 0;
-  for (Elf32_Word i = 0; i < shnum; i++) {
-    auto st = resive(sects[i].sh_type);
-    if (st == SHT_DYNAMIC) {
-      sh_entsize = resive(sects[i].sh_entsize);
-      sh_offset = resive(sects[i].sh_offset);
-      sh_size = resive(sects[i].sh_size);
-      sh_link = resive(sects[i].sh_link);
-      continue;
-    }
-  }
-
-  if (sh_offset == 0 || sh_entsize == 0 || sh_offset >= size_) {
-    return true;
-  }
-  auto strtab = &sects[sh_link];
-  if (sh_link >= shnum) {
-    return false;
-  }
-
-  Elf32_Off soff = resive(strtab->sh_offset);
-  Elf32_Off send = soff + resive(strtab->sh_size);
-  auto n = sh_size / sh_entsize;
-  auto dyn = cast<Elf32_Dyn>(sh_offset);
-
-  for (decltype(n) i = 0; i < n; i++) {
-    auto first = resive(dyn[i].d_un.d_val);
-    switch (resive(dyn[i].d_tag)) {
-    case DT_NEEDED: {
-      auto deps = stroffset(soff + first, send);
-      em.depends.push_back(bela::ToWide(deps));
-    } break;
-    case DT_SONAME:
-      em.soname = bela::ToWide(stroffset(soff + first, send));
-      break;
-    case DT_RUNPATH:
-      em.rupath = bela::ToWide(stroffset(soff + first, send));
-      break;
-    case DT_RPATH:
-      em.rpath = bela::ToWide(stroffset(soff + first, send));
-      break;
-    default:
-      break;
-    }
-  }
-  return true;
+  return inquisitive_layout<elf32_layout_t>(em, ec);
 }
-std::optional<elf_minutiae_t> inquisitive_elf(std::wstring_view sv, bela::error_code &ec) {
+
+std::optional<elf_minutiae_t> inquisitive_elf(std::wstring_view sv, bela::error_code &ec,
+                                              uint32_t options) {
   base::MapView mv;
   if (!mv.MappingView(sv, ec, sizeof(Elf32_Ehdr))) {
     return std::nullopt;
   }
-  elf_memview emv(mv.subview());
+  elf_memview emv(mv.subview(), options);
   elf_minutiae_t em;
   if (emv.inquisitive(em, ec)) {
     return std::make_optional<elf_minutiae_t>(std::move(em));
@@ -0,0 +1,255 @@
+/// ELF core dump details
+#include <elf.h>
+#include <bela/codecvt.hpp>
+#include <bela/strcat.hpp>
+#include "inquisitive.hpp"
+
+// Core file may be several GB, we only map ELF header, program headers and PT_NOTE segments.
+// https://man7.org/linux/man-pages/man5/core.5.html
+// https://github.com/torvalds/linux/blob/master/fs/binfmt_elf.c
+
+namespace inquisitive {
+const wchar_t *elf_machine(uint32_t e);
+
+// NT_PRSTATUS/NT_PRPSINFO are too large, so we only read fields we need
+constexpr size_t prstatus_cursig = 12;
+constexpr size_t prstatus32_pid = 24;
+constexpr size_t prstatus64_pid = 32;
+constexpr size_t prpsinfo32_psargs = 44;
+constexpr size_t prpsinfo64_psargs = 56;
+constexpr size_t prpsinfo_psargs_len = 80;
+constexpr uint64_t notes_limit = 64ull * 1024 * 1024; // 64MB notes per segment
+
+struct elf_note_segment_t {
+  uint64_t offset;
+  uint64_t size;
+};
+
+class elf_core_view {
+public:
+  bool inquisitive(std::wstring_view sv, elf_core_minutiae_t &cm, bela::error_code &ec);
+
+private:
+  base::WindowView wv;
+  bool resiveable{false};
+  template <typename Integer> Integer resive(Integer i) {
+    if (!resiveable) {
+      return i;
+    }
+    return bela::bswap(i);
+  }
+  template <typename T> T read(const uint8_t *p) { return resive(bela::unalignedloadT<T>(p)); }
+  // long in notes is 4 or 8 bytes
+  uint64_t readlong(const uint8_t *p, bool bit64) {
+    return bit64 ? read<uint64_t>(p) : read<uint32_t>(p);
+  }
+  template <typename Ehdr, typename Phdr, typename Shdr>
+  bool segments(base::MemView mv, elf_core_minutiae_t &cm, std::vector<elf_note_segment_t> &notes,
+                bela::error_code &ec);
+  void notes_resolve(base::MemView mv, elf_core_minutiae_t &cm);
+  void note_resolve(uint32_t type, base::MemView desc, elf_core_minutiae_t &cm);
+};
+
+template <typename Ehdr, typename Phdr, typename Shdr>
+bool elf_core_view::segments(base::MemView mv, elf_core_minutiae_t &cm,
+                             std::vector<elf_note_segment_t> &notes, bela::error_code &ec) {
+  auto h = mv.cast<Ehdr>(0);
+  if (h == nullptr) {
+    ec = bela::make_error_code(L"ELF file size too small");
+    return false;
+  }
+  cm.machine = elf_machine(resive(h->e_machine));
+  uint64_t phoff = resive(h->e_phoff);
+  uint64_t phnum = resive(h->e_phnum);
+  // more than 65534 mappings, real count is sh_info of section header 0
+  if (phnum == PN_XNUM) {
+    Shdr sh0;
+    if (wv.ReadAt(resive(h->e_shoff), &sh0, sizeof(sh0), ec) != sizeof(sh0)) {
+      ec = bela::make_error_code(L"ELF section header 0 out of file range");
+      return false;
+    }
+    phnum = resive(sh0.sh_info);
+  }
+  if (phnum == 0) {
+    return true;
+  }
+  if (phoff > wv.size() || phnum > (wv.size() - phoff) / sizeof(Phdr)) {
+    ec = bela::make_error_code(L"ELF program headers out of file range");
+    return false;
+  }
+  auto phmv = wv.Window(phoff, static_cast<size_t>(phnum * sizeof(Phdr)), ec);
+  if (phmv.size() != phnum * sizeof(Phdr)) {
+    if (!ec) {
+      ec = bela::make_error_code(L"ELF program headers out of file range");
+    }
+    return false;
+  }
+  auto phdrs = reinterpret_cast<const Phdr *>(phmv.data());
+  for (uint64_t i = 0; i < phnum; i++) {
+    if (resive(phdrs[i].p_type) == PT_NOTE) {
+      notes.emplace_back(
+          elf_note_segment_t{resive(phdrs[i].p_offset), resive(phdrs[i].p_filesz)});
+      continue;
+    }
+    if (resive(phdrs[i].p_type) == PT_LOAD) {
+      cm.loads++;
+      cm.loadsize += resive(phdrs[i].p_filesz);
+    }
+  }
+  return true;
+}
+
+void elf_core_view::note_resolve(uint32_t type, base::MemView desc, elf_core_minutiae_t &cm) {
+  auto p = desc.data();
+  auto size = desc.size();
+  switch (type) {
+  case NT_PRSTATUS: {
+    auto pidoff = cm.bit64 ? prstatus64_pid : prstatus32_pid;
+    if (size < pidoff + sizeof(uint32_t)) {
+      break;
+    }
+    if (cm.threads++ == 0) {
+      // first thread is the thread which crashed
+      cm.signal = read<int16_t>(p + prstatus_cursig);
+      cm.pid = read<uint32_t>(p + pidoff);
+    }
+  } break;
+  case NT_PRPSINFO: {
+    auto argsoff = cm.bit64 ? prpsinfo64_psargs : prpsinfo32_psargs;
+    if (size < argsoff + prpsinfo_psargs_len) {
+      break;
+    }
+    auto args = reinterpret_cast<const char *>(p + argsoff);
+    std::string_view sv(args, byte_strnlen(args, prpsinfo_psargs_len));
+    while (!sv.empty() && sv.back() == ' ') {
+      sv.remove_suffix(1);
+    }
+    cm.command = bela::ToWide(sv);
+  } break;
+  case NT_AUXV: {
+    size_t width = cm.bit64 ? 8 : 4;
+    for (size_t off = 0; off + width * 2 <= size; off += width * 2) {
+      auto t = readlong(p + off, cm.bit64);
+      if (t == AT_NULL) {
+        break;
+      }
+      cm.auxv.emplace_back(elf_core_auxv_t{t, readlong(p + off + width, cm.bit64)});
+    }
+  } break;
+  case NT_FILE: {
+    // long count; long page_size; {long start, end, file_ofs}[count]; char filenames[]
+    size_t width = cm.bit64 ? 8 : 4;
+    if (size < width * 2) {
+      break;
+    }
+    auto count = readlong(p, cm.bit64);
+    auto pagesize = readlong(p + width, cm.bit64);
+    size_t off = width * 2;
+    if (count > (size - off) / (width * 3)) {
+      break;
+    }
+    size_t noff = off + static_cast<size_t>(count) * width * 3;
+    cm.files.reserve(static_cast<size_t>(count));
+    for (uint64_t i = 0; i < count && noff < size; i++, off += width * 3) {
+      elf_core_file_t file;
+      file.start = readlong(p + off, cm.bit64);
+      file.end = readlong(p + off + width, cm.bit64);
+      file.offset = readlong(p + off + width * 2, cm.bit64) * pagesize;
+      auto name = reinterpret_cast<const char *>(p + noff);
+      auto n = byte_strnlen(name, size - noff);
+      file.path = bela::ToWide(std::string_view(name, n));
+      noff += n + 1;
+      cm.files.emplace_back(std::move(file));
+    }
+  } break;
+  default:
+    break;
+  }
+}
+
+// Elf32_Nhdr and Elf64_Nhdr are same, core notes are 4-byte aligned
+void elf_core_view::notes_resolve(base::MemView mv, elf_core_minutiae_t &cm) {
+  constexpr std::string_view coreName("CORE");
+  auto align4 = [](uint64_t n) { return (n + 3) & ~uint64_t(3); };
+  uint64_t off = 0;
+  auto size = mv.size();
+  while (off + sizeof(Elf64_Nhdr) <= size) {
+    auto p = mv.data() + off;
+    uint64_t namesz = read<uint32_t>(p);
+    uint64_t descsz = read<uint32_t>(p + 4);
+    auto type = read<uint32_t>(p + 8);
+    auto doff = off + sizeof(Elf64_Nhdr) + align4(namesz);
+    if (doff + descsz > size) {
+      break;
+    }
+    std::string_view name(reinterpret_cast<const char *>(p + sizeof(Elf64_Nhdr)),
+                          static_cast<size_t>(namesz));
+    if (!name.empty() && name.back() == 0) {
+      name.remove_suffix(1);
+    }
+    if (name == coreName) {
+      note_resolve(type, base::MemView(mv.data() + doff, static_cast<size_t>(descsz)), cm);
+    }
+    off = doff + align4(descsz);
+  }
+}
+
+bool elf_core_view::inquisitive(std::wstring_view sv, elf_core_minutiae_t &cm,
+                                bela::error_code &ec) {
+  if (!wv.Open(sv, ec, sizeof(Elf32_Ehdr))) {
+    return false;
+  }
+  std::vector<elf_note_segment_t> notes;
+  {
+    constexpr const uint8_t elfMagic[] = {0x7f, 'E', 'L', 'F'};
+    auto mv = wv.Window(0, sizeof(Elf64_Ehdr) * 2, ec);
+    if (mv.size() <= sizeof(Elf32_Ehdr) || !mv.StartsWith(elfMagic)) {
+      ec = bela::make_error_code(L"not ELF file");
+      return false;
+    }
+    cm.endian = (mv[EI_DATA] == ELFDATA2MSB) ? endian::BigEndian : endian::LittleEndian;
+    resiveable = ((cm.endian == endian::BigEndian) != bela::IsBigEndianHost);
+    switch (mv[EI_CLASS]) {
+    case ELFCLASS64:
+      cm.bit64 = true;
+      if (!segments<Elf64_Ehdr, Elf64_Phdr, Elf64_Shdr>(mv, cm, notes, ec)) {
+        return false;
+      }
+      break;
+    case ELFCLASS32:
+      if (!segments<Elf32_Ehdr, Elf32_Phdr, Elf32_Shdr>(mv, cm, notes, ec)) {
+        return false;
+      }
+      break;
+    default:
+      ec = bela::make_error_code(1, L"EI_CLASS invalid:", (int)mv[EI_CLASS]);
+      return false;
+    }
+  }
+  // only PT_NOTE segments are mapped, PT_LOAD memory contents are never touched
+  for (const auto &n : notes) {
+    // core cut short while being written, other notes are still useful
+    auto want = static_cast<size_t>((std::min)(n.size, notes_limit));
+    bela::error_code nec;
+    auto mv = wv.Window(n.offset, want, nec);
+    if (mv.size() != want) {
+      cm.incomplete = true;
+      continue;
+    }
+    cm.notesize += mv.size();
+    notes_resolve(mv, cm);
+  }
+  return true;
+}
+
+std::optional<elf_core_minutiae_t> inquisitive_elfcore(std::wstring_view sv,
+                                                       bela::error_code &ec) {
+  elf_core_view cv;
+  elf_core_minutiae_t cm;
+  if (!cv.inquisitive(sv, cm, ec)) {
+    return std::nullopt;
+  }
+  return std::make_optional<elf_core_minutiae_t>(std::move(cm));
+}
+
+} // namespace inquisitive
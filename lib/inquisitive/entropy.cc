@@ -0,0 +1,66 @@
+/// Byte histogram and Shannon entropy
+#include <cmath>
+#include "inquisitive.hpp"
+
+namespace inquisitive {
+
+// counts of one table may overflow uint32_t after 16GB, flush every 1GB
+constexpr size_t histogram_flush = 1ull << 30;
+
+// four interleaved tables, consecutive equal bytes increment different counters so the
+// increments do not wait on the store of previous one
+void byte_histogram(const uint8_t *data, size_t size, uint64_t counts[256]) {
+  uint32_t t[4][256];
+  while (size != 0) {
+    auto n = (std::min)(size, histogram_flush);
+    memset(t, 0, sizeof(t));
+    auto p = data;
+    auto end = data + n;
+    for (; end - p >= 16; p += 16) {
+      auto a = bela::unalignedloadT<uint64_t>(p);
+      auto b = bela::unalignedloadT<uint64_t>(p + 8);
+      for (int i = 0; i < 64; i += 16) {
+        t[0][(a >> i) & 0xFF]++;
+        t[1][(a >> (i + 8)) & 0xFF]++;
+        t[2][(b >> i) & 0xFF]++;
+        t[3][(b >> (i + 8)) & 0xFF]++;
+      }
+    }
+    for (; p < end; p++) {
+      t[0][*p]++;
+    }
+    for (size_t i = 0; i < 256; i++) {
+      counts[i] += static_cast<uint64_t>(t[0][i]) + t[1][i] + t[2][i] + t[3][i];
+    }
+    data += n;
+    size -= n;
+  }
+}
+
+// Shannon entropy in bits per byte, 0.0 - 8.0
+double shannon_entropy(const uint64_t counts[256]) {
+  uint64_t total = 0;
+  for (size_t i = 0; i < 256; i++) {
+    total += counts[i];
+  }
+  if (total == 0) {
+    return 0;
+  }
+  double e = 0;
+  for (size_t i = 0; i < 256; i++) {
+    if (counts[i] == 0) {
+      continue;
+    }
+    auto p = static_cast<double>(counts[i]) / static_cast<double>(total);
+    e -= p * std::log2(p);
+  }
+  return e;
+}
+
+double shannon_entropy(const uint8_t *data, size_t size) {
+  uint64_t counts[256] = {0};
+  byte_histogram(data, size, counts);
+  return shannon_entropy(counts);
+}
+
+} // namespace inquisitive
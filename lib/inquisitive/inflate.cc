@@ -0,0 +1,404 @@
+/// DEFLATE decoder, enough to sniff archive members without zlib
+#include <cstring>
+#include <algorithm>
+#include <bela/endian.hpp>
+#include "inflate.hpp"
+
+namespace inquisitive {
+constexpr uint16_t inflate_length_base[29] = {3,  4,  5,  6,   7,   8,   9,   10,  11, 13,
+                                              15, 17, 19, 23,  27,  31,  35,  43,  51, 59,
+                                              67, 83, 99, 115, 131, 163, 195, 227, 258};
+constexpr uint8_t inflate_length_extra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                              2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+constexpr uint16_t inflate_dist_base[30] = {
+    1,   2,   3,   4,   5,   7,    9,    13,   17,   25,   33,   49,   65,    97,    129,
+    193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+constexpr uint8_t inflate_dist_extra[30] = {0, 0, 0, 0, 1, 1, 2, 2,  3,  3,  4,  4,  5,  5,  6,
+                                            6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+constexpr uint8_t inflate_clen_order[19] = {16, 17, 18, 0, 8,  7, 9,  6, 10, 5,
+                                            11, 4,  12, 3, 13, 2, 14, 1, 15};
+
+bool inflate_huffman_t::build(const uint8_t *lengths, size_t n) {
+  memset(count, 0, sizeof(count));
+  memset(fast, 0, sizeof(fast));
+  for (size_t i = 0; i < n; i++) {
+    count[lengths[i]]++;
+  }
+  // over-subscribed set is invalid, incomplete set is allowed and unused codes fail in decode
+  int left = 1;
+  for (int len = 1; len < 16; len++) {
+    left = (left << 1) - count[len];
+    if (left < 0) {
+      return false;
+    }
+  }
+  uint16_t offs[16] = {0};
+  for (int len = 1; len < 15; len++) {
+    offs[len + 1] = offs[len] + count[len];
+  }
+  for (size_t i = 0; i < n; i++) {
+    if (lengths[i] != 0) {
+      symbol[offs[lengths[i]]++] = static_cast<uint16_t>(i);
+    }
+  }
+  // huffman codes are packed starting from MSB, so table is indexed by reversed code
+  uint32_t code = 0;
+  size_t index = 0;
+  for (int len = 1; len <= fastbits; len++) {
+    for (uint16_t k = 0; k < count[len]; k++, index++, code++) {
+      uint32_t rev = 0;
+      for (int b = 0; b < len; b++) {
+        rev |= ((code >> b) & 1) << (len - 1 - b);
+      }
+      auto e = static_cast<uint16_t>((symbol[index] << 4) | len);
+      for (auto r = rev; r < (1u << fastbits); r += (1u << len)) {
+        fast[r] = e;
+      }
+    }
+    code <<= 1;
+  }
+  return true;
+}
+
+struct inflate_fixed_t {
+  inflate_huffman_t lit;
+  inflate_huffman_t dist;
+  inflate_fixed_t() {
+    uint8_t lengths[288];
+    memset(lengths, 8, 144);
+    memset(lengths + 144, 9, 112);
+    memset(lengths + 256, 7, 24);
+    memset(lengths + 280, 8, 8);
+    lit.build(lengths, 288);
+    memset(lengths, 5, 30);
+    dist.build(lengths, 30);
+  }
+};
+
+const inflate_fixed_t &inflate_fixed() {
+  static const inflate_fixed_t fixed;
+  return fixed;
+}
+
+void inflate_stream::reset(const uint8_t *data, size_t size) {
+  if (buffer_.empty()) {
+    buffer_.resize(inflate_window_size + inflate_chunk_size + inflate_match_max);
+  }
+  in_ = data;
+  insize_ = size;
+  inpos_ = 0;
+  bitbuf_ = 0;
+  bitcnt_ = 0;
+  padbits_ = 0;
+  pos_ = 0;
+  storedlen_ = 0;
+  total_ = 0;
+  last_ = false;
+  more_ = false;
+  state_ = Header;
+  lit_ = nullptr;
+  dist_ = nullptr;
+}
+
+void inflate_stream::feed(const uint8_t *data, size_t size, bool more) {
+  in_ = data;
+  insize_ = size;
+  inpos_ = 0;
+  more_ = more;
+  // fast refill loads bytes past bitcnt_, they are loaded again from new part
+  bitbuf_ &= (uint64_t(1) << bitcnt_) - 1;
+}
+
+void inflate_stream::resume(const uint8_t *data, size_t size) {
+  if (buffer_.empty()) {
+    reset(data, size);
+    return;
+  }
+  in_ = data;
+  insize_ = size;
+  inpos_ = 0;
+  bitbuf_ = 0;
+  bitcnt_ = 0;
+  padbits_ = 0;
+  storedlen_ = 0;
+  last_ = false;
+  more_ = false;
+  state_ = Header;
+}
+
+// keep at least 57 bits, input end is padded with zero bytes which truncated() detects
+void inflate_stream::refill() {
+  if (insize_ - inpos_ >= 8) {
+    bitbuf_ |= bela::readle<uint64_t>(in_ + inpos_) << bitcnt_;
+    inpos_ += (63 - bitcnt_) >> 3;
+    bitcnt_ |= 56;
+    return;
+  }
+  while (bitcnt_ <= 56) {
+    if (inpos_ < insize_) {
+      bitbuf_ |= static_cast<uint64_t>(in_[inpos_++]) << bitcnt_;
+    } else {
+      padbits_ += 8;
+    }
+    bitcnt_ += 8;
+  }
+}
+
+uint32_t inflate_stream::bits(int n) {
+  if (bitcnt_ < n) {
+    refill();
+  }
+  auto v = static_cast<uint32_t>(bitbuf_ & ((uint64_t(1) << n) - 1));
+  bitbuf_ >>= n;
+  bitcnt_ -= n;
+  return v;
+}
+
+int inflate_stream::decode(const inflate_huffman_t &h) {
+  if (bitcnt_ < 15) {
+    refill();
+  }
+  auto e = h.fast[bitbuf_ & ((1u << inflate_huffman_t::fastbits) - 1)];
+  if (e != 0) {
+    auto len = e & 0xF;
+    bitbuf_ >>= len;
+    bitcnt_ -= len;
+    return e >> 4;
+  }
+  // long code, walk canonical ranges of each length
+  int code = 0;
+  int first = 0;
+  int index = 0;
+  for (int len = 1; len < 16; len++) {
+    code |= static_cast<int>((bitbuf_ >> (len - 1)) & 1);
+    int count = h.count[len];
+    if (code - count < first) {
+      bitbuf_ >>= len;
+      bitcnt_ -= len;
+      return h.symbol[index + (code - first)];
+    }
+    index += count;
+    first = (first + count) << 1;
+    code <<= 1;
+  }
+  return -1;
+}
+
+void inflate_stream::align() {
+  auto n = bitcnt_ & 7;
+  bitbuf_ >>= n;
+  bitcnt_ -= n;
+}
+
+bool inflate_stream::dynamic_tables() {
+  size_t nlen = bits(5) + 257;
+  size_t ndist = bits(5) + 1;
+  size_t ncode = bits(4) + 4;
+  if (nlen > 286 || ndist > 30) {
+    return false;
+  }
+  uint8_t clens[19] = {0};
+  for (size_t i = 0; i < ncode; i++) {
+    clens[inflate_clen_order[i]] = static_cast<uint8_t>(bits(3));
+  }
+  inflate_huffman_t clen;
+  if (!clen.build(clens, 19)) {
+    return false;
+  }
+  uint8_t lengths[286 + 30] = {0};
+  size_t index = 0;
+  while (index < nlen + ndist) {
+    auto sym = decode(clen);
+    if (sym < 0 || truncated()) {
+      return false;
+    }
+    if (sym < 16) {
+      lengths[index++] = static_cast<uint8_t>(sym);
+      continue;
+    }
+    uint8_t len = 0;
+    size_t repeat = 0;
+    if (sym == 16) {
+      if (index == 0) {
+        return false;
+      }
+      len = lengths[index - 1];
+      repeat = 3 + bits(2);
+    } else if (sym == 17) {
+      repeat = 3 + bits(3);
+    } else {
+      repeat = 11 + bits(7);
+    }
+    if (repeat > nlen + ndist - index) {
+      return false;
+    }
+    memset(lengths + index, len, repeat);
+    index += repeat;
+  }
+  // end of block code is required
+  if (lengths[256] == 0) {
+    return false;
+  }
+  return dynlit_.build(lengths, nlen) && dyndist_.build(lengths + nlen, ndist);
+}
+
+bool inflate_stream::block_header() {
+  refill();
+  if (truncated()) {
+    state_ = Truncated;
+    return false;
+  }
+  last_ = bits(1) != 0;
+  switch (bits(2)) {
+  case 0: {
+    align();
+    auto len = bits(16);
+    auto nlen = bits(16);
+    if (truncated()) {
+      state_ = Truncated;
+      return false;
+    }
+    if (len != (~nlen & 0xFFFF)) {
+      state_ = Bad;
+      return false;
+    }
+    // stored bytes are copied straight from input, return unread whole bytes to it
+    inpos_ -= static_cast<size_t>((bitcnt_ - padbits_) / 8);
+    bitbuf_ = 0;
+    bitcnt_ = 0;
+    padbits_ = 0;
+    storedlen_ = len;
+    state_ = Stored;
+  } break;
+  case 1:
+    lit_ = &inflate_fixed().lit;
+    dist_ = &inflate_fixed().dist;
+    state_ = Huffman;
+    break;
+  case 2:
+    if (!dynamic_tables()) {
+      state_ = truncated() ? Truncated : Bad;
+      return false;
+    }
+    lit_ = &dynlit_;
+    dist_ = &dyndist_;
+    state_ = Huffman;
+    break;
+  default:
+    state_ = Bad;
+    return false;
+  }
+  return true;
+}
+
+void inflate_stream::stored(size_t end) {
+  auto n = (std::min)({storedlen_, end - pos_, insize_ - inpos_});
+  memcpy(buffer_.data() + pos_, in_ + inpos_, n);
+  pos_ += n;
+  inpos_ += n;
+  storedlen_ -= n;
+  if (storedlen_ == 0) {
+    state_ = last_ ? Done : Header;
+    return;
+  }
+  if (inpos_ == insize_ && !more_) {
+    state_ = Truncated;
+  }
+}
+
+void inflate_stream::huffman(size_t end) {
+  auto out = buffer_.data();
+  while (pos_ < end) {
+    if (starved()) {
+      return;
+    }
+    // literal/length, distance and their extra bits take at most 48 bits
+    if (bitcnt_ < 48) {
+      refill();
+    }
+    auto sym = decode(*lit_);
+    if (sym < 256) {
+      if (sym < 0 || truncated()) {
+        state_ = sym < 0 ? Bad : Truncated;
+        return;
+      }
+      out[pos_++] = static_cast<uint8_t>(sym);
+      continue;
+    }
+    if (sym == 256) {
+      if (truncated()) {
+        state_ = Truncated;
+        return;
+      }
+      state_ = last_ ? Done : Header;
+      if (last_) {
+        align();
+      }
+      return;
+    }
+    sym -= 257;
+    if (sym >= 29) {
+      state_ = Bad;
+      return;
+    }
+    size_t len = inflate_length_base[sym] + bits(inflate_length_extra[sym]);
+    auto dsym = decode(*dist_);
+    if (dsym < 0 || dsym >= 30) {
+      state_ = Bad;
+      return;
+    }
+    size_t distance = inflate_dist_base[dsym] + bits(inflate_dist_extra[dsym]);
+    if (truncated()) {
+      state_ = Truncated;
+      return;
+    }
+    if (distance > pos_) {
+      state_ = Bad;
+      return;
+    }
+    auto dest = out + pos_;
+    auto src = dest - distance;
+    if (distance >= len) {
+      memcpy(dest, src, len);
+    } else {
+      // overlapped copy repeats last distance bytes
+      for (size_t i = 0; i < len; i++) {
+        dest[i] = src[i];
+      }
+    }
+    pos_ += len;
+  }
+}
+
+bela::MemView inflate_stream::read(size_t max) {
+  max = (std::min)(max, inflate_chunk_size);
+  if (buffer_.empty() || state_ >= Done) {
+    return bela::MemView();
+  }
+  if (pos_ + max + inflate_match_max > buffer_.size()) {
+    // back references reach 32K at most, drop older output
+    memmove(buffer_.data(), buffer_.data() + pos_ - inflate_window_size, inflate_window_size);
+    pos_ = inflate_window_size;
+  }
+  auto start = pos_;
+  auto end = pos_ + max;
+  while (pos_ < end && state_ < Done && !starved()) {
+    switch (state_) {
+    case Header:
+      block_header();
+      break;
+    case Stored:
+      stored(end);
+      break;
+    case Huffman:
+      huffman(end);
+      break;
+    default:
+      break;
+    }
+  }
+  total_ += pos_ - start;
+  return bela::MemView(buffer_.data() + start, pos_ - start);
+}
+
+} // namespace inquisitive
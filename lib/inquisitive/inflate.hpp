@@ -0,0 +1,96 @@
+//// DEFLATE
+#ifndef INQUISITIVE_INFLATE_HPP
+#define INQUISITIVE_INFLATE_HPP
+#include <cstdint>
+#include <vector>
+#include <bela/memview.hpp>
+// https://www.rfc-editor.org/rfc/rfc1951
+
+namespace inquisitive {
+// decompressed prefix handed back to detectors, enough for every magic and header we read
+constexpr size_t inflate_sniff_size = 8 * 1024;
+constexpr size_t inflate_window_size = 32 * 1024;
+constexpr size_t inflate_chunk_size = 64 * 1024;
+constexpr size_t inflate_match_max = 258;
+// input kept back when more input follows, covers a dynamic block header (about 600 bytes) and
+// bit buffer refill, decoding pauses below it until feed() hands the next part
+constexpr size_t inflate_input_margin = 1024;
+
+struct inflate_huffman_t {
+  static constexpr int fastbits = 10;
+  uint16_t fast[1 << fastbits]; /// (symbol << 4) | length, 0 when code is longer than fastbits
+  uint16_t count[16];           /// codes of each length
+  uint16_t symbol[288];         /// symbols in canonical order
+  bool build(const uint8_t *lengths, size_t n);
+};
+
+// inflate_stream decodes raw DEFLATE from mapped input in chunks, 32K history and current chunk
+// live in one buffer allocated once, reset() reuses it for next member
+class inflate_stream {
+public:
+  enum state_t : int { Header = 0, Stored, Huffman, Done, Truncated, Bad };
+  inflate_stream() = default;
+  inflate_stream(const inflate_stream &) = delete;
+  inflate_stream &operator=(const inflate_stream &) = delete;
+  void reset(const uint8_t *data, size_t size);
+  void reset(bela::MemView mv) { reset(mv.data(), mv.size()); }
+  // more tells input continues past size, next part is handed by feed()
+  void reset(const uint8_t *data, size_t size, bool more) {
+    reset(data, size);
+    more_ = more;
+  }
+  // continue same stream, data starts at byte input_used() of previous part
+  void feed(const uint8_t *data, size_t size, bool more);
+  // decoding paused until next part is fed
+  bool starved() const {
+    return more_ && state_ < Done && insize_ - inpos_ < inflate_input_margin;
+  }
+  size_t input_used() const { return inpos_; }
+  // continue with next stream which may refer to output of previous one (CAB MSZIP blocks)
+  void resume(const uint8_t *data, size_t size);
+  // decode max bytes (a match may add a few more), less only when stream ends
+  // view is valid until next read or reset
+  bela::MemView read(size_t max = inflate_chunk_size);
+  state_t state() const { return state_; }
+  bool done() const { return state_ == Done; }
+  bool bad() const { return state_ == Bad; }
+  // stream ended, input ran out or data is corrupt
+  bool eof() const { return state_ >= Done; }
+  uint64_t total_out() const { return total_; }
+  // input bytes consumed, after Done it is offset of data following the stream (gzip trailer)
+  size_t consumed() const {
+    return bitcnt_ > padbits_ ? inpos_ - static_cast<size_t>((bitcnt_ - padbits_) / 8) : inpos_;
+  }
+
+private:
+  void refill();
+  uint32_t bits(int n);
+  int decode(const inflate_huffman_t &h);
+  bool truncated() const { return bitcnt_ < padbits_; }
+  void align();
+  bool block_header();
+  bool dynamic_tables();
+  void stored(size_t end);
+  void huffman(size_t end);
+  std::vector<uint8_t> buffer_;
+  const uint8_t *in_{nullptr};
+  size_t insize_{0};
+  size_t inpos_{0};
+  uint64_t bitbuf_{0};
+  int bitcnt_{0};
+  int padbits_{0}; /// zero bits appended past end of input
+  size_t pos_{0};  /// write position in buffer
+  size_t storedlen_{0};
+  uint64_t total_{0};
+  bool last_{false};
+  bool more_{false}; /// input continues past insize_
+  state_t state_{Done};
+  const inflate_huffman_t *lit_{nullptr};
+  const inflate_huffman_t *dist_{nullptr};
+  inflate_huffman_t dynlit_;
+  inflate_huffman_t dyndist_;
+};
+
+} // namespace inquisitive
+
+#endif
@@ -22,14 +22,7 @@ std::wstring FindExtension(std::wstring_view sv) {
   return std::wstring(fn.data() + pos + 1, fn.size() - pos - 1);
 }
 
-std::optional<inquisitive_result_t> inquisitive(std::wstring_view sv, bela::error_code &ec) {
-  auto extension = FindExtension(sv);
-  base::MapView mmv;
-  if (!mmv.MappingView(sv, ec, 1, 32 * 1024)) {
-    return std::nullopt;
-  }
-  auto mv = mmv.subview();
-  inquisitive_result_t ir;
+status_t inquisitive_memview(base::MemView mv, inquisitive_result_t &ir) {
   const inquisitive_handle_t handles[] = {
       // handles
       inquisitive_binobj, inquisitive_fonts,    inquisitive_zip_family, inquisitive_docs,
@@ -39,10 +32,56 @@ std::optional<inquisitive_result_t> inquisitive(std::wstring_view sv, bela::erro
   };
   for (auto h : handles) {
     if (h(mv, ir) == Found) {
-      return std::make_optional<inquisitive_result_t>(std::move(ir));
+      return Found;
     }
   }
-  return std::nullopt;
+  return None;
+}
+
+std::optional<inquisitive_result_t> inquisitive(std::wstring_view sv, bela::error_code &ec) {
+  auto extension = FindExtension(sv);
+  base::MapView mmv;
+  if (!mmv.MappingView(sv, ec, 1, 32 * 1024)) {
+    return std::nullopt;
+  }
+  auto mv = mmv.subview();
+  inquisitive_result_t ir;
+  if (inquisitive_memview(mv, ir) != Found) {
+    return std::nullopt;
+  }
+  if (ir.typeex() == types::ZIP) {
+    // keep generic zip when central directory is damaged
+    inquisitive_zip_container(sv, ir);
+  }
+  switch (ir.type()) {
+  case types::gz:
+  case types::xz:
+  case types::bz2:
+  case types::zstd:
+  case types::lz4:
+    inquisitive_compressed_container(sv, ir);
+    break;
+  case types::p7z:
+    inquisitive_7z_container(sv, ir);
+    break;
+  case types::rar:
+    inquisitive_rar_container(sv, ir);
+    break;
+  case types::sqlite:
+    inquisitive_sqlite_container(sv, ir);
+    break;
+  case types::pecoff_executable:
+    // self-extracting stub keeps archive within first few MB
+    inquisitive_sfx_container(sv, ir);
+    break;
+  default:
+    break;
+  }
+  if (ir.type() == types::gz) {
+    // mapped prefix is enough input for the first few KB of output
+    inquisitive_gzip_content(mv, ir);
+  }
+  return std::make_optional<inquisitive_result_t>(std::move(ir));
 }
 
 } // namespace inquisitive
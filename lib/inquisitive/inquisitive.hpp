@@ -17,6 +17,7 @@
 #include <mapview.hpp>
 #include <bela/base.hpp>
 #include <bela/endian.hpp>
+#include <bela/pe.hpp>
 #include "types.hpp"
 
 namespace bela {
@@ -57,6 +58,45 @@ bool ArrayEqual(const T *const a, const U *const b, const size_t n) {
 namespace endian {
 enum endian_t : unsigned { None, LittleEndian, BigEndian };
 }
+struct elf_version_t {
+  std::wstring name; /// GLIBC_2.17
+  uint32_t symbols{0}; /// dynamic symbols bound to this version (DT_VERSYM)
+  bool weak{false};
+};
+
+struct elf_version_need_t {
+  std::wstring file; /// libc.so.6
+  std::vector<elf_version_t> versions;
+};
+
+struct elf_compressed_section_t {
+  std::wstring name;
+  std::wstring compression; /// zlib, zstd or GNU .zdebug
+  uint64_t size{0};         /// size in file
+  uint64_t uncompressed{0}; /// ch_size
+};
+
+// section size breakdown, only section header table and section names are read
+struct elf_sections_t {
+  uint64_t text{0};
+  uint64_t rodata{0};
+  uint64_t data{0};
+  uint64_t bss{0}; /// SHT_NOBITS not occupy file
+  uint64_t debug{0};
+  uint64_t relocations{0};
+  uint64_t symbols{0};
+  uint64_t other{0};
+  uint64_t loadfile{0};   /// PT_LOAD p_filesz
+  uint64_t loadmemory{0}; /// PT_LOAD p_memsz
+  uint64_t strippable{0}; /// debug sections and .symtab .strtab which strip can remove
+  std::vector<elf_compressed_section_t> compressed;
+};
+
+enum elf_options_t : uint32_t {
+  ElfDefault = 0,
+  ElfSections = 0x1, /// section size breakdown
+};
+
 struct elf_minutiae_t {
   std::wstring machine;
   std::wstring osabi;
@@ -65,16 +105,132 @@ struct elf_minutiae_t {
   std::wstring rupath;               // RUPATH
   std::wstring soname;               // SONAME
   std::vector<std::wstring> depends; /// require so
+  std::vector<elf_version_need_t> verneeds; /// DT_VERNEED
+  std::vector<std::wstring> verdefs;        /// DT_VERDEF
+  std::wstring glibc;                       /// maximum GLIBC_x.y required, aka minimum glibc
+  std::wstring glibcxx;                     /// maximum GLIBCXX_x required
+  std::optional<elf_sections_t> sections;   /// ElfSections
   int version;
   endian::endian_t endian;
   bool bit64{false}; /// 64 Bit
 };
 
+struct elf_core_file_t {
+  std::wstring path;
+  uint64_t start{0};
+  uint64_t end{0};
+  uint64_t offset{0}; /// file offset of mapping
+};
+
+struct elf_core_auxv_t {
+  uint64_t type{0};
+  uint64_t value{0};
+};
+
+struct elf_core_minutiae_t {
+  std::wstring machine;
+  std::wstring command;               /// NT_PRPSINFO pr_psargs
+  std::vector<elf_core_file_t> files; /// NT_FILE mapped files
+  std::vector<elf_core_auxv_t> auxv;  /// NT_AUXV
+  uint64_t loadsize{0};               /// PT_LOAD segments file size
+  uint64_t notesize{0};
+  uint32_t loads{0};
+  uint32_t threads{0}; /// NT_PRSTATUS count
+  uint32_t pid{0};
+  int signal{0}; /// pr_cursig of first thread
+  endian::endian_t endian{endian::None};
+  bool bit64{false};
+  bool incomplete{false}; /// PT_NOTE segment past end of file was skipped
+};
+
 struct pe_version_t {
   uint16_t major{0};
   uint16_t minor{0};
 };
 
+struct pe_function_t {
+  std::wstring name;   /// empty when imported by ordinal
+  uint16_t hint{0};    /// index into export name pointer table
+  uint16_t ordinal{0}; /// ordinal import
+};
+
+struct pe_import_t {
+  std::wstring dll;
+  std::vector<pe_function_t> functions;
+};
+
+struct pe_export_t {
+  std::wstring name;      /// empty when exported by ordinal only
+  std::wstring forwarder; /// NTDLL.RtlAllocateHeap
+  uint32_t ordinal{0};
+  uint32_t address{0}; /// RVA
+};
+
+struct pe_rich_entry_t {
+  uint16_t product{0}; /// @comp.id high word
+  uint16_t build{0};
+  uint32_t count{0};
+};
+
+// CodeView RSDS, symbol server index is guid without dashes followed by age in hex
+struct pe_pdb_t {
+  std::wstring guid;
+  std::wstring path;
+  uint32_t age{0};
+};
+
+struct pe_pogo_t {
+  std::wstring name; /// .text$mn
+  uint32_t rva{0};
+  uint32_t size{0};
+};
+
+// .NET assembly identity: System.Memory, Version=8.0.0.0, Culture=neutral, PublicKeyToken=...
+struct pe_assembly_t {
+  std::wstring name;
+  std::wstring version;
+  std::wstring culture; /// empty means neutral
+  std::wstring token;   /// public key token in hex, empty means null
+};
+
+struct pe_clr_t {
+  std::wstring runtime;                  /// metadata version string v4.0.30319
+  std::optional<pe_assembly_t> assembly; /// netmodule has no Assembly row
+  std::vector<pe_assembly_t> references; /// AssemblyRef table
+  uint32_t flags{0};                     /// COMIMAGE_FLAGS_*
+  uint32_t typedefs{0};
+  uint32_t methoddefs{0};
+  bool readytorun{false}; /// precompiled by crossgen, ManagedNativeHeader is READYTORUN_HEADER
+  uint16_t r2rmajor{0};
+  uint16_t r2rminor{0};
+};
+
+struct pe_section_t {
+  std::wstring name;
+  uint32_t virtualaddress{0};
+  uint32_t virtualsize{0};
+  uint32_t rawoffset{0};
+  uint32_t rawsize{0};
+  uint32_t characteristics{0};
+  double entropy{0}; /// Shannon entropy of raw data, bits per byte
+};
+
+// data past the last section, Authenticode certificate table at file end is excluded
+struct pe_overlay_t {
+  uint64_t offset{0};
+  uint64_t size{0};
+  double entropy{0};
+};
+
+enum pe_options_t : uint32_t {
+  PeDefault = 0,
+  PeImports = 0x1,   /// imported functions of every DLL
+  PeExports = 0x2,   /// copy every export, name and count are always set
+  PeResources = 0x4, /// version, manifest and icons in resource tree
+  PeClr = 0x8,       /// .NET metadata tables
+  PeSections = 0x10, /// section entropy, overlay and packer heuristics, reads whole file
+};
+
 struct pe_minutiae_t {
   std::wstring machine;
   std::wstring subsystem;
@@ -82,19 +238,245 @@ struct pe_minutiae_t {
   std::vector<std::wstring> characteristics;
   std::vector<std::wstring> depends; /// DLL required
   std::vector<std::wstring> delays;  //
+  std::vector<pe_import_t> imports;      /// PeImports
+  std::vector<pe_import_t> delayimports; /// PeImports
+  std::vector<pe_export_t> exports;      /// PeExports, ordered by ordinal
+  std::wstring exportname;               /// DLL name in export directory
+  uint32_t exportcount{0};               /// used export address table slots, without PeExports too
+  std::optional<bela::pe::VersionInfo> version; /// PeResources RT_VERSION
+  std::wstring manifest;                        /// PeResources RT_MANIFEST
+  uint32_t icons{0};                            /// PeResources RT_GROUP_ICON count
+  std::vector<pe_rich_entry_t> rich;            /// Rich header entries
+  uint32_t richkey{0};                          /// Rich header XOR key (checksum)
+  bool richvalid{false};                        /// Rich header checksum matches
+  std::optional<pe_pdb_t> pdb;                  /// IMAGE_DEBUG_TYPE_CODEVIEW
+  std::vector<pe_pogo_t> pogo;                  /// IMAGE_DEBUG_TYPE_POGO
+  std::wstring reprohash;                       /// IMAGE_DEBUG_TYPE_REPRO
+  bool reproducible{false};                     /// /Brepro, TimeDateStamp is a hash
+  std::optional<pe_clr_t> clr;                  /// PeClr metadata tables
+  std::vector<pe_section_t> sections;           /// PeSections
+  std::optional<pe_overlay_t> overlay;          /// PeSections
+  std::vector<std::wstring> anomalies;          /// PeSections W+X, empty raw data, high entropy
+  std::wstring packer;                          /// PeSections known packer section names
   pe_version_t osver;
   pe_version_t linkver;
   pe_version_t imagever;
   bool isdll;
 };
 
+struct pe_certificate_t {
+  uint64_t offset{0}; /// file offset of WIN_CERTIFICATE
+  uint32_t length{0};
+  uint16_t revision{0};
+  uint16_t type{0}; /// WIN_CERT_TYPE_PKCS_SIGNED_DATA
+};
+
+// Authenticode image digest, checksum, security directory and certificate table are excluded
+struct pe_authenticode_t {
+  std::wstring sha256;
+  std::wstring sha512;
+  std::vector<pe_certificate_t> certificates;
+};
+
+struct pe_authenticode_result_t {
+  std::wstring file;
+  std::optional<pe_authenticode_t> authenticode;
+  bela::error_code ec;
+};
+
+enum macho_options_t : uint32_t {
+  MachODefault = 0,
+  MachOCodeSign = 0x1,    /// decode code signature SuperBlob and CodeDirectory
+  MachOVerifyPages = 0x2, /// hash every code page, reads whole slice
+};
+
+// best CodeDirectory of embedded signature, SHA-384 > SHA-256 > SHA-1
+struct macho_codesign_t {
+  std::wstring identifier;
+  std::wstring teamid;
+  std::wstring hashtype;
+  std::wstring cdhash;              /// digest of CodeDirectory truncated to 20 bytes
+  std::vector<uint32_t> mismatched; /// code pages whose hash does not match
+  uint64_t codelimit{0};            /// signed range of slice
+  uint32_t version{0};
+  uint32_t flags{0};
+  uint32_t pagesize{0}; /// 0 means whole code limit is one page
+  uint32_t codeslots{0};
+  uint32_t specialslots{0};
+  uint32_t codedirectories{0};    /// primary and alternate CodeDirectory count
+  uint32_t entitlementsoffset{0}; /// XML entitlements blob, relative to slice
+  uint32_t entitlementssize{0};
+  bool adhoc{false};
+  bool cms{false};           /// CMS signature blob present
+  bool pagesverified{false}; /// page hashes were checked
+};
+
+struct macho_dylib_t {
+  std::wstring name;
+  std::wstring version;       /// current version X.Y.Z
+  std::wstring compatibility; /// compatibility version X.Y.Z
+};
+
 struct macho_minutiae_t {
   std::wstring machine;
-  std::wstring mtype; /// Mach-O type
+  std::wstring mtype;                     /// Mach-O type
+  std::wstring uuid;                      /// LC_UUID
+  std::wstring platform;                  /// LC_BUILD_VERSION or LC_VERSION_MIN_*
+  std::wstring minos;                     /// minimum OS version
+  std::wstring sdk;                       /// SDK version
+  std::wstring dylibid;                   /// LC_ID_DYLIB install name
+  std::vector<macho_dylib_t> depends;     /// LC_LOAD_DYLIB, re-export, lazy and upward
+  std::vector<macho_dylib_t> weakdepends; /// LC_LOAD_WEAK_DYLIB
+  std::vector<std::wstring> rpaths;       /// LC_RPATH
+  uint32_t cputype{0};
+  uint32_t cpusubtype{0};
+  uint32_t filetype{0};
+  uint32_t flags{0};
+  uint32_t signatureoffset{0}; /// LC_CODE_SIGNATURE dataoff, relative to slice
+  uint32_t signaturesize{0};
+  uint64_t offset{0};                   /// slice offset in universal binary
+  uint64_t size{0};                     /// slice size
+  std::vector<macho_minutiae_t> slices; /// universal binary slices in fat_arch order
+  std::optional<macho_codesign_t> codesign;
+  endian::endian_t endian{endian::LittleEndian};
+  bool signature{false}; /// LC_CODE_SIGNATURE present
   bool isfat{false};
   bool is64abi{false};
 };
 
+enum nested_flags_t : uint32_t {
+  NestedDepthLimit = 0x1,   /// container at max depth is not opened
+  NestedMemberLimit = 0x2,  /// member budget exhausted, member is not classified
+  NestedBomb = 0x4,         /// expansion ratio over cap, member is never decompressed in full
+  NestedMemoryLimit = 0x8,  /// member larger than memory cap, container is not opened
+  NestedDamaged = 0x10,     /// container or member data is corrupt or truncated
+  NestedUnsupported = 0x20, /// compression method or container we cannot decode
+  NestedEncrypted = 0x40,
+  NestedMemoryBudget = 0x80 /// buffers alive across the walk would exceed memory budget
+};
+
+struct nested_options_t {
+  uint32_t depth{8};                     /// containers deeper than this are not opened
+  uint64_t members{1000000};             /// members classified at most in whole tree
+  uint64_t ratio{200};                   /// decompressed size / compressed size cap
+  uint64_t memory{512ull * 1024 * 1024}; /// decompressed bytes held at once by whole walk
+  uint32_t concurrency{0};               /// 0 means hardware concurrency
+};
+
+enum verify_status_t : int {
+  VerifyOk = 0,
+  VerifyCRC,         /// CRC-32 mismatch
+  VerifySize,        /// uncompressed size mismatch
+  VerifyDamaged,     /// header or compressed data is corrupt or truncated
+  VerifyUnsupported, /// compression method we cannot decode
+  VerifyEncrypted
+};
+
+struct verify_member_t {
+  std::wstring name;
+  uint64_t size{0};   /// uncompressed size recorded in archive
+  uint64_t actual{0}; /// bytes decoded
+  uint32_t crc{0};    /// CRC-32 recorded in archive
+  uint32_t computed{0};
+  verify_status_t status{VerifyOk};
+};
+
+struct verify_result_t {
+  std::vector<verify_member_t> failures; /// members failed or skipped, in archive order
+  uint64_t members{0};
+  uint64_t verified{0};
+  uint64_t bytes{0}; /// uncompressed bytes checked
+};
+
+// compressed stream facts from headers, trailers and indexes, nothing is decompressed
+struct compressed_stream_t {
+  std::wstring name;                    /// gzip FNAME
+  std::wstring os;                      /// gzip OS
+  std::wstring check;                   /// xz check, zstd or lz4 content checksum
+  std::optional<uint64_t> uncompressed; /// set only when every stream or frame records its size
+  std::optional<uint32_t> isize;        /// gzip trailer ISIZE when size is not exact, last member
+                                        /// size modulo 2^32
+  uint64_t blocksize{0};                /// bzip2 block size, lz4 maximum block size
+  uint64_t windowsize{0};               /// zstd window size
+  uint64_t blocks{0};                   /// xz index records
+  uint32_t frames{0};                   /// xz streams, zstd or lz4 frames, BGZF blocks
+  uint32_t skippable{0};                /// zstd or lz4 skippable frames
+  uint32_t dictionary{0};               /// zstd or lz4 dictionary ID
+  uint32_t mtime{0};                    /// gzip MTIME, 0 means not recorded
+  types::Type t{types::none};
+  bool damaged{false}; /// trailer, index or frame chain is inconsistent
+};
+
+// 7z property database, files and sizes are known only when header is stored, not compressed
+struct p7z_minutiae_t {
+  std::vector<std::wstring> methods; /// distinct coder chains of folders, such as LZMA2:24 BCJ
+  std::wstring headermethod;         /// coder chain of encoded header, empty when not encoded
+  uint64_t headerpacked{0};          /// packed size of encoded header
+  uint64_t headersize{0};            /// property database size
+  uint64_t files{0};
+  uint64_t directories{0};
+  uint64_t size{0};    /// uncompressed size of all folders
+  uint64_t packed{0};  /// packed streams size
+  uint64_t folders{0}; /// solid blocks
+  uint8_t major{0};
+  uint8_t minor{0};
+  bool encrypted{false}; /// 7zAES in any coder chain
+  bool decoded{false};   /// property database was read
+};
+
+// 7z file, data is read in place only when its folder is a single Copy coder
+struct p7z_entry_t {
+  std::wstring name;
+  uint64_t offset{0}; /// data offset in archive, valid when stored
+  uint64_t size{0};
+  uint64_t packed{0}; /// packed size of folder holding only this file, 0 in solid block
+  bool stored{false};
+  bool encrypted{false};
+};
+
+// RAR archive flags and totals from block headers, nothing is decompressed
+struct rar_minutiae_t {
+  uint64_t offset{0}; /// signature offset, SFX stub comes before it
+  uint64_t files{0};
+  uint64_t directories{0};
+  uint64_t size{0};   /// unpacked size of files with known size
+  uint64_t packed{0}; /// packed size of files
+  uint32_t version{5};
+  bool solid{false};
+  bool volume{false};
+  bool encryptedheaders{false}; /// files and sizes are not readable without password
+  bool locked{false};
+  bool recovery{false};
+  bool damaged{false}; /// header CRC mismatch or block chain runs past end of file
+};
+
+// archive appended to self-extracting executable stub
+struct sfx_archive_t {
+  uint64_t offset{0};
+  types::Type t{types::none}; /// rar, p7z or zip
+};
+
+// sqlite_schema rows of b-tree rooted at page 1, no SQL is run
+struct sqlite_schema_t {
+  std::vector<std::wstring> tables;
+  std::vector<std::wstring> views;
+  uint64_t indexes{0};
+  uint64_t triggers{0};
+  uint32_t pagesize{0};
+  bool truncated{false}; /// page budget exhausted, page missing or row name on overflow page
+};
+
+struct inquisitive_node_t {
+  std::wstring name; /// path inside parent container, file path for root
+  std::wstring description;
+  types::Type t{types::none};
+  types::TypeEx e{types::NONE};
+  uint64_t size{0};       /// uncompressed size
+  uint64_t compressed{0}; /// size stored in parent
+  uint32_t flags{0};      /// nested_flags_t
+  std::vector<inquisitive_node_t> children;
+};
+
 struct inquisitive_attribute_t {
   std::wstring name;
   std::wstring value;
@@ -238,6 +620,7 @@ typedef status_t (*inquisitive_handle_t)(base::MemView mv, inquisitive_result_t
 status_t inquisitive_binobj(base::MemView mv, inquisitive_result_t &ir);
 status_t inquisitive_fonts(base::MemView mv, inquisitive_result_t &ir);
 status_t inquisitive_zip_family(base::MemView mv, inquisitive_result_t &ir);
+status_t inquisitive_zip_container(std::wstring_view sv, inquisitive_result_t &ir);
 status_t inquisitive_docs(base::MemView mv, inquisitive_result_t &ir);
 status_t inquisitive_images(base::MemView mv, inquisitive_result_t &ir);
 status_t inquisitive_archives(base::MemView mv, inquisitive_result_t &ir);
@@ -248,12 +631,95 @@ status_t inquisitive_shlink(base::MemView mv, inquisitive_result_t &ir);
 /////////// ---
 status_t inquisitive_text(base::MemView mv, inquisitive_result_t &ir);
 status_t inquisitive_chardet(base::MemView mv, inquisitive_result_t &ir);
+// run every detector over memory, such as decompressed prefix of archive member
+status_t inquisitive_memview(base::MemView mv, inquisitive_result_t &ir);
+// inflate first few KB of gzip member and detect what is inside
+status_t inquisitive_gzip_content(base::MemView mv, inquisitive_result_t &ir);
+// header, trailer and index facts of gzip, xz, bzip2, zstd and lz4
+status_t inquisitive_compressed_container(std::wstring_view sv, inquisitive_result_t &ir);
+// start header, files, sizes and coders of 7z property database
+status_t inquisitive_7z_container(std::wstring_view sv, inquisitive_result_t &ir,
+                                  uint64_t offset = 0);
+// archive flags, files and sizes of RAR4 or RAR5 block headers
+status_t inquisitive_rar_container(std::wstring_view sv, inquisitive_result_t &ir,
+                                   uint64_t offset = 0);
+// table and view names of SQLite schema
+status_t inquisitive_sqlite_container(std::wstring_view sv, inquisitive_result_t &ir);
+// RAR, 7z or ZIP appended to executable stub
+status_t inquisitive_sfx_container(std::wstring_view sv, inquisitive_result_t &ir);
+// offset of DEFLATE data in gzip member, 0 when header is invalid
+size_t gzip_data_offset(base::MemView mv);
+// original file name (FNAME) in gzip header, empty when absent
+std::string_view gzip_member_name(base::MemView mv);
 
 std::optional<inquisitive_result_t> inquisitive(std::wstring_view sv, bela::error_code &ec);
 
-std::optional<pe_minutiae_t> inquisitive_pecoff(std::wstring_view sv, bela::error_code &ec);
-std::optional<elf_minutiae_t> inquisitive_elf(std::wstring_view sv, bela::error_code &ec);
-std::optional<macho_minutiae_t> inquisitive_macho(std::wstring_view sv, bela::error_code &ec);
+void byte_histogram(const uint8_t *data, size_t size, uint64_t counts[256]);
+double shannon_entropy(const uint64_t counts[256]);
+double shannon_entropy(const uint8_t *data, size_t size);
+
+// byte search, AVX2 or SSE2 is selected at runtime with scalar fallback, same for byte_rsearch
+const uint8_t *byte_search(const uint8_t *haystack, size_t haylen, const void *needle,
+                           size_t neelen);
+// last occurrence, such as zip end of central directory
+const uint8_t *byte_rsearch(const uint8_t *haystack, size_t haylen, const void *needle,
+                            size_t neelen);
+// earliest occurrence of any needle, index of matched needle is stored in which
+const uint8_t *byte_search_any(const uint8_t *haystack, size_t haylen,
+                               const std::string_view *needles, size_t count, size_t &which);
+// strnlen over mapped bytes
+size_t byte_strnlen(const void *p, size_t maxlen);
+// CRC-32 (ISO-HDLC) of ZIP and gzip, PCLMULQDQ or ARMv8 CRC is selected at runtime with
+// slicing-by-8 fallback, pass previous value to continue
+uint32_t byte_crc32(const void *data, size_t len, uint32_t crc = 0);
+
+std::optional<pe_minutiae_t> inquisitive_pecoff(std::wstring_view sv, bela::error_code &ec,
+                                                 uint32_t options = PeDefault);
+// binary search export name table, "#N" looks up ordinal N, only the match is copied
+std::optional<pe_export_t> inquisitive_pe_export(std::wstring_view sv, std::wstring_view name,
+                                                 bela::error_code &ec);
+std::optional<pe_authenticode_t> inquisitive_authenticode(std::wstring_view sv,
+                                                          bela::error_code &ec);
+// hash files concurrently, concurrency 0 means hardware concurrency
+std::vector<pe_authenticode_result_t>
+inquisitive_authenticode(const std::vector<std::wstring> &files, uint32_t concurrency = 0);
+std::optional<elf_minutiae_t> inquisitive_elf(std::wstring_view sv, bela::error_code &ec,
+                                              uint32_t options = ElfDefault);
+std::optional<elf_core_minutiae_t> inquisitive_elfcore(std::wstring_view sv, bela::error_code &ec);
+// universal binary slices and code pages are hashed concurrently, concurrency 0 means hardware
+// concurrency
+std::optional<macho_minutiae_t> inquisitive_macho(std::wstring_view sv, bela::error_code &ec,
+                                                  uint32_t options = MachODefault,
+                                                  uint32_t concurrency = 0);
+// gzip ISIZE, xz index and zstd or lz4 frame content sizes give uncompressed size without
+// decompressing, zstd and lz4 blocks are hopped by their headers
+std::optional<compressed_stream_t> inquisitive_compressed(std::wstring_view sv,
+                                                          bela::error_code &ec);
+// follow 7z start header to property database, encoded header reports its coders and packed
+// size only
+std::optional<p7z_minutiae_t> inquisitive_7z(std::wstring_view sv, bela::error_code &ec,
+                                            uint64_t offset = 0);
+// same over opened view, files are located into entries when it is set and header is decoded
+std::optional<p7z_minutiae_t> inquisitive_7z(base::WindowView &wv, bela::error_code &ec,
+                                            uint64_t offset, std::vector<p7z_entry_t> *entries);
+// walk RAR5 vint headers or RAR4 blocks from signature at offset, data areas are hopped
+std::optional<rar_minutiae_t> inquisitive_rar(std::wstring_view sv, bela::error_code &ec,
+                                              uint64_t offset = 0);
+// walk sqlite_schema b-tree from page 1, only pages of schema are read
+std::optional<sqlite_schema_t> inquisitive_sqlite(std::wstring_view sv, bela::error_code &ec);
+// SQLite header page size, 1 means 65536, 0 when invalid
+uint32_t sqlite_page_size(uint16_t v);
+// search first 4 MB for RAR, 7z and ZIP signatures, a hit counts only when header CRC or ZIP
+// central directory confirms it
+std::optional<sfx_archive_t> sfx_locate(base::WindowView &wv);
+// check CRC-32 of every ZIP member or CRC-32 and ISIZE of every gzip member, ZIP members are
+// checked concurrently, concurrency 0 means hardware concurrency
+std::optional<verify_result_t> inquisitive_verify(std::wstring_view sv, bela::error_code &ec,
+                                                  uint32_t concurrency = 0);
+// open ZIP, TAR, ar, CAB, gzip and stored 7z containers recursively and classify every member,
+// members of outermost container are classified concurrently
+std::optional<inquisitive_node_t> inquisitive_nested(std::wstring_view sv, bela::error_code &ec,
+                                                     const nested_options_t &opts = {});
 } // namespace inquisitive
 
 #endif
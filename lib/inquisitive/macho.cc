@@ -1,4 +1,9 @@
 /// https://lowlevelbits.org/parsing-mach-o-files/
+#include <atomic>
+#include <thread>
+#include <bela/codecvt.hpp>
+#include <bela/hash.hpp>
+#include <bela/strcat.hpp>
 #include "inquisitive.hpp"
 #include "macho.hpp"
 
@@ -8,18 +13,656 @@
 //
 // 2. PARSING MACH-O FILES
 // https://lowlevelbits.org/parsing-mach-o-files/
+//
+// 3. loader.h
+// https://opensource.apple.com/source/xnu/xnu-7195.81.3/EXTERNAL_HEADERS/mach-o/loader.h
+//
+// 4. cs_blobs.h
+// https://opensource.apple.com/source/xnu/xnu-7195.81.3/osfmk/kern/cs_blobs.h
 
 namespace inquisitive {
+
+const wchar_t *macho_machine(uint32_t cputype, uint32_t cpusubtype) {
+  auto subtype = cpusubtype & ~CPU_SUBTYPE_MASK;
+  switch (cputype) {
+  case CPU_TYPE_X86:
+    return L"i386";
+  case CPU_TYPE_X86_64:
+    return subtype == 8 ? L"x86_64h" : L"x86_64";
+  case CPU_TYPE_ARM:
+    switch (subtype) {
+    case CPU_SUBTYPE_ARM_V6:
+      return L"armv6";
+    case CPU_SUBTYPE_ARM_V7:
+      return L"armv7";
+    case CPU_SUBTYPE_ARM_V7S:
+      return L"armv7s";
+    case CPU_SUBTYPE_ARM_V7K:
+      return L"armv7k";
+    default:
+      break;
+    }
+    return L"arm";
+  case CPU_TYPE_ARM64:
+    return subtype == CPU_SUBTYPE_ARM64E ? L"arm64e" : L"arm64";
+  case CPU_TYPE_ARM64_32:
+    return L"arm64_32";
+  case CPU_TYPE_POWERPC:
+    return L"ppc";
+  case CPU_TYPE_POWERPC64:
+    return L"ppc64";
+  case CPU_TYPE_MC680x0:
+    return L"m68k";
+  case CPU_TYPE_SPARC:
+    return L"sparc";
+  case CPU_TYPE_HPPA:
+    return L"hppa";
+  case CPU_TYPE_I860:
+    return L"i860";
+  default:
+    break;
+  }
+  return L"unknown";
+}
+
+const wchar_t *macho_filetype(uint32_t filetype) {
+  switch (filetype) {
+  case MH_OBJECT:
+    return L"Object";
+  case MH_EXECUTE:
+    return L"Executable";
+  case MH_FVMLIB:
+    return L"Fixed VM Shared Library";
+  case MH_CORE:
+    return L"Core";
+  case MH_PRELOAD:
+    return L"Preloaded Executable";
+  case MH_DYLIB:
+    return L"Dynamic Library";
+  case MH_DYLINKER:
+    return L"Dynamic Linker";
+  case MH_BUNDLE:
+    return L"Bundle";
+  case MH_DYLIB_STUB:
+    return L"Dynamic Library Stub";
+  case MH_DSYM:
+    return L"dSYM Companion";
+  case MH_KEXT_BUNDLE:
+    return L"Kext Bundle";
+  default:
+    break;
+  }
+  return L"Unknown";
+}
+
+const wchar_t *macho_platform(uint32_t platform) {
+  switch (platform) {
+  case PLATFORM_MACOS:
+    return L"macOS";
+  case PLATFORM_IOS:
+    return L"iOS";
+  case PLATFORM_TVOS:
+    return L"tvOS";
+  case PLATFORM_WATCHOS:
+    return L"watchOS";
+  case PLATFORM_BRIDGEOS:
+    return L"bridgeOS";
+  case PLATFORM_MACCATALYST:
+    return L"Mac Catalyst";
+  case PLATFORM_IOSSIMULATOR:
+    return L"iOS Simulator";
+  case PLATFORM_TVOSSIMULATOR:
+    return L"tvOS Simulator";
+  case PLATFORM_WATCHOSSIMULATOR:
+    return L"watchOS Simulator";
+  case PLATFORM_DRIVERKIT:
+    return L"DriverKit";
+  case PLATFORM_VISIONOS:
+    return L"visionOS";
+  case PLATFORM_VISIONOSSIMULATOR:
+    return L"visionOS Simulator";
+  default:
+    break;
+  }
+  return L"unknown";
+}
+
+// X.Y.Z is encoded in nibbles xxxx.yy.zz
+inline std::wstring macho_version(uint32_t v) {
+  return bela::StringCat(v >> 16, L".", (v >> 8) & 0xFF, L".", v & 0xFF);
+}
+
+// items are claimed from an atomic index, concurrency 0 means hardware concurrency
+template <typename Fn> void macho_parallel(size_t n, uint32_t concurrency, Fn fn) {
+  if (concurrency == 0) {
+    concurrency = (std::max)(std::thread::hardware_concurrency(), 1u);
+  }
+  concurrency = static_cast<uint32_t>((std::min)(static_cast<size_t>(concurrency), n));
+  std::atomic_size_t next{0};
+  auto worker = [&]() {
+    for (auto i = next++; i < n; i = next++) {
+      fn(i);
+    }
+  };
+  if (concurrency <= 1) {
+    worker();
+    return;
+  }
+  std::vector<std::thread> workers;
+  workers.reserve(concurrency);
+  for (uint32_t i = 0; i < concurrency; i++) {
+    workers.emplace_back(worker);
+  }
+  for (auto &w : workers) {
+    w.join();
+  }
+}
+
+const wchar_t *macho_cs_hashtype(uint8_t hashtype) {
+  switch (hashtype) {
+  case CS_HASHTYPE_SHA1:
+    return L"SHA-1";
+  case CS_HASHTYPE_SHA256:
+    return L"SHA-256";
+  case CS_HASHTYPE_SHA256_TRUNCATED:
+    return L"SHA-256 (truncated)";
+  case CS_HASHTYPE_SHA384:
+    return L"SHA-384";
+  default:
+    break;
+  }
+  return L"unknown";
+}
+
+// codesign prefers the strongest CodeDirectory, 0 means unsupported
+inline int macho_cs_rank(uint8_t hashtype) {
+  switch (hashtype) {
+  case CS_HASHTYPE_SHA1:
+    return 1;
+  case CS_HASHTYPE_SHA256_TRUNCATED:
+    return 2;
+  case CS_HASHTYPE_SHA256:
+    return 3;
+  case CS_HASHTYPE_SHA384:
+    return 4;
+  default:
+    break;
+  }
+  return 0;
+}
+
+// out must hold CS_HASH_MAX_SIZE bytes, returns digest size or 0 when hash type is unsupported
+size_t macho_cs_hash(uint8_t hashtype, const uint8_t *data, size_t size, uint8_t *out) {
+  switch (hashtype) {
+  case CS_HASHTYPE_SHA1: {
+    bela::hash::sha1::Hasher h;
+    h.Initialize();
+    h.Update(data, size);
+    h.Finalize(out, bela::hash::sha1::sha1_hash_size);
+    return bela::hash::sha1::sha1_hash_size;
+  }
+  case CS_HASHTYPE_SHA256:
+  case CS_HASHTYPE_SHA256_TRUNCATED: {
+    bela::hash::sha256::Hasher h;
+    h.Initialize();
+    h.Update(data, size);
+    h.Finalize(out, bela::hash::sha256::sha256_hash_size);
+    return bela::hash::sha256::sha256_hash_size;
+  }
+  case CS_HASHTYPE_SHA384: {
+    bela::hash::sha512::Hasher h;
+    h.Initialize(bela::hash::sha512::HashBits::SHA384);
+    h.Update(data, size);
+    h.Finalize(out, bela::hash::sha512::sha384_hash_size);
+    return bela::hash::sha512::sha384_hash_size;
+  }
+  default:
+    break;
+  }
+  return 0;
+}
+
+// union lc_str holds a pointer on LLP64 Windows, load commands with strings are read by offset
+constexpr size_t dylib_name_offset = 8;
+constexpr size_t dylib_current_version = 16;
+constexpr size_t dylib_compatibility_version = 20;
+constexpr size_t rpath_path_offset = 8;
+
 class macho_memview {
 public:
+  macho_memview(base::MemView mv, uint32_t options, uint32_t concurrency)
+      : mv_(mv), options_(options), concurrency_(concurrency) {}
+  bool inquisitive(macho_minutiae_t &mm, bela::error_code &ec);
+
 private:
+  base::MemView mv_;
+  uint32_t options_{MachODefault};
+  uint32_t concurrency_{0};
+  bool resiveable{false};
+  template <typename Integer> Integer resive(Integer i) const {
+    if (!resiveable) {
+      return i;
+    }
+    return bela::bswap(i);
+  }
+  uint32_t read32(const uint8_t *p) const { return resive(bela::unalignedloadT<uint32_t>(p)); }
+  std::wstring lcstring(const uint8_t *lc, uint32_t cmdsize, size_t field) const;
+  void dylib_resolve(const uint8_t *lc, uint32_t cmdsize, std::vector<macho_dylib_t> &dylibs);
+  template <typename Header> bool load_commands(macho_minutiae_t &mm, bela::error_code &ec);
+  bool header_resolve(macho_minutiae_t &mm, bela::error_code &ec);
+  bool code_signature(macho_minutiae_t &mm, bela::error_code &ec);
+  void code_directory(const CS_CodeDirectory *cd, uint32_t size, macho_codesign_t &cs);
+  bool verify_pages(const CS_CodeDirectory *cd, uint32_t size, macho_codesign_t &cs,
+                    bela::error_code &ec);
 };
 
-std::optional<macho_minutiae_t> inquisitive_macho(std::wstring_view sv, bela::error_code &ec) {
-  //
-  return std::nullopt;
+// string is stored after load command structure, offset is from start of load command
+std::wstring macho_memview::lcstring(const uint8_t *lc, uint32_t cmdsize, size_t field) const {
+  if (field + 4 > cmdsize) {
+    return L"";
+  }
+  auto off = read32(lc + field);
+  if (off >= cmdsize) {
+    return L"";
+  }
+  auto s = reinterpret_cast<const char *>(lc + off);
+  return bela::ToWide(std::string_view(s, byte_strnlen(s, cmdsize - off)));
 }
 
-} // namespace inquisitive
+void macho_memview::dylib_resolve(const uint8_t *lc, uint32_t cmdsize,
+                                  std::vector<macho_dylib_t> &dylibs) {
+  if (cmdsize < dylib_compatibility_version + 4) {
+    return;
+  }
+  dylibs.emplace_back(macho_dylib_t{lcstring(lc, cmdsize, dylib_name_offset),
+                                    macho_version(read32(lc + dylib_current_version)),
+                                    macho_version(read32(lc + dylib_compatibility_version))});
+}
+
+template <typename Header>
+bool macho_memview::load_commands(macho_minutiae_t &mm, bela::error_code &ec) {
+  auto h = mv_.cast<Header>(0);
+  if (h == nullptr) {
+    ec = bela::make_error_code(L"Mach-O header size too small");
+    return false;
+  }
+  mm.cputype = resive(h->cputype);
+  mm.cpusubtype = resive(h->cpusubtype);
+  mm.filetype = resive(h->filetype);
+  mm.flags = resive(h->flags);
+  mm.machine = macho_machine(mm.cputype, mm.cpusubtype);
+  mm.mtype = macho_filetype(mm.filetype);
+  uint64_t ncmds = resive(h->ncmds);
+  uint64_t sizeofcmds = resive(h->sizeofcmds);
+  if (sizeofcmds > mv_.size() - sizeof(Header)) {
+    ec = bela::make_error_code(L"Mach-O load commands out of file range");
+    return false;
+  }
+  // load commands are walked in place, only strings are copied
+  auto p = mv_.data() + sizeof(Header);
+  auto end = p + sizeofcmds;
+  for (uint64_t i = 0; i < ncmds && end - p >= 8; i++) {
+    auto cmd = read32(p);
+    auto cmdsize = read32(p + 4);
+    if (cmdsize < 8 || cmdsize > static_cast<size_t>(end - p)) {
+      ec = bela::make_error_code(L"Mach-O load command size invalid");
+      return false;
+    }
+    switch (cmd) {
+    case LC_LOAD_DYLIB:
+    case LC_REEXPORT_DYLIB:
+    case LC_LAZY_LOAD_DYLIB:
+    case LC_LOAD_UPWARD_DYLIB:
+      dylib_resolve(p, cmdsize, mm.depends);
+      break;
+    case LC_LOAD_WEAK_DYLIB:
+      dylib_resolve(p, cmdsize, mm.weakdepends);
+      break;
+    case LC_ID_DYLIB:
+      mm.dylibid = lcstring(p, cmdsize, dylib_name_offset);
+      break;
+    case LC_RPATH:
+      mm.rpaths.emplace_back(lcstring(p, cmdsize, rpath_path_offset));
+      break;
+    case LC_UUID:
+      if (cmdsize >= sizeof(uuid_command)) {
+        constexpr const wchar_t hex[] = L"0123456789ABCDEF";
+        auto u = reinterpret_cast<const uuid_command *>(p)->uuid;
+        mm.uuid.clear();
+        for (size_t j = 0; j < 16; j++) {
+          if (j == 4 || j == 6 || j == 8 || j == 10) {
+            mm.uuid.push_back(L'-');
+          }
+          mm.uuid.push_back(hex[u[j] >> 4]);
+          mm.uuid.push_back(hex[u[j] & 0xF]);
+        }
+      }
+      break;
+    case LC_BUILD_VERSION:
+      if (cmdsize >= sizeof(build_version_command)) {
+        auto bv = reinterpret_cast<const build_version_command *>(p);
+        mm.platform = macho_platform(resive(bv->platform));
+        mm.minos = macho_version(resive(bv->minos));
+        mm.sdk = macho_version(resive(bv->sdk));
+      }
+      break;
+    case LC_VERSION_MIN_MACOSX:
+    case LC_VERSION_MIN_IPHONEOS:
+    case LC_VERSION_MIN_TVOS:
+    case LC_VERSION_MIN_WATCHOS:
+      // LC_BUILD_VERSION supersedes, old linkers emit only this
+      if (cmdsize >= sizeof(version_min_command) && mm.platform.empty()) {
+        auto vm = reinterpret_cast<const version_min_command *>(p);
+        mm.platform = macho_platform(cmd == LC_VERSION_MIN_MACOSX     ? PLATFORM_MACOS
+                                     : cmd == LC_VERSION_MIN_IPHONEOS ? PLATFORM_IOS
+                                     : cmd == LC_VERSION_MIN_TVOS     ? PLATFORM_TVOS
+                                                                      : PLATFORM_WATCHOS);
+        mm.minos = macho_version(resive(vm->version));
+        mm.sdk = macho_version(resive(vm->sdk));
+      }
+      break;
+    case LC_CODE_SIGNATURE:
+      if (cmdsize >= sizeof(linkedit_data_command)) {
+        auto ld = reinterpret_cast<const linkedit_data_command *>(p);
+        mm.signature = true;
+        mm.signatureoffset = resive(ld->dataoff);
+        mm.signaturesize = resive(ld->datasize);
+      }
+      break;
+    default:
+      break;
+    }
+    p += cmdsize;
+  }
+  return true;
+}
+
+void macho_memview::code_directory(const CS_CodeDirectory *cd, uint32_t size,
+                                   macho_codesign_t &cs) {
+  auto p = reinterpret_cast<const uint8_t *>(cd);
+  auto cstring = [&](uint32_t off) -> std::wstring {
+    if (off == 0 || off >= size) {
+      return L"";
+    }
+    auto s = reinterpret_cast<const char *>(p + off);
+    return bela::ToWide(std::string_view(s, byte_strnlen(s, size - off)));
+  };
+  cs.version = bela::swapbe(cd->version);
+  cs.flags = bela::swapbe(cd->flags);
+  cs.hashtype = macho_cs_hashtype(cd->hashType);
+  cs.pagesize = (cd->pageSize == 0 || cd->pageSize >= 32) ? 0 : (1u << cd->pageSize);
+  cs.codeslots = bela::swapbe(cd->nCodeSlots);
+  cs.specialslots = bela::swapbe(cd->nSpecialSlots);
+  cs.codelimit = bela::swapbe(cd->codeLimit);
+  if (cs.version >= CS_SUPPORTSCODELIMIT64 &&
+      size >= offsetof(CS_CodeDirectory, codeLimit64) + sizeof(uint64_t) &&
+      cd->codeLimit64 != 0) {
+    cs.codelimit = bela::swapbe(cd->codeLimit64);
+  }
+  cs.identifier = cstring(bela::swapbe(cd->identOffset));
+  if (cs.version >= CS_SUPPORTSTEAMID &&
+      size >= offsetof(CS_CodeDirectory, teamOffset) + sizeof(uint32_t)) {
+    cs.teamid = cstring(bela::swapbe(cd->teamOffset));
+  }
+  cs.adhoc = (cs.flags & CS_ADHOC) != 0;
+  // CDHash is the digest of the whole CodeDirectory blob
+  uint8_t digest[CS_HASH_MAX_SIZE];
+  if (macho_cs_hash(cd->hashType, p, size, digest) >= CS_CDHASH_LEN) {
+    bela::hash::HashEncode(digest, CS_CDHASH_LEN, cs.cdhash);
+  }
+}
+
+// code page i covers [i * pagesize, min((i + 1) * pagesize, codelimit)) of slice
+bool macho_memview::verify_pages(const CS_CodeDirectory *cd, uint32_t size, macho_codesign_t &cs,
+                                 bela::error_code &ec) {
+  uint64_t hashsize = cd->hashSize;
+  uint64_t hashoffset = bela::swapbe(cd->hashOffset);
+  if (hashsize == 0 || hashsize > CS_HASH_MAX_SIZE || hashoffset > size ||
+      cs.codeslots > (size - hashoffset) / hashsize) {
+    ec = bela::make_error_code(L"Mach-O CodeDirectory hash slots out of range");
+    return false;
+  }
+  if (cs.codelimit > mv_.size()) {
+    ec = bela::make_error_code(L"Mach-O code limit out of file range");
+    return false;
+  }
+  uint64_t pagesize = cs.pagesize == 0 ? cs.codelimit : cs.pagesize;
+  if (cs.codeslots != 0 && pagesize == 0) {
+    ec = bela::make_error_code(L"Mach-O CodeDirectory page size invalid");
+    return false;
+  }
+  auto hashes = reinterpret_cast<const uint8_t *>(cd) + hashoffset;
+  auto hashtype = cd->hashType;
+  std::vector<uint8_t> bad(cs.codeslots, 0);
+  macho_parallel(cs.codeslots, concurrency_, [&](size_t i) {
+    uint64_t begin = i * pagesize;
+    uint8_t digest[CS_HASH_MAX_SIZE];
+    if (begin >= cs.codelimit) {
+      bad[i] = 1;
+      return;
+    }
+    auto len = static_cast<size_t>((std::min)(pagesize, cs.codelimit - begin));
+    if (macho_cs_hash(hashtype, mv_.data() + begin, len, digest) < hashsize ||
+        memcmp(digest, hashes + i * hashsize, static_cast<size_t>(hashsize)) != 0) {
+      bad[i] = 1;
+    }
+  });
+  for (size_t i = 0; i < bad.size(); i++) {
+    if (bad[i] != 0) {
+      cs.mismatched.emplace_back(static_cast<uint32_t>(i));
+    }
+  }
+  cs.pagesverified = true;
+  return true;
+}
+
+bool macho_memview::code_signature(macho_minutiae_t &mm, bela::error_code &ec) {
+  if (mm.signatureoffset > mv_.size() || mm.signaturesize > mv_.size() - mm.signatureoffset ||
+      mm.signaturesize < sizeof(CS_SuperBlob)) {
+    ec = bela::make_error_code(L"Mach-O code signature out of file range");
+    return false;
+  }
+  auto sb = mv_.data() + mm.signatureoffset;
+  if (bela::readbe<uint32_t>(sb) != CSMAGIC_EMBEDDED_SIGNATURE) {
+    ec = bela::make_error_code(L"Mach-O code signature is not embedded SuperBlob");
+    return false;
+  }
+  uint64_t length = (std::min)(bela::readbe<uint32_t>(sb + 4), mm.signaturesize);
+  uint64_t count = bela::readbe<uint32_t>(sb + 8);
+  if (length < sizeof(CS_SuperBlob) ||
+      count > (length - sizeof(CS_SuperBlob)) / sizeof(CS_BlobIndex)) {
+    ec = bela::make_error_code(L"Mach-O code signature blob index out of range");
+    return false;
+  }
+  macho_codesign_t cs;
+  const CS_CodeDirectory *best = nullptr;
+  uint32_t bestsize = 0;
+  for (uint64_t i = 0; i < count; i++) {
+    auto bi = sb + sizeof(CS_SuperBlob) + i * sizeof(CS_BlobIndex);
+    auto type = bela::readbe<uint32_t>(bi);
+    uint64_t off = bela::readbe<uint32_t>(bi + 4);
+    if (off > length || length - off < 8) {
+      continue;
+    }
+    auto blob = sb + off;
+    auto magic = bela::readbe<uint32_t>(blob);
+    auto bloblen = bela::readbe<uint32_t>(blob + 4);
+    if (bloblen < 8 || bloblen > length - off) {
+      continue;
+    }
+    if (type == CSSLOT_ENTITLEMENTS && magic == CSMAGIC_EMBEDDED_ENTITLEMENTS) {
+      cs.entitlementsoffset = static_cast<uint32_t>(mm.signatureoffset + off);
+      cs.entitlementssize = bloblen;
+      continue;
+    }
+    if (type == CSSLOT_SIGNATURESLOT && magic == CSMAGIC_BLOBWRAPPER) {
+      // ad hoc signatures carry an empty wrapper
+      cs.cms = bloblen > 8;
+      continue;
+    }
+    if (type != CSSLOT_CODEDIRECTORY &&
+        (type < CSSLOT_ALTERNATE_CODEDIRECTORIES ||
+         type >= CSSLOT_ALTERNATE_CODEDIRECTORIES + CSSLOT_ALTERNATE_CODEDIRECTORY_MAX)) {
+      continue;
+    }
+    if (magic != CSMAGIC_CODEDIRECTORY ||
+        bloblen < offsetof(CS_CodeDirectory, scatterOffset)) {
+      continue;
+    }
+    cs.codedirectories++;
+    auto cd = reinterpret_cast<const CS_CodeDirectory *>(blob);
+    if (macho_cs_rank(cd->hashType) > (best == nullptr ? 0 : macho_cs_rank(best->hashType))) {
+      best = cd;
+      bestsize = bloblen;
+    }
+  }
+  if (best == nullptr) {
+    ec = bela::make_error_code(L"Mach-O code signature has no supported CodeDirectory");
+    return false;
+  }
+  code_directory(best, bestsize, cs);
+  if ((options_ & MachOVerifyPages) != 0 && !verify_pages(best, bestsize, cs, ec)) {
+    return false;
+  }
+  mm.codesign = std::make_optional<macho_codesign_t>(std::move(cs));
+  return true;
+}
+
+bool macho_memview::inquisitive(macho_minutiae_t &mm, bela::error_code &ec) {
+  if (!header_resolve(mm, ec)) {
+    return false;
+  }
+  if (!mm.signature || (options_ & (MachOCodeSign | MachOVerifyPages)) == 0) {
+    return true;
+  }
+  return code_signature(mm, ec);
+}
 
-// No more plans to parse Mach-O file details
\ No newline at end of file
+bool macho_memview::header_resolve(macho_minutiae_t &mm, bela::error_code &ec) {
+  if (mv_.size() < sizeof(mach_header)) {
+    ec = bela::make_error_code(L"Mach-O file size too small");
+    return false;
+  }
+  // magic in host order, CIGAM means file byte order is different from host
+  auto magic = bela::unalignedloadT<uint32_t>(mv_.data());
+  switch (magic) {
+  case MH_MAGIC:
+    mm.endian = bela::IsBigEndianHost ? endian::BigEndian : endian::LittleEndian;
+    return load_commands<mach_header>(mm, ec);
+  case MH_MAGIC_64:
+    mm.is64abi = true;
+    mm.endian = bela::IsBigEndianHost ? endian::BigEndian : endian::LittleEndian;
+    return load_commands<mach_header_64>(mm, ec);
+  case MH_CIGAM:
+    resiveable = true;
+    mm.endian = bela::IsBigEndianHost ? endian::LittleEndian : endian::BigEndian;
+    return load_commands<mach_header>(mm, ec);
+  case MH_CIGAM_64:
+    resiveable = true;
+    mm.is64abi = true;
+    mm.endian = bela::IsBigEndianHost ? endian::LittleEndian : endian::BigEndian;
+    return load_commands<mach_header_64>(mm, ec);
+  default:
+    break;
+  }
+  ec = bela::make_error_code(L"not Mach-O file");
+  return false;
+}
+
+struct macho_fat_arch_t {
+  uint64_t offset{0};
+  uint64_t size{0};
+};
+
+// fat headers are always big-endian
+bool macho_fat_archs(base::MemView mv, std::vector<macho_fat_arch_t> &archs, bela::error_code &ec) {
+  auto magic = bela::readbe<uint32_t>(mv.data());
+  uint64_t narchs = bela::readbe<uint32_t>(mv.data() + 4);
+  auto archsize = magic == FAT_MAGIC_64 ? sizeof(fat_arch_64) : sizeof(fat_arch);
+  if (narchs == 0 || narchs > (mv.size() - sizeof(fat_header)) / archsize) {
+    ec = bela::make_error_code(L"Mach-O universal binary architectures out of file range");
+    return false;
+  }
+  archs.resize(static_cast<size_t>(narchs));
+  for (size_t i = 0; i < archs.size(); i++) {
+    auto p = mv.data() + sizeof(fat_header) + i * archsize;
+    auto &a = archs[i];
+    if (magic == FAT_MAGIC_64) {
+      auto fa = reinterpret_cast<const fat_arch_64 *>(p);
+      a.offset = bela::swapbe(fa->offset);
+      a.size = bela::swapbe(fa->size);
+    } else {
+      auto fa = reinterpret_cast<const fat_arch *>(p);
+      a.offset = bela::swapbe(fa->offset);
+      a.size = bela::swapbe(fa->size);
+    }
+    if (a.offset > mv.size() || a.size > mv.size() - a.offset) {
+      ec = bela::make_error_code(L"Mach-O universal binary slice out of file range");
+      return false;
+    }
+  }
+  return true;
+}
+
+// slices are parsed concurrently over the same mapping, results are stored in fat_arch order,
+// thread budget is split across slices so page hashing does not run slices x concurrency threads
+bool macho_fat_resolve(base::MemView mv, const std::vector<macho_fat_arch_t> &archs,
+                       uint32_t options, uint32_t concurrency,
+                       std::vector<macho_minutiae_t> &slices, bela::error_code &ec) {
+  slices.resize(archs.size());
+  std::vector<bela::error_code> ecs(archs.size());
+  if (concurrency == 0) {
+    concurrency = (std::max)(std::thread::hardware_concurrency(), 1u);
+  }
+  auto perslice = (std::max)(concurrency / static_cast<uint32_t>(archs.size()), 1u);
+  macho_parallel(archs.size(), concurrency, [&](size_t i) {
+    auto &s = slices[i];
+    s.offset = archs[i].offset;
+    s.size = archs[i].size;
+    macho_memview smv(
+        base::MemView(mv.data() + archs[i].offset, static_cast<size_t>(archs[i].size)), options,
+        perslice);
+    smv.inquisitive(s, ecs[i]);
+  });
+  for (size_t i = 0; i < ecs.size(); i++) {
+    if (ecs[i]) {
+      ec = bela::make_error_code(ecs[i].code, L"slice ", i, L": ", ecs[i].message);
+      return false;
+    }
+  }
+  return true;
+}
+
+std::optional<macho_minutiae_t> inquisitive_macho(std::wstring_view sv, bela::error_code &ec,
+                                                  uint32_t options, uint32_t concurrency) {
+  base::MapView mv;
+  if (!mv.MappingView(sv, ec, sizeof(mach_header))) {
+    return std::nullopt;
+  }
+  auto mmv = mv.subview();
+  auto magic = bela::readbe<uint32_t>(mmv.data());
+  if (magic != FAT_MAGIC && magic != FAT_MAGIC_64) {
+    macho_minutiae_t mm;
+    macho_memview mvv(mmv, options, concurrency);
+    if (!mvv.inquisitive(mm, ec)) {
+      return std::nullopt;
+    }
+    mm.size = mmv.size();
+    return std::make_optional<macho_minutiae_t>(std::move(mm));
+  }
+  std::vector<macho_fat_arch_t> archs;
+  std::vector<macho_minutiae_t> slices;
+  if (!macho_fat_archs(mmv, archs, ec) ||
+      !macho_fat_resolve(mmv, archs, options, concurrency, slices, ec)) {
+    return std::nullopt;
+  }
+  // top level fields come from first slice, as lipo lists it first
+  macho_minutiae_t mm = slices[0];
+  mm.isfat = true;
+  mm.offset = 0;
+  mm.size = mmv.size();
+  mm.slices = std::move(slices);
+  return std::make_optional<macho_minutiae_t>(std::move(mm));
+}
+
+} // namespace inquisitive
@@ -103,6 +103,8 @@ typedef uint32_t cpu_threadtype_t;
 #define CPU_TYPE_HPPA ((cpu_type_t)11)
 #define CPU_TYPE_ARM ((cpu_type_t)12)
 #define CPU_TYPE_ARM64 (CPU_TYPE_ARM | CPU_ARCH_ABI64)
+#define CPU_ARCH_ABI64_32 0x02000000 /* ABI for 64-bit hardware with 32-bit types; LP32 */
+#define CPU_TYPE_ARM64_32 (CPU_TYPE_ARM | CPU_ARCH_ABI64_32)
 #define CPU_TYPE_MC88000 ((cpu_type_t)13)
 #define CPU_TYPE_SPARC ((cpu_type_t)14)
 #define CPU_TYPE_I860 ((cpu_type_t)15)
@@ -301,6 +303,20 @@ typedef uint32_t cpu_threadtype_t;
 #define CPU_SUBTYPE_ARM_V5TEJ ((cpu_subtype_t)7)
 #define CPU_SUBTYPE_ARM_XSCALE ((cpu_subtype_t)8)
 #define CPU_SUBTYPE_ARM_V7 ((cpu_subtype_t)9)
+#define CPU_SUBTYPE_ARM_V7F ((cpu_subtype_t)10)  /* Cortex A9 */
+#define CPU_SUBTYPE_ARM_V7S ((cpu_subtype_t)11)  /* Swift */
+#define CPU_SUBTYPE_ARM_V7K ((cpu_subtype_t)12)
+#define CPU_SUBTYPE_ARM_V8 ((cpu_subtype_t)13)
+#define CPU_SUBTYPE_ARM_V6M ((cpu_subtype_t)14)  /* Not meant to be run under xnu */
+#define CPU_SUBTYPE_ARM_V7M ((cpu_subtype_t)15)  /* Not meant to be run under xnu */
+#define CPU_SUBTYPE_ARM_V7EM ((cpu_subtype_t)16) /* Not meant to be run under xnu */
+
+/*
+ *  ARM64 subtypes
+ */
+#define CPU_SUBTYPE_ARM64_ALL ((cpu_subtype_t)0)
+#define CPU_SUBTYPE_ARM64_V8 ((cpu_subtype_t)1)
+#define CPU_SUBTYPE_ARM64E ((cpu_subtype_t)2)
 
 /*
  *	CPU families (sysctl hw.cpufamily)
@@ -425,6 +441,22 @@ struct fat_arch {
   uint32_t align;           /* alignment as a power of 2 */
 };
 
+/*
+ * The support for the 64-bit fat file format described here is a work in
+ * progress and not yet fully supported in all the Apple Developer Tools.
+ */
+#define FAT_MAGIC_64 0xcafebabf
+#define FAT_CIGAM_64 0xbfbafeca /* NXSwapLong(FAT_MAGIC_64) */
+
+struct fat_arch_64 {
+  cpu_type_t cputype;       /* cpu specifier (int) */
+  cpu_subtype_t cpusubtype; /* machine specifier (int) */
+  uint64_t offset;          /* file offset to this object file */
+  uint64_t size;            /* size of this object file */
+  uint32_t align;           /* alignment as a power of 2 */
+  uint32_t reserved;        /* reserved */
+};
+
 /*
  * <machine/thread_status.h> is expected to define the flavors of the thread
  * states and the structures of those flavors for each machine.
@@ -682,6 +714,15 @@ struct load_command {
 #define LC_DATA_IN_CODE 0x29         /* table of non-instructions in __text */
 #define LC_SOURCE_VERSION 0x2A       /* source version used to build binary */
 #define LC_DYLIB_CODE_SIGN_DRS 0x2B  /* Code signing DRs copied from linked dylibs */
+#define LC_ENCRYPTION_INFO_64 0x2C   /* 64-bit encrypted segment information */
+#define LC_LINKER_OPTION 0x2D        /* linker options in MH_OBJECT files */
+#define LC_LINKER_OPTIMIZATION_HINT 0x2E /* optimization hints in MH_OBJECT files */
+#define LC_VERSION_MIN_TVOS 0x2F     /* build for AppleTV min OS version */
+#define LC_VERSION_MIN_WATCHOS 0x30  /* build for Watch min OS version */
+#define LC_NOTE 0x31                 /* arbitrary data included within a Mach-O file */
+#define LC_BUILD_VERSION 0x32        /* build for platform min OS version */
+#define LC_DYLD_EXPORTS_TRIE (0x33 | LC_REQ_DYLD)   /* payload is trie */
+#define LC_DYLD_CHAINED_FIXUPS (0x34 | LC_REQ_DYLD) /* chained fixups */
 
 /*
  * A variable length string in a load command is represented by an lc_str
@@ -1561,6 +1602,45 @@ struct version_min_command {
   uint32_t sdk;     /* X.Y.Z is encoded in nibbles xxxx.yy.zz */
 };
 
+/*
+ * The build_version_command contains the min OS version on which this
+ * binary was built to run for its platform.  The list of known platforms and
+ * tool values following it.
+ */
+struct build_version_command {
+  uint32_t cmd;      /* LC_BUILD_VERSION */
+  uint32_t cmdsize;  /* sizeof(struct build_version_command) plus */
+                     /* ntools * sizeof(struct build_tool_version) */
+  uint32_t platform; /* platform */
+  uint32_t minos;    /* X.Y.Z is encoded in nibbles xxxx.yy.zz */
+  uint32_t sdk;      /* X.Y.Z is encoded in nibbles xxxx.yy.zz */
+  uint32_t ntools;   /* number of tool entries following this */
+};
+
+struct build_tool_version {
+  uint32_t tool;    /* enum for the tool */
+  uint32_t version; /* version number of the tool */
+};
+
+/* Known values for the platform field above. */
+#define PLATFORM_MACOS 1
+#define PLATFORM_IOS 2
+#define PLATFORM_TVOS 3
+#define PLATFORM_WATCHOS 4
+#define PLATFORM_BRIDGEOS 5
+#define PLATFORM_MACCATALYST 6
+#define PLATFORM_IOSSIMULATOR 7
+#define PLATFORM_TVOSSIMULATOR 8
+#define PLATFORM_WATCHOSSIMULATOR 9
+#define PLATFORM_DRIVERKIT 10
+#define PLATFORM_VISIONOS 11
+#define PLATFORM_VISIONOSSIMULATOR 12
+
+/* Known values for the tool field above. */
+#define TOOL_CLANG 1
+#define TOOL_SWIFT 2
+#define TOOL_LD 3
+
 /*
  * The dyld_info_command contains the file offsets and sizes of
  * the new compressed form of the information dyld needs to
@@ -1822,4 +1902,82 @@ struct tlv_descriptor {
   unsigned long offset;
 };
 
+
+/*
+ * Code signing blobs, see xnu osfmk/kern/cs_blobs.h. All fields of code signing
+ * structures are big-endian regardless of the Mach-O byte order.
+ */
+#define CSMAGIC_REQUIREMENTS 0xfade0c01              /* requirements vector */
+#define CSMAGIC_CODEDIRECTORY 0xfade0c02             /* CodeDirectory blob */
+#define CSMAGIC_EMBEDDED_SIGNATURE 0xfade0cc0        /* embedded SuperBlob */
+#define CSMAGIC_EMBEDDED_ENTITLEMENTS 0xfade7171     /* XML entitlements */
+#define CSMAGIC_EMBEDDED_DER_ENTITLEMENTS 0xfade7172 /* DER entitlements */
+#define CSMAGIC_BLOBWRAPPER 0xfade0b01               /* CMS signature */
+
+#define CSSLOT_CODEDIRECTORY 0
+#define CSSLOT_INFOSLOT 1
+#define CSSLOT_REQUIREMENTS 2
+#define CSSLOT_RESOURCEDIR 3
+#define CSSLOT_APPLICATION 4
+#define CSSLOT_ENTITLEMENTS 5
+#define CSSLOT_DER_ENTITLEMENTS 7
+#define CSSLOT_ALTERNATE_CODEDIRECTORIES 0x1000
+#define CSSLOT_ALTERNATE_CODEDIRECTORY_MAX 5
+#define CSSLOT_SIGNATURESLOT 0x10000
+
+#define CS_HASHTYPE_SHA1 1
+#define CS_HASHTYPE_SHA256 2
+#define CS_HASHTYPE_SHA256_TRUNCATED 3
+#define CS_HASHTYPE_SHA384 4
+#define CS_HASH_MAX_SIZE 48
+#define CS_CDHASH_LEN 20 /* always truncated to 20 bytes */
+
+#define CS_ADHOC 0x00000002         /* ad hoc signed */
+#define CS_LINKER_SIGNED 0x00020000 /* automatically signed by the linker */
+
+#define CS_SUPPORTSSCATTER 0x20100
+#define CS_SUPPORTSTEAMID 0x20200
+#define CS_SUPPORTSCODELIMIT64 0x20300
+#define CS_SUPPORTSEXECSEG 0x20400
+
+struct CS_BlobIndex {
+  uint32_t type;   /* type of entry */
+  uint32_t offset; /* offset of entry */
+};
+
+struct CS_SuperBlob {
+  uint32_t magic;  /* magic number */
+  uint32_t length; /* total length of SuperBlob */
+  uint32_t count;  /* number of index entries following */
+  /* followed by CS_BlobIndex index[count] */
+};
+
+struct CS_CodeDirectory {
+  uint32_t magic;         /* magic number (CSMAGIC_CODEDIRECTORY) */
+  uint32_t length;        /* total length of CodeDirectory blob */
+  uint32_t version;       /* compatibility version */
+  uint32_t flags;         /* setup and mode flags */
+  uint32_t hashOffset;    /* offset of hash slot element at index zero */
+  uint32_t identOffset;   /* offset of identifier string */
+  uint32_t nSpecialSlots; /* number of special hash slots */
+  uint32_t nCodeSlots;    /* number of ordinary (code) hash slots */
+  uint32_t codeLimit;     /* limit to main image signature range */
+  uint8_t hashSize;       /* size of each hash in bytes */
+  uint8_t hashType;       /* type of hash (CS_HASHTYPE_* constants) */
+  uint8_t platform;       /* platform identifier; zero if not platform binary */
+  uint8_t pageSize;       /* log2(page size in bytes); 0 => infinite */
+  uint32_t spare2;        /* unused (must be zero) */
+  /* version 0x20100 */
+  uint32_t scatterOffset; /* offset of optional scatter vector */
+  /* version 0x20200 */
+  uint32_t teamOffset; /* offset of optional team identifier */
+  /* version 0x20300 */
+  uint32_t spare3;      /* unused (must be zero) */
+  uint64_t codeLimit64; /* limit to main image signature range, 64 bits */
+  /* version 0x20400 */
+  uint64_t execSegBase;  /* offset of executable segment */
+  uint64_t execSegLimit; /* limit of executable segment */
+  uint64_t execSegFlags; /* executable segment flags */
+};
+
 #endif
@@ -0,0 +1,822 @@
+/// nested archive classification
+#include <atomic>
+#include <thread>
+#include <algorithm>
+#include <cstring>
+#include <bela/codecvt.hpp>
+#include "inquisitive.hpp"
+#include "zip.hpp"
+#include "tar.hpp"
+#include "cab.hpp"
+#include "inflate.hpp"
+
+// Containers are walked through WindowView, file-backed at top level and memory-backed below it.
+// Stored members are viewed in place, deflated members are inflated once into memory bounded by
+// nested_options_t, so hostile archives (quines, bombs) cannot run away with memory or time.
+
+namespace inquisitive {
+// ar member header, every field is space padded ASCII
+// https://en.wikipedia.org/wiki/Ar_(Unix)
+#pragma pack(1)
+struct ar_header_t {
+  char name[16];
+  char date[12];
+  char uid[6];
+  char gid[6];
+  char mode[8];
+  char size[10];
+  char fmag[2]; // "`\n"
+};
+#pragma pack()
+
+enum nested_kind_t : int {
+  NestedNone = 0,
+  NestedZip,
+  NestedTar,
+  NestedAr,
+  NestedCab,
+  NestedGzip,
+  NestedSevenZip, /// files of Copy coder folders only
+  NestedOpaque    /// container we cannot decode (RAR, xz, bzip2...)
+};
+
+// 7z coder chains have no ZIP method number, such members are not decoded
+constexpr uint16_t nested_method_other = 0xFFFF;
+
+struct nested_context_t {
+  nested_options_t opts;
+  std::atomic_uint64_t members{0};
+  std::atomic_uint64_t memory{0}; /// decompressed buffers alive in every worker and depth
+};
+
+// member located in parent container
+struct nested_member_t {
+  std::wstring name;
+  uint64_t offset{0};     /// data offset in parent, local header offset when local is set
+  uint64_t size{0};       /// uncompressed size
+  uint64_t compressed{0}; /// stored size
+  uint16_t method{0};     /// 0 stored, 8 deflate, others are not supported
+  uint32_t flags{0};      /// nested_flags_t known from parent, such as encryption
+  bool local{false};      /// offset points to ZIP local file header
+};
+
+nested_kind_t nested_kind(const inquisitive_node_t &node) {
+  if (node.e == types::ZIP) {
+    return NestedZip;
+  }
+  switch (node.t) {
+  case types::tar:
+    return NestedTar;
+  case types::archive:
+  case types::deb:
+    return NestedAr;
+  case types::cab:
+    return NestedCab;
+  case types::gz:
+    return NestedGzip;
+  case types::p7z:
+    return NestedSevenZip;
+  case types::rar:
+  case types::bz2:
+  case types::xz:
+  case types::lz:
+  case types::z:
+  case types::zstd:
+  case types::lz4:
+  case types::xar:
+  case types::wim:
+  case types::rpm:
+    return NestedOpaque;
+  default:
+    break;
+  }
+  return NestedNone;
+}
+
+void nested_classify(base::MemView mv, inquisitive_node_t &node) {
+  inquisitive_result_t ir;
+  if (inquisitive_memview(mv, ir) != Found) {
+    return;
+  }
+  node.description = ir.description();
+  node.t = ir.type();
+  node.e = ir.typeex();
+}
+
+// members over budget are dropped, container is flagged instead
+void nested_prune(inquisitive_node_t &node) {
+  auto it = std::remove_if(node.children.begin(), node.children.end(),
+                           [](const inquisitive_node_t &c) {
+                             return (c.flags & NestedMemberLimit) != 0 && c.description.empty();
+                           });
+  if (it != node.children.end()) {
+    node.children.erase(it, node.children.end());
+    node.flags |= NestedMemberLimit;
+  }
+}
+
+std::wstring_view nested_basename(std::wstring_view name) {
+  auto pos = name.find_last_of(L"\\/");
+  return pos == std::wstring_view::npos ? name : name.substr(pos + 1);
+}
+
+inline bool nested_suffix(std::wstring_view name, std::wstring_view suffix) {
+  return name.size() > suffix.size() &&
+         name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// nested_walker owns decoder state, one walker per thread
+class nested_walker {
+public:
+  nested_walker(nested_context_t &ctx) : ctx(ctx) {}
+  nested_walker(const nested_walker &) = delete;
+  nested_walker &operator=(const nested_walker &) = delete;
+  // walk container, node is classified already
+  void open(base::WindowView &wv, inquisitive_node_t &node, uint32_t depth);
+  // collect members of ZIP, TAR, ar, gzip and 7z, container is flagged when it is damaged
+  void collect(base::WindowView &wv, nested_kind_t kind, inquisitive_node_t &node,
+               std::vector<nested_member_t> &members);
+  // classify member and walk it when it is a container
+  void member(base::WindowView &wv, const nested_member_t &m, inquisitive_node_t &node,
+              uint32_t depth);
+
+private:
+  bool collect_zip(base::WindowView &wv, inquisitive_node_t &node,
+                   std::vector<nested_member_t> &members);
+  bool collect_tar(base::WindowView &wv, std::vector<nested_member_t> &members);
+  bool collect_ar(base::WindowView &wv, inquisitive_node_t &node,
+                  std::vector<nested_member_t> &members);
+  bool collect_gzip(base::WindowView &wv, inquisitive_node_t &node,
+                    std::vector<nested_member_t> &members);
+  bool collect_7z(base::WindowView &wv, inquisitive_node_t &node,
+                  std::vector<nested_member_t> &members);
+  void cabinet(base::WindowView &wv, inquisitive_node_t &node, uint32_t depth);
+  uint32_t cabinet_folder(base::WindowView &wv, const cabinet_folder_t &folder, uint8_t reserve,
+                          std::vector<uint8_t> &out, uint64_t &charged);
+  bool inflate_member(base::WindowView &wv, const nested_member_t &m, inquisitive_node_t &node,
+                      std::vector<uint8_t> &out, uint64_t &charged);
+  bool over_budget() { return ctx.members++ >= ctx.opts.members; }
+  // buffer is charged while it grows and released once its members are walked
+  bool charge(uint64_t n, uint64_t &charged) {
+    if (ctx.memory.fetch_add(n) + n > ctx.opts.memory) {
+      ctx.memory -= n;
+      return false;
+    }
+    charged += n;
+    return true;
+  }
+  void release(uint64_t &charged) {
+    ctx.memory -= charged;
+    charged = 0;
+  }
+  uint64_t ratio_limit(uint64_t compressed) const {
+    return compressed > UINT64_MAX / ctx.opts.ratio ? UINT64_MAX : compressed * ctx.opts.ratio;
+  }
+  nested_context_t &ctx;
+  inflate_stream s;
+};
+
+bool nested_walker::collect_zip(base::WindowView &wv, inquisitive_node_t &node,
+                                std::vector<nested_member_t> &members) {
+  bela::error_code ec;
+  zip_directory_t zd;
+  if (!zip_directory_locate(wv, zd, ec)) {
+    return false;
+  }
+  inquisitive_result_t ir;
+  if (zip_classify(wv, zd, ir) == Found) {
+    node.description = ir.description();
+    node.t = ir.type();
+  }
+  // entries are views into central directory, nothing else is mapped until they are copied
+  auto cd = wv.Window(zd.offset, static_cast<size_t>(zd.size), ec);
+  if (cd.size() != zd.size) {
+    return false;
+  }
+  zip_central_reader reader(cd, zd.prefix);
+  zip_entry_t e;
+  while (reader.next(e)) {
+    if (!e.name.empty() && e.name.back() == '/') {
+      continue;
+    }
+    // one member over budget is enough to flag container
+    if (members.size() > ctx.opts.members) {
+      break;
+    }
+    auto &m = members.emplace_back();
+    m.name = bela::ToWide(e.name);
+    m.offset = e.localoffset;
+    m.size = e.uncompressedsize;
+    m.compressed = e.compressedsize;
+    m.method = e.method;
+    m.local = true;
+    if ((e.flags & zip_flag_encrypted) != 0) {
+      m.flags |= NestedEncrypted;
+    }
+  }
+  return !reader.bad();
+}
+
+bool nested_walker::collect_tar(base::WindowView &wv, std::vector<nested_member_t> &members) {
+  tar_reader reader(wv);
+  tar_entry_t e;
+  while (reader.next(e)) {
+    if (!e.regular()) {
+      continue;
+    }
+    if (members.size() > ctx.opts.members) {
+      break;
+    }
+    auto &m = members.emplace_back();
+    m.name = bela::ToWide(e.name);
+    m.offset = e.offset;
+    m.size = (std::min)(e.size, wv.size() - e.offset);
+    m.compressed = m.size;
+    if (m.size != e.size) {
+      m.flags |= NestedDamaged;
+    }
+  }
+  return !reader.bad();
+}
+
+inline bool ar_number(const char *field, size_t len, uint64_t &v) {
+  v = 0;
+  size_t i = 0;
+  for (; i < len && field[i] >= '0' && field[i] <= '9'; i++) {
+    v = v * 10 + static_cast<uint64_t>(field[i] - '0');
+  }
+  return i != 0 && (i == len || field[i] == ' ');
+}
+
+bool nested_walker::collect_ar(base::WindowView &wv, inquisitive_node_t &node,
+                               std::vector<nested_member_t> &members) {
+  bela::error_code ec;
+  auto magic = wv.Window(0, 8, ec).sv();
+  if (magic == "!<thin>\n") {
+    // thin archive members live in other files
+    node.flags |= NestedUnsupported;
+    return true;
+  }
+  if (magic != "!<arch>\n") {
+    return false;
+  }
+  std::string longnames;
+  uint64_t pos = 8;
+  while (pos + sizeof(ar_header_t) <= wv.size()) {
+    ar_header_t hd;
+    if (wv.ReadAt(pos, &hd, sizeof(hd), ec) != sizeof(hd) || hd.fmag[0] != '`' ||
+        hd.fmag[1] != '\n') {
+      return false;
+    }
+    uint64_t size = 0;
+    if (!ar_number(hd.size, sizeof(hd.size), size)) {
+      return false;
+    }
+    auto offset = pos + sizeof(ar_header_t);
+    if (size > wv.size() - offset) {
+      return false;
+    }
+    // members are aligned to even offsets
+    pos = offset + size + (size & 1);
+    std::string_view name(hd.name, sizeof(hd.name));
+    name.remove_suffix(sizeof(hd.name) - (name.find_last_not_of(' ') + 1));
+    std::string bsdname;
+    if (name == "/" || name == "/SYM64/") {
+      continue;
+    }
+    if (name == "//") {
+      // GNU long name table
+      longnames.assign(wv.Window(offset, static_cast<size_t>(size), ec).sv());
+      continue;
+    }
+    if (name.size() > 1 && name[0] == '/' && name[1] >= '0' && name[1] <= '9') {
+      uint64_t index = 0;
+      if (!ar_number(name.data() + 1, name.size() - 1, index) || index >= longnames.size()) {
+        return false;
+      }
+      auto end = longnames.find('\n', static_cast<size_t>(index));
+      name = std::string_view(longnames).substr(static_cast<size_t>(index),
+                                                end - static_cast<size_t>(index));
+    } else if (name.size() > 3 && name.compare(0, 3, "#1/") == 0) {
+      // BSD stores long name ahead of member data
+      uint64_t namelen = 0;
+      if (!ar_number(name.data() + 3, name.size() - 3, namelen) || namelen > size) {
+        return false;
+      }
+      auto nv = wv.Window(offset, static_cast<size_t>(namelen), ec);
+      bsdname.assign(nv.sv().substr(0, byte_strnlen(nv.data(), nv.size())));
+      name = bsdname;
+      offset += namelen;
+      size -= namelen;
+    }
+    if (!name.empty() && name.back() == '/') {
+      name.remove_suffix(1);
+    }
+    if (name.compare(0, 9, "__.SYMDEF") == 0) {
+      continue;
+    }
+    if (members.size() > ctx.opts.members) {
+      break;
+    }
+    auto &m = members.emplace_back();
+    m.name = bela::ToWide(name);
+    m.offset = offset;
+    m.size = size;
+    m.compressed = size;
+  }
+  return true;
+}
+
+bool nested_walker::collect_gzip(base::WindowView &wv, inquisitive_node_t &node,
+                                 std::vector<nested_member_t> &members) {
+  bela::error_code ec;
+  // header with extra field, name and comment
+  auto hv = wv.Window(0, zip_sniff_input_max, ec);
+  auto offset = gzip_data_offset(hv);
+  // CRC-32 and ISIZE trailer
+  if (offset == 0 || wv.size() < offset + 8) {
+    return false;
+  }
+  auto &m = members.emplace_back();
+  auto name = gzip_member_name(hv);
+  if (!name.empty()) {
+    auto wname = bela::ToWide(name);
+    m.name.assign(nested_basename(wname));
+  } else {
+    auto base = nested_basename(node.name);
+    if (nested_suffix(base, L".tgz")) {
+      m.name.assign(base.substr(0, base.size() - 4)).append(L".tar");
+    } else if (nested_suffix(base, L".gz")) {
+      m.name.assign(base.substr(0, base.size() - 3));
+    } else {
+      m.name.assign(base);
+    }
+  }
+  uint32_t isize = 0;
+  wv.ReadAt(wv.size() - 4, &isize, sizeof(isize), ec);
+  // ISIZE is size modulo 2^32, memory limit still applies while inflating
+  m.size = bela::swaple(isize);
+  m.offset = offset;
+  m.compressed = wv.size() - offset - 8;
+  m.method = 8;
+  return true;
+}
+
+bool nested_walker::collect_7z(base::WindowView &wv, inquisitive_node_t &node,
+                               std::vector<nested_member_t> &members) {
+  bela::error_code ec;
+  std::vector<p7z_entry_t> entries;
+  auto pm = inquisitive_7z(wv, ec, 0, &entries);
+  if (pm && !pm->decoded) {
+    // file list is inside LZMA encoded header
+    node.flags |= NestedUnsupported;
+    return true;
+  }
+  // files located before damage are still walked
+  for (const auto &e : entries) {
+    if (members.size() > ctx.opts.members) {
+      break;
+    }
+    auto &m = members.emplace_back();
+    m.name = e.name;
+    m.offset = e.offset;
+    m.size = e.size;
+    m.compressed = e.stored ? e.size : e.packed;
+    m.method = e.stored ? 0 : nested_method_other;
+    if (e.encrypted) {
+      m.flags |= NestedEncrypted;
+    }
+  }
+  return pm.has_value();
+}
+
+void nested_walker::collect(base::WindowView &wv, nested_kind_t kind, inquisitive_node_t &node,
+                            std::vector<nested_member_t> &members) {
+  bool ok = false;
+  switch (kind) {
+  case NestedZip:
+    ok = collect_zip(wv, node, members);
+    break;
+  case NestedTar:
+    ok = collect_tar(wv, members);
+    break;
+  case NestedAr:
+    ok = collect_ar(wv, node, members);
+    break;
+  case NestedGzip:
+    ok = collect_gzip(wv, node, members);
+    break;
+  case NestedSevenZip:
+    ok = collect_7z(wv, node, members);
+    break;
+  default:
+    break;
+  }
+  if (!ok) {
+    // members before damage are still walked
+    node.flags |= NestedDamaged;
+  }
+}
+
+bool nested_walker::inflate_member(base::WindowView &wv, const nested_member_t &m,
+                                   inquisitive_node_t &node, std::vector<uint8_t> &out,
+                                   uint64_t &charged) {
+  auto ratiolimit = ratio_limit(m.compressed);
+  // declared size is checked by member(), actual output is checked again while inflating
+  if (m.size > ctx.opts.memory) {
+    node.flags |= NestedMemoryLimit;
+    return false;
+  }
+  bela::error_code ec;
+  auto cv = wv.Window(m.offset, static_cast<size_t>(m.compressed), ec);
+  if (cv.size() != m.compressed) {
+    node.flags |= NestedDamaged;
+    return false;
+  }
+  auto limit = (std::min)(ratiolimit, ctx.opts.memory);
+  if (!charge(m.size, charged)) {
+    node.flags |= NestedMemoryBudget;
+    return false;
+  }
+  out.clear();
+  out.reserve(static_cast<size_t>(m.size));
+  s.reset(cv);
+  while (!s.eof()) {
+    auto chunk = s.read();
+    if (out.size() + chunk.size() > limit) {
+      node.flags |= (limit == ratiolimit ? NestedBomb : NestedMemoryLimit);
+      return false;
+    }
+    // declared size may lie, output past it is charged as it comes
+    if (out.size() + chunk.size() > charged && !charge(chunk.size(), charged)) {
+      node.flags |= NestedMemoryBudget;
+      return false;
+    }
+    out.insert(out.end(), chunk.data(), chunk.data() + chunk.size());
+  }
+  if (!s.done()) {
+    // truncated output is still walked, walkers stop at damaged member
+    node.flags |= NestedDamaged;
+  }
+  return !out.empty();
+}
+
+void nested_walker::member(base::WindowView &wv, const nested_member_t &m,
+                           inquisitive_node_t &node, uint32_t depth) {
+  node.name = m.name;
+  node.size = m.size;
+  node.compressed = m.compressed;
+  node.flags |= m.flags;
+  if (over_budget()) {
+    node.flags |= NestedMemberLimit;
+    return;
+  }
+  if ((node.flags & NestedEncrypted) != 0) {
+    return;
+  }
+  if (m.method != 0 && m.method != 8) {
+    node.flags |= NestedUnsupported;
+    return;
+  }
+  // prefix is still classified, only full decompression is refused
+  if (m.size > ratio_limit(m.compressed)) {
+    node.flags |= NestedBomb;
+  }
+  bela::error_code ec;
+  auto dm = m;
+  if (m.local && (dm.offset = zip_data_offset(wv, m.offset, ec)) == 0) {
+    node.flags |= NestedDamaged;
+    return;
+  }
+  if (m.size == 0) {
+    return;
+  }
+  base::MemView prefix;
+  if (dm.method == 0) {
+    auto n = static_cast<size_t>((std::min)(dm.size, uint64_t(inflate_sniff_size)));
+    prefix = wv.Window(dm.offset, n, ec);
+  } else {
+    auto n = static_cast<size_t>((std::min)(dm.compressed, uint64_t(zip_sniff_input_max)));
+    s.reset(wv.Window(dm.offset, n, ec));
+    prefix = s.read(inflate_sniff_size);
+  }
+  if (prefix.size() == 0) {
+    node.flags |= NestedDamaged;
+    return;
+  }
+  nested_classify(prefix, node);
+  auto kind = nested_kind(node);
+  if (kind == NestedNone) {
+    return;
+  }
+  if (kind == NestedOpaque) {
+    node.flags |= NestedUnsupported;
+    return;
+  }
+  if (depth >= ctx.opts.depth) {
+    node.flags |= NestedDepthLimit;
+    return;
+  }
+  if ((node.flags & NestedBomb) != 0) {
+    return;
+  }
+  std::vector<uint8_t> buffer;
+  uint64_t charged = 0;
+  base::MemView mv;
+  if (dm.method == 0) {
+    // parent windows are not touched until child is walked, view stays valid
+    mv = wv.Window(dm.offset, static_cast<size_t>(dm.size), ec);
+    if (mv.size() != dm.size) {
+      node.flags |= NestedDamaged;
+      return;
+    }
+  } else {
+    if (!inflate_member(wv, dm, node, buffer, charged)) {
+      release(charged);
+      return;
+    }
+    mv = base::MemView(buffer.data(), buffer.size());
+  }
+  base::WindowView child;
+  child.Attach(mv);
+  open(child, node, depth);
+  release(charged);
+}
+
+uint32_t nested_walker::cabinet_folder(base::WindowView &wv, const cabinet_folder_t &folder,
+                                       uint8_t reserve, std::vector<uint8_t> &out,
+                                       uint64_t &charged) {
+  auto type = bela::swaple(folder.typeCompress) & cabinet_compress_mask;
+  if (type != cabinet_compress_none && type != cabinet_compress_mszip) {
+    // Quantum and LZX
+    return NestedUnsupported;
+  }
+  bela::error_code ec;
+  auto blocks = bela::swaple(folder.cCFData);
+  // block headers are summed first, bombs are refused before anything is decoded
+  uint64_t compressed = 0;
+  uint64_t uncompressed = 0;
+  uint64_t pos = bela::swaple(folder.coffCabStart);
+  for (uint16_t i = 0; i < blocks; i++) {
+    cabinet_data_t cd;
+    if (wv.ReadAt(pos, &cd, sizeof(cd), ec) != sizeof(cd)) {
+      return NestedDamaged;
+    }
+    compressed += bela::swaple(cd.cbData);
+    uncompressed += bela::swaple(cd.cbUncomp);
+    pos += sizeof(cd) + reserve + bela::swaple(cd.cbData);
+  }
+  if (uncompressed > ratio_limit(compressed)) {
+    return NestedBomb;
+  }
+  if (uncompressed > ctx.opts.memory) {
+    return NestedMemoryLimit;
+  }
+  if (!charge(uncompressed, charged)) {
+    return NestedMemoryBudget;
+  }
+  out.clear();
+  out.reserve(static_cast<size_t>(uncompressed));
+  pos = bela::swaple(folder.coffCabStart);
+  for (uint16_t i = 0; i < blocks; i++) {
+    cabinet_data_t cd;
+    wv.ReadAt(pos, &cd, sizeof(cd), ec);
+    auto cbData = bela::swaple(cd.cbData);
+    auto cbUncomp = bela::swaple(cd.cbUncomp);
+    auto dv = wv.Window(pos + sizeof(cd) + reserve, cbData, ec);
+    pos += sizeof(cd) + reserve + cbData;
+    if (dv.size() != cbData) {
+      return NestedDamaged;
+    }
+    if (type == cabinet_compress_none) {
+      out.insert(out.end(), dv.data(), dv.data() + dv.size());
+      continue;
+    }
+    // every MSZIP block is 'CK' and one deflate stream, history carries over blocks
+    if (cbData < 2 || dv[0] != 'C' || dv[1] != 'K') {
+      return NestedDamaged;
+    }
+    if (i == 0) {
+      s.reset(dv.data() + 2, dv.size() - 2);
+    } else {
+      s.resume(dv.data() + 2, dv.size() - 2);
+    }
+    auto begin = out.size();
+    while (!s.eof()) {
+      auto chunk = s.read();
+      if (out.size() + chunk.size() > uncompressed) {
+        return NestedDamaged;
+      }
+      out.insert(out.end(), chunk.data(), chunk.data() + chunk.size());
+    }
+    if (!s.done() || out.size() - begin != cbUncomp) {
+      return NestedDamaged;
+    }
+  }
+  return 0;
+}
+
+void nested_walker::cabinet(base::WindowView &wv, inquisitive_node_t &node, uint32_t depth) {
+  bela::error_code ec;
+  cabinet_header_t hd;
+  if (wv.ReadAt(0, &hd, sizeof(hd), ec) != sizeof(hd)) {
+    node.flags |= NestedDamaged;
+    return;
+  }
+  auto flags = bela::swaple(hd.flags);
+  uint64_t pos = cabinet_header_size;
+  uint8_t folderreserve = 0;
+  uint8_t datareserve = 0;
+  if ((flags & cabinet_flag_reserve) != 0) {
+    pos = sizeof(cabinet_header_t) + bela::swaple(hd.cbCFHeader);
+    folderreserve = hd.cbCFFolder;
+    datareserve = hd.cbCFData;
+  }
+  // previous and next cabinet and disk names, each at most 255 bytes
+  auto strings =
+      ((flags & cabinet_flag_prev) != 0 ? 2 : 0) + ((flags & cabinet_flag_next) != 0 ? 2 : 0);
+  for (int i = 0; i < strings; i++) {
+    auto sv = wv.Window(pos, 256, ec);
+    auto n = byte_strnlen(sv.data(), sv.size());
+    if (n == sv.size()) {
+      node.flags |= NestedDamaged;
+      return;
+    }
+    pos += n + 1;
+  }
+  std::vector<cabinet_folder_t> folders(bela::swaple(hd.cFolders));
+  for (auto &f : folders) {
+    if (wv.ReadAt(pos, &f, sizeof(f), ec) != sizeof(f)) {
+      node.flags |= NestedDamaged;
+      return;
+    }
+    pos += sizeof(f) + folderreserve;
+  }
+  struct cabinet_member_t {
+    nested_member_t m;
+    uint16_t folder{0};
+  };
+  std::vector<cabinet_member_t> members;
+  pos = bela::swaple(hd.coffFiles);
+  for (uint16_t i = 0, files = bela::swaple(hd.cFiles); i < files; i++) {
+    cabinet_file_t cf;
+    if (wv.ReadAt(pos, &cf, sizeof(cf), ec) != sizeof(cf)) {
+      node.flags |= NestedDamaged;
+      break;
+    }
+    pos += sizeof(cf);
+    auto nv = wv.Window(pos, 256, ec);
+    auto n = byte_strnlen(nv.data(), nv.size());
+    pos += n + 1;
+    auto &cm = members.emplace_back();
+    // _A_NAME_IS_UTF or ANSI, ASCII either way in practice
+    cm.m.name = bela::ToWide(nv.sv().substr(0, n));
+    cm.m.offset = bela::swaple(cf.uoffFolderStart);
+    cm.m.size = bela::swaple(cf.cbFile);
+    cm.m.compressed = cm.m.size;
+    cm.folder = bela::swaple(cf.iFolder);
+    if (cm.folder >= cabinet_folder_continued) {
+      // spanned over cabinet set
+      cm.m.flags |= NestedUnsupported;
+    } else if (cm.folder >= folders.size()) {
+      cm.m.flags |= NestedDamaged;
+    }
+  }
+  node.children.resize(members.size());
+  std::vector<uint8_t> buffer;
+  uint64_t charged = 0;
+  // files are grouped by folder, every folder is decoded once
+  for (size_t k = 0; k <= folders.size(); k++) {
+    uint32_t folderflags = 0;
+    base::WindowView fv;
+    release(charged);
+    if (k < folders.size()) {
+      folderflags = cabinet_folder(wv, folders[k], datareserve, buffer, charged);
+      fv.Attach(base::MemView(buffer.data(), buffer.size()));
+    }
+    for (size_t i = 0; i < members.size(); i++) {
+      const auto &cm = members[i];
+      if (k < folders.size() ? cm.folder != k : cm.folder < folders.size()) {
+        continue;
+      }
+      auto &child = node.children[i];
+      if (k == folders.size() || folderflags != 0) {
+        // member is not decoded, tell why
+        child.name = cm.m.name;
+        child.size = cm.m.size;
+        child.compressed = cm.m.compressed;
+        child.flags |= cm.m.flags | folderflags;
+        continue;
+      }
+      auto m = cm.m;
+      if (m.offset > buffer.size() || m.size > buffer.size() - m.offset) {
+        m.flags |= NestedDamaged;
+        m.size = m.offset < buffer.size() ? buffer.size() - m.offset : 0;
+      }
+      member(fv, m, child, depth + 1);
+    }
+  }
+  release(charged);
+  nested_prune(node);
+}
+
+void nested_walker::open(base::WindowView &wv, inquisitive_node_t &node, uint32_t depth) {
+  auto kind = nested_kind(node);
+  if (kind == NestedCab) {
+    cabinet(wv, node, depth);
+    return;
+  }
+  std::vector<nested_member_t> members;
+  collect(wv, kind, node, members);
+  node.children.resize(members.size());
+  for (size_t i = 0; i < members.size(); i++) {
+    member(wv, members[i], node.children[i], depth + 1);
+    if ((node.children[i].flags & NestedMemberLimit) != 0) {
+      node.children.resize(i + 1);
+      break;
+    }
+  }
+  nested_prune(node);
+}
+
+std::optional<inquisitive_node_t> inquisitive_nested(std::wstring_view sv, bela::error_code &ec,
+                                                     const nested_options_t &opts) {
+  base::WindowView wv;
+  if (!wv.Open(sv, ec)) {
+    return std::nullopt;
+  }
+  auto prefix = wv.Window(0, 32 * 1024, ec);
+  if (prefix.size() == 0) {
+    return std::nullopt;
+  }
+  inquisitive_node_t root;
+  root.name.assign(sv);
+  root.size = wv.size();
+  root.compressed = wv.size();
+  nested_classify(prefix, root);
+  nested_context_t ctx;
+  ctx.opts = opts;
+  if (ctx.opts.ratio == 0) {
+    ctx.opts.ratio = 1;
+  }
+  auto kind = nested_kind(root);
+  if (kind == NestedNone) {
+    return std::make_optional(std::move(root));
+  }
+  if (kind == NestedOpaque) {
+    root.flags |= NestedUnsupported;
+    return std::make_optional(std::move(root));
+  }
+  if (ctx.opts.depth == 0) {
+    root.flags |= NestedDepthLimit;
+    return std::make_optional(std::move(root));
+  }
+  nested_walker walker(ctx);
+  if (kind == NestedCab) {
+    // cabinet folders are decoded in order
+    walker.open(wv, root, 0);
+    return std::make_optional(std::move(root));
+  }
+  std::vector<nested_member_t> members;
+  walker.collect(wv, kind, root, members);
+  // members of outermost container are independent, each worker maps the file by itself
+  root.children.resize(members.size());
+  auto concurrency = opts.concurrency;
+  if (concurrency == 0) {
+    concurrency = (std::max)(std::thread::hardware_concurrency(), 1u);
+  }
+  concurrency =
+      static_cast<uint32_t>((std::min)(static_cast<size_t>(concurrency), members.size()));
+  std::atomic_size_t next{0};
+  auto worker = [&]() {
+    base::WindowView mwv;
+    bela::error_code mec;
+    nested_walker w(ctx);
+    if (!mwv.Open(sv, mec)) {
+      for (auto i = next++; i < members.size(); i = next++) {
+        root.children[i].name = members[i].name;
+        root.children[i].flags |= NestedDamaged;
+      }
+      return;
+    }
+    for (auto i = next++; i < members.size(); i = next++) {
+      w.member(mwv, members[i], root.children[i], 1);
+    }
+  };
+  if (concurrency <= 1) {
+    worker();
+  } else {
+    std::vector<std::thread> workers;
+    workers.reserve(concurrency);
+    for (uint32_t i = 0; i < concurrency; i++) {
+      workers.emplace_back(worker);
+    }
+    for (auto &w : workers) {
+      w.join();
+    }
+  }
+  nested_prune(root);
+  return std::make_optional(std::move(root));
+}
+
+} // namespace inquisitive
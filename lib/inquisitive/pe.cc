@@ -7,7 +7,10 @@
 #include "inquisitive.hpp"
 #include <bela/endian.hpp>
 #include <bela/codecvt.hpp>
-#include <bela/pe.hpp>
+#include <bela/numbers.hpp>
+#include <bela/peview.hpp>
+#include <bela/clrview.hpp>
+#include <bela/hash.hpp>
 
 #ifndef PROCESSOR_ARCHITECTURE_ARM64
 #define PROCESSOR_ARCHITECTURE_ARM64 12
@@ -50,24 +53,6 @@
 #define IMAGE_SUBSYSTEM_XBOX_CODE_CATALOG 17 // XBOX Code Catalog
 #endif
 
-typedef enum ReplacesGeneralNumericDefines {
-// Directory entry macro for CLR data.
-#ifndef IMAGE_DIRECTORY_ENTRY_COMHEADER
-  IMAGE_DIRECTORY_ENTRY_COMHEADER = 14,
-#endif // IMAGE_DIRECTORY_ENTRY_COMHEADER
-} ReplacesGeneralNumericDefines;
-#define STORAGE_MAGIC_SIG 0x424A5342 // BSJB
-
-#pragma pack(1)
-struct STORAGESIGNATURE {
-  ULONG Signature;     // Magic signature for physical metadata : 0x424A5342.
-  USHORT MajorVersion; // Major version, 1 (ignore on read)
-  USHORT MinorVersion; // Minor version, 0 (ignore on read)
-  ULONG ExtraData;     // offset to next structure of information
-  ULONG Length;        // Length of version string in bytes
-};
-#pragma pack()
-
 namespace inquisitive {
 
 struct key_value_t {
@@ -212,190 +197,435 @@ constexpr std::wstring_view Subsystem(uint32_t index) {
   return L"UNKNOWN";
 }
 
-std::wstring fromascii(std::string_view sv) {
-  auto sz = MultiByteToWideChar(CP_ACP, 0, sv.data(), (int)sv.size(), nullptr, 0);
-  std::wstring output;
-  output.resize(sz);
-  // C++17 must output.data()
-  MultiByteToWideChar(CP_ACP, 0, sv.data(), (int)sv.size(), output.data(), sz);
-  return output;
+inline void pecoff_functions(const std::vector<bela::pe::ImportFunction> &funcs,
+                             pe_import_t &im) {
+  im.functions.reserve(funcs.size());
+  for (const auto &f : funcs) {
+    im.functions.emplace_back(pe_function_t{bela::ToWide(f.Name), f.Hint, f.Ordinal});
+  }
 }
 
-static inline PVOID belarva(PVOID m, PVOID b) {
-  return reinterpret_cast<PVOID>(reinterpret_cast<ULONG_PTR>(b) + reinterpret_cast<ULONG_PTR>(m));
+// Visual C++ 6.0 delay load descriptor (Attributes without dlattrRva) store VA not RVA
+inline uint32_t delay_rva(const bela::pe::ImageView &iv, uint32_t attributes, uint32_t va) {
+  constexpr uint32_t dlattrRva = 0x1;
+  if ((attributes & dlattrRva) != 0 || va < iv.Oh().ImageBase) {
+    return va;
+  }
+  return static_cast<uint32_t>(va - iv.Oh().ImageBase);
 }
 
-PIMAGE_SECTION_HEADER
-BelaImageRvaToSection(PIMAGE_NT_HEADERS nh, PVOID BaseAddress, ULONG rva) {
-  (void)BaseAddress;
-  ULONG count = bela::swaple(nh->FileHeader.NumberOfSections);
-  PIMAGE_SECTION_HEADER section = IMAGE_FIRST_SECTION(nh);
-  ULONG va = 0;
-  while (count-- != 0) {
-    va = bela::swaple(section->VirtualAddress);
-    if ((va <= rva) && (rva < va + bela::swaple(section->SizeOfRawData))) {
-      return section;
+// exports are counted in place, whole table is copied into pm.exports only when asked
+void pecoff_exports(const bela::pe::ImageView &iv, pe_minutiae_t &pm, bool copy) {
+  bela::pe::ExportView ev;
+  if (!ev.Parse(iv)) {
+    return;
+  }
+  pm.exportname = bela::ToWide(ev.DllName());
+  if (!copy) {
+    for (size_t i = 0; i < ev.NumberOfFunctions(); i++) {
+      auto e = ev.Function(i);
+      if (e.Address != 0 || !e.Forwarder.empty()) {
+        pm.exportcount++;
+      }
+    }
+    return;
+  }
+  std::vector<std::string_view> names(ev.NumberOfFunctions());
+  for (size_t i = 0; i < ev.NumberOfNames(); i++) {
+    auto index = ev.NameIndex(i);
+    if (index < names.size()) {
+      names[index] = ev.Name(i);
+    }
+  }
+  pm.exports.reserve(names.size());
+  for (size_t i = 0; i < names.size(); i++) {
+    auto e = ev.Function(i, names[i]);
+    if (e.Address == 0 && e.Forwarder.empty()) {
+      // unused slot in export address table
+      continue;
     }
-    section++;
+    pm.exports.emplace_back(pe_export_t{bela::ToWide(e.Name), bela::ToWide(e.Forwarder),
+                                        e.Ordinal, e.Address});
   }
-  return nullptr;
+  pm.exportcount = static_cast<uint32_t>(pm.exports.size());
 }
 
-// like RtlImageRvaToVa
-PVOID
-BelaImageRvaToVa(PIMAGE_NT_HEADERS nh, PVOID BaseAddress, ULONG rva, PIMAGE_SECTION_HEADER *sh) {
-  PIMAGE_SECTION_HEADER section = nullptr;
-  if (sh != nullptr) {
-    section = *sh;
-  }
-  if ((section == nullptr) || (rva < bela::swaple(section->VirtualAddress)) ||
-      (rva >= bela::swaple(section->VirtualAddress) + bela::swaple(section->SizeOfRawData))) {
-    section = BelaImageRvaToSection(nh, BaseAddress, rva);
-    if (section == nullptr) {
-      return nullptr;
+// IMAGE_DIRECTORY_ENTRY_RESOURCE resolve version, manifest and icons
+void pecoff_resources(const bela::pe::ImageView &iv, pe_minutiae_t &pm) {
+  bela::pe::Resource vres;
+  bela::pe::VersionResource vr;
+  if (iv.LookupResource(bela::pe::ResourceVersion, vres) &&
+      bela::pe::DecodeVersion(vres.Data, vr)) {
+    bela::pe::VersionInfo vi;
+    bela::pe::VersionStrings(vr, vi);
+    pm.version = std::make_optional(std::move(vi));
+  }
+  iv.Resources([&](const bela::pe::Resource &r) {
+    if (r.Type == bela::pe::ResourceGroupIcon) {
+      pm.icons++;
+      return true;
+    }
+    if (r.Type == bela::pe::ResourceManifest && pm.manifest.empty()) {
+      pm.manifest = bela::ToWide(r.Data.sv());
     }
-    if (sh) {
-      *sh = section;
+    return true;
+  });
+}
+
+constexpr const wchar_t hexdigits[] = L"0123456789ABCDEF";
+
+inline std::wstring pdb_guid(const uint8_t *g) {
+  // Data1, Data2 and Data3 are stored little-endian, Data4 is bytes, -1 is dash
+  constexpr const int order[] = {3,  2,  1,  0,  -1, 5,  4,  -1, 7,  6,
+                                 -1, 8,  9,  -1, 10, 11, 12, 13, 14, 15};
+  std::wstring guid;
+  guid.reserve(36);
+  for (auto i : order) {
+    if (i < 0) {
+      guid.push_back(L'-');
+      continue;
     }
+    guid.push_back(hexdigits[g[i] >> 4]);
+    guid.push_back(hexdigits[g[i] & 0xF]);
   }
-  auto va = reinterpret_cast<ULONG_PTR>(BaseAddress) + rva +
-            static_cast<ULONG_PTR>(bela::swaple(section->PointerToRawData)) -
-            static_cast<ULONG_PTR>(bela::swaple(section->VirtualAddress));
-  return reinterpret_cast<PVOID>(va);
+  return guid;
 }
 
-inline std::wstring DllName(base::MemView mv, LPVOID nh, ULONG nva) {
-  auto va = BelaImageRvaToVa((PIMAGE_NT_HEADERS)nh, (LPVOID)mv.data(), nva, nullptr);
-  if (va == nullptr) {
-    return L"";
+// Rich header and debug directory are small, always resolve them
+void pecoff_debug(const bela::pe::ImageView &iv, pe_minutiae_t &pm) {
+  bela::pe::RichHeader rh;
+  if (iv.Rich(rh)) {
+    pm.richkey = rh.Key;
+    pm.richvalid = rh.Valid;
+    for (const auto &e : rh.Entries) {
+      pm.rich.emplace_back(pe_rich_entry_t{e.ProductId, e.Build, e.Count});
+    }
+  }
+  std::vector<bela::pe::DebugEntry> entries;
+  if (!iv.DebugEntries(entries)) {
+    return;
+  }
+  for (const auto &e : entries) {
+    switch (e.Type) {
+    case bela::pe::DebugCodeView: {
+      bela::pe::CodeView cv;
+      if (!pm.pdb && bela::pe::DecodeCodeView(e.Data, cv)) {
+        pm.pdb = std::make_optional(pe_pdb_t{pdb_guid(cv.Guid), bela::ToWide(cv.Path), cv.Age});
+      }
+    } break;
+    case bela::pe::DebugPogo: {
+      uint32_t signature = 0;
+      std::vector<bela::pe::PogoEntry> pogo;
+      bela::pe::DecodePogo(e.Data, signature, pogo);
+      for (const auto &p : pogo) {
+        pm.pogo.emplace_back(pe_pogo_t{bela::ToWide(p.Name), p.RVA, p.Size});
+      }
+    } break;
+    case bela::pe::DebugRepro: {
+      pm.reproducible = true;
+      // DWORD hash size followed by hash, empty for old linker
+      auto data = e.Data.data();
+      if (e.Data.size() > 4) {
+        auto n = (std::min)(static_cast<size_t>(bela::readle<uint32_t>(data)), e.Data.size() - 4);
+        pm.reprohash.reserve(n * 2);
+        for (size_t i = 0; i < n; i++) {
+          pm.reprohash.push_back(hexdigits[data[4 + i] >> 4]);
+          pm.reprohash.push_back(hexdigits[data[4 + i] & 0xF]);
+        }
+      }
+    } break;
+    default:
+      break;
+    }
+  }
+}
+
+struct pe_packer_section_t {
+  std::string_view name;
+  const wchar_t *packer;
+};
+
+constexpr pe_packer_section_t packer_sections[] = {
+    {"UPX0", L"UPX"},         {"UPX1", L"UPX"},            {".aspack", L"ASPack"},
+    {".adata", L"ASPack"},    {".MPRESS1", L"MPRESS"},     {".MPRESS2", L"MPRESS"},
+    {".petite", L"Petite"},   {"pec1", L"PECompact"},      {"PEC2", L"PECompact"},
+    {".themida", L"Themida"}, {".winlice", L"WinLicense"}, {".vmp0", L"VMProtect"},
+    {".vmp1", L"VMProtect"},  {".enigma1", L"Enigma"},     {".nsp0", L"NsPack"},
+    {"FSG!", L"FSG"},         {"kkrunchy", L"kkrunchy"},
+};
+
+// compressed or encrypted code is near 8 bits per byte, native code is usually below 6.5
+constexpr double high_entropy = 7.2;
+// raw data is empty but loader reserves a large range, typical for unpacking stub targets
+constexpr uint32_t large_virtual_size = 0x100000;
+
+// raw data of sections and overlay are visited in file order, every byte is read once
+void pecoff_sections(const bela::pe::ImageView &iv, pe_minutiae_t &pm) {
+  auto image = iv.Image();
+  const auto &secs = iv.Sections();
+  std::vector<size_t> order(secs.size());
+  for (size_t i = 0; i < order.size(); i++) {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return secs[a].PointerToRawData < secs[b].PointerToRawData;
+  });
+  pm.sections.resize(secs.size());
+  uint64_t rawend = (std::min)(static_cast<uint64_t>(iv.Oh().SizeOfHeaders), image.size());
+  for (auto i : order) {
+    const auto &s = secs[i];
+    auto &ps = pm.sections[i];
+    ps.name = bela::ToWide(s.Name);
+    ps.virtualaddress = s.VirtualAddress;
+    ps.virtualsize = s.VirtualSize;
+    ps.rawoffset = s.PointerToRawData;
+    ps.rawsize = s.SizeOfRawData;
+    ps.characteristics = s.Characteristics;
+    uint64_t off = s.PointerToRawData;
+    if (s.SizeOfRawData != 0 && off < image.size()) {
+      auto size = (std::min)(static_cast<uint64_t>(s.SizeOfRawData), image.size() - off);
+      ps.entropy = shannon_entropy(image.data() + off, static_cast<size_t>(size));
+      rawend = (std::max)(rawend, off + size);
+    }
+    auto executable = (s.Characteristics & IMAGE_SCN_MEM_EXECUTE) != 0;
+    if (executable && (s.Characteristics & IMAGE_SCN_MEM_WRITE) != 0) {
+      pm.anomalies.emplace_back(bela::StringCat(ps.name, L": writable and executable"));
+    }
+    if (s.SizeOfRawData == 0 && (executable || s.VirtualSize >= large_virtual_size)) {
+      pm.anomalies.emplace_back(
+          bela::StringCat(ps.name, L": no raw data, virtual size ", s.VirtualSize));
+    }
+    if (executable && ps.entropy >= high_entropy) {
+      pm.anomalies.emplace_back(bela::StringCat(ps.name, L": high entropy code"));
+    }
+    if (pm.packer.empty()) {
+      for (const auto &p : packer_sections) {
+        if (p.name == s.Name) {
+          pm.packer = p.packer;
+          break;
+        }
+      }
+    }
   }
-  std::string name;
-  name.reserve(256);
-  auto dn = reinterpret_cast<const uint8_t *>(va);
-  auto end = mv.data() + mv.size();
-  for (auto it = dn; it < end && *it != 0; it++) {
-    name.push_back(*it);
+  uint64_t overlayend = image.size();
+  // security directory VirtualAddress is a file offset, signature appended to file is not overlay
+  auto security = iv.Directory(bela::pe::DirectorySecurity);
+  if (security.Size != 0 && security.VirtualAddress >= rawend &&
+      static_cast<uint64_t>(security.VirtualAddress) + security.Size == image.size()) {
+    overlayend = security.VirtualAddress;
   }
-  return fromascii(name);
+  if (overlayend > rawend) {
+    auto size = static_cast<size_t>(overlayend - rawend);
+    pm.overlay = pe_overlay_t{rawend, size, shannon_entropy(image.data() + rawend, size)};
+  }
+}
+
+// public key token is the last 8 bytes of SHA-1 of public key in reverse order
+inline std::wstring public_key_token(bela::MemView key, bool full) {
+  uint8_t token[8];
+  if (full) {
+    if (key.size() == 0) {
+      return L"";
+    }
+    uint8_t digest[bela::hash::sha1::sha1_hash_size];
+    bela::hash::sha1::Hasher h;
+    h.Initialize();
+    h.Update(key.data(), key.size());
+    h.Finalize(digest, sizeof(digest));
+    for (size_t i = 0; i < sizeof(token); i++) {
+      token[i] = digest[sizeof(digest) - 1 - i];
+    }
+  } else {
+    if (key.size() != sizeof(token)) {
+      return L"";
+    }
+    memcpy(token, key.data(), sizeof(token));
+  }
+  std::wstring s;
+  bela::hash::HashEncode(token, sizeof(token), s);
+  return s;
 }
 
-inline std::wstring ClrMessage(base::MemView mv, LPVOID nh, ULONG clrva) {
-  auto va = BelaImageRvaToVa((PIMAGE_NT_HEADERS)nh, (LPVOID)mv.data(), clrva, nullptr);
-  auto end = mv.data() + mv.size();
-  if (va == nullptr || (uint8_t *)va + sizeof(IMAGE_COR20_HEADER) > end) {
-    return L"";
+inline pe_assembly_t pecoff_assembly(const bela::pe::AssemblyIdentity &ai, bool full) {
+  return pe_assembly_t{bela::ToWide(ai.Name),
+                       bela::StringCat(ai.Major, L".", ai.Minor, L".", ai.Build, L".", ai.Revision),
+                       bela::ToWide(ai.Culture), public_key_token(ai.PublicKey, full)};
+}
+
+// tables are decoded from mapped metadata, assemblies are never loaded
+void pecoff_clr(const bela::pe::ImageView &iv, pe_minutiae_t &pm) {
+  bela::pe::MetadataView mv;
+  if (!mv.Parse(iv)) {
+    return;
   }
-  auto clrh = reinterpret_cast<PIMAGE_COR20_HEADER>(va);
-  auto va2 = BelaImageRvaToVa((PIMAGE_NT_HEADERS)nh, (LPVOID)mv.data(),
-                              clrh->MetaData.VirtualAddress, nullptr);
-  if (va2 == nullptr || (const uint8_t *)va2 + sizeof(STORAGESIGNATURE) > end) {
-    return L"";
+  pe_clr_t clr;
+  clr.runtime = bela::ToWide(mv.Version());
+  clr.flags = mv.Flags();
+  clr.typedefs = mv.Rows(bela::pe::TableTypeDef);
+  clr.methoddefs = mv.Rows(bela::pe::TableMethodDef);
+  if (const auto &rtr = mv.ReadyToRun(); rtr) {
+    clr.readytorun = true;
+    clr.r2rmajor = rtr->MajorVersion;
+    clr.r2rminor = rtr->MinorVersion;
   }
-  auto clrmsg = reinterpret_cast<const STORAGESIGNATURE *>(va2);
-  if ((const uint8_t *)clrmsg + clrmsg->Length > end) {
-    return L"";
+  bela::pe::AssemblyIdentity ai;
+  if (mv.Assembly(ai)) {
+    // Assembly table always stores full public key
+    clr.assembly = pecoff_assembly(ai, true);
   }
-  return bela::ToWide(
-      std::string_view((const char *)clrmsg + sizeof(STORAGESIGNATURE), clrmsg->Length));
+  auto refs = mv.Rows(bela::pe::TableAssemblyRef);
+  clr.references.reserve(refs);
+  for (uint32_t i = 0; i < refs; i++) {
+    if (mv.AssemblyRef(i, ai)) {
+      clr.references.emplace_back(
+          pecoff_assembly(ai, (ai.Flags & bela::pe::AssemblyPublicKey) != 0));
+    }
+  }
+  pm.clr = std::move(clr);
 }
 
-template <typename NtHeaderT>
-std::optional<pe_minutiae_t> pecoff_dump(base::MemView mv, NtHeaderT *nh, bela::error_code &ec) {
+std::optional<pe_minutiae_t> pecoff_dump(const bela::pe::ImageView &iv, uint32_t options,
+                                         bela::error_code &ec) {
+  const auto &fh = iv.Fh();
+  const auto &oh = iv.Oh();
   pe_minutiae_t pm;
-  pm.machine = Machine(nh->FileHeader.Machine);
-  pm.characteristics =
-      Characteristics(nh->FileHeader.Characteristics, nh->OptionalHeader.DllCharacteristics);
-  pm.osver = {nh->OptionalHeader.MajorOperatingSystemVersion,
-              nh->OptionalHeader.MinorOperatingSystemVersion};
-  pm.subsystem = Subsystem(nh->OptionalHeader.Subsystem);
-  pm.linkver = {nh->OptionalHeader.MajorLinkerVersion, nh->OptionalHeader.MinorLinkerVersion};
-  pm.imagever = {nh->OptionalHeader.MajorImageVersion, nh->OptionalHeader.MinorImageVersion};
-  pm.isdll = ((nh->FileHeader.Characteristics & IMAGE_FILE_DLL) != 0);
+  pm.machine = Machine(fh.Machine);
+  pm.characteristics = Characteristics(fh.Characteristics, oh.DllCharacteristics);
+  pm.osver = {oh.MajorOperatingSystemVersion, oh.MinorOperatingSystemVersion};
+  pm.subsystem = Subsystem(oh.Subsystem);
+  pm.linkver = {oh.MajorLinkerVersion, oh.MinorLinkerVersion};
+  pm.imagever = {oh.MajorImageVersion, oh.MinorImageVersion};
+  pm.isdll = iv.IsDLL();
 
   // https://docs.microsoft.com/zh-cn/windows/desktop/api/winnt/ns-winnt-_image_data_directory
-  auto clre = &(nh->OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_COMHEADER]);
-  auto end = mv.data() + mv.size();
-  if (clre->Size == sizeof(IMAGE_COR20_HEADER)) {
+  auto clre = iv.Directory(bela::pe::DirectoryComDescriptor);
+  if (clre.Size == sizeof(bela::pe::Cor20Header)) {
     // Exists IMAGE_COR20_HEADER
-    pm.clrmsg = ClrMessage(mv, (PVOID)nh, clre->VirtualAddress);
+    pm.clrmsg = bela::ToWide(bela::pe::ClrMessage(iv, clre.VirtualAddress));
+    if ((options & PeClr) != 0) {
+      pecoff_clr(iv, pm);
+    }
   }
 
   // Import
-  auto import_ = &(nh->OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_IMPORT]);
-  if (import_->Size != 0) {
-    auto va =
-        BelaImageRvaToVa((PIMAGE_NT_HEADERS)nh, (PVOID)mv.data(), import_->VirtualAddress, nullptr);
-    if (va == nullptr || (const uint8_t *)va + import_->Size >= end) {
-      return std::make_optional<>(pm);
-    }
-    auto imdes = reinterpret_cast<PIMAGE_IMPORT_DESCRIPTOR>(va);
-    while (imdes->Name != 0) {
-      //
+  auto import_ = iv.Directory(bela::pe::DirectoryImport);
+  if (import_.Size != 0) {
+    for (auto rva = import_.VirtualAddress;; rva += sizeof(bela::pe::ImportDescriptor)) {
+      auto imdes = iv.RvaCast<bela::pe::ImportDescriptor>(rva);
+      if (imdes == nullptr || imdes->Name == 0) {
+        break;
+      }
       // ASCIIZ
-      auto dnw = DllName(mv, (LPVOID)nh, imdes->Name);
-      if (!dnw.empty()) {
-        pm.depends.emplace_back(std::move(dnw));
+      auto dnw = bela::ToWide(bela::pe::DllName(iv, bela::swaple(imdes->Name)));
+      if (dnw.empty()) {
+        continue;
       }
-      imdes++;
+      if ((options & PeImports) != 0) {
+        // OriginalFirstThunk may be zero (Borland linker), FirstThunk is unbound on disk then
+        auto thunk = imdes->OriginalFirstThunk != 0 ? bela::swaple(imdes->OriginalFirstThunk)
+                                                    : bela::swaple(imdes->FirstThunk);
+        std::vector<bela::pe::ImportFunction> funcs;
+        iv.Thunks(thunk, funcs);
+        pe_import_t im{dnw, {}};
+        pecoff_functions(funcs, im);
+        pm.imports.emplace_back(std::move(im));
+      }
+      pm.depends.emplace_back(std::move(dnw));
     }
   }
 
   /// Delay import
-  auto delay_ = &(nh->OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_DELAY_IMPORT]);
-  if (delay_->Size != 0) {
-    auto va =
-        BelaImageRvaToVa((PIMAGE_NT_HEADERS)nh, (PVOID)mv.data(), delay_->VirtualAddress, nullptr);
-    if (va == nullptr || (const uint8_t *)va + delay_->Size >= end) {
-      return std::make_optional<>(pm);
-    }
-    auto imdes = reinterpret_cast<PIMAGE_DELAYLOAD_DESCRIPTOR>(va);
-    while (imdes->DllNameRVA != 0) {
-      //
+  auto delay_ = iv.Directory(bela::pe::DirectoryDelayImport);
+  if (delay_.Size != 0) {
+    for (auto rva = delay_.VirtualAddress;; rva += sizeof(bela::pe::DelayloadDescriptor)) {
+      auto imdes = iv.RvaCast<bela::pe::DelayloadDescriptor>(rva);
+      if (imdes == nullptr || imdes->DllNameRVA == 0) {
+        break;
+      }
+      auto attributes = bela::swaple(imdes->Attributes);
       // ASCIIZ
-      auto dnw = DllName(mv, (LPVOID)nh, imdes->DllNameRVA);
-      if (!dnw.empty()) {
-        pm.delays.emplace_back(std::move(dnw));
+      auto dnw = bela::ToWide(
+          bela::pe::DllName(iv, delay_rva(iv, attributes, bela::swaple(imdes->DllNameRVA))));
+      if (dnw.empty()) {
+        continue;
       }
-      imdes++;
+      if ((options & PeImports) != 0) {
+        std::vector<bela::pe::ImportFunction> funcs;
+        iv.Thunks(delay_rva(iv, attributes, bela::swaple(imdes->ImportNameTableRVA)), funcs);
+        pe_import_t im{dnw, {}};
+        pecoff_functions(funcs, im);
+        pm.delayimports.emplace_back(std::move(im));
+      }
+      pm.delays.emplace_back(std::move(dnw));
     }
   }
 
-  // IMAGE_DIRECTORY_ENTRY_RESOURCE resolve copyright
+  pecoff_debug(iv, pm);
+
+  pecoff_exports(iv, pm, (options & PeExports) != 0);
+
+  if ((options & PeResources) != 0) {
+    pecoff_resources(iv, pm);
+  }
+
+  if ((options & PeSections) != 0) {
+    pecoff_sections(iv, pm);
+  }
 
   return std::make_optional<pe_minutiae_t>(std::move(pm));
 }
 
-std::optional<pe_minutiae_t> inquisitive_pecoff(std::wstring_view sv, bela::error_code &ec) {
-
+std::optional<pe_minutiae_t> inquisitive_pecoff(std::wstring_view sv, bela::error_code &ec,
+                                                 uint32_t options) {
   base::MapView mmv;
-  if (!mmv.MappingView(sv, ec, sizeof(IMAGE_DOS_HEADER) + sizeof(IMAGE_NT_HEADERS32))) {
+  if (!mmv.MappingView(sv, ec, sizeof(bela::pe::DosHeader) + sizeof(bela::pe::FileHeader))) {
+    return std::nullopt;
+  }
+  bela::pe::ImageView iv;
+  if (auto status = iv.Parse(mmv.subview()); status != bela::pe::ParseStatus::OK) {
+    // ROM image is not supported
+    ec = bela::make_error_code(bela::FileSizeTooSmall, bela::pe::ParseStatusMessage(status));
     return std::nullopt;
   }
-  auto mv = mmv.subview();
+  return pecoff_dump(iv, options, ec);
+}
 
-  auto h = mv.cast<IMAGE_DOS_HEADER>(0);
-  if (h == nullptr) {
-    ec = bela::make_error_code(L"PE file size tool small");
+std::optional<pe_export_t> inquisitive_pe_export(std::wstring_view sv, std::wstring_view name,
+                                                 bela::error_code &ec) {
+  base::MapView mmv;
+  if (!mmv.MappingView(sv, ec, sizeof(bela::pe::DosHeader) + sizeof(bela::pe::FileHeader))) {
     return std::nullopt;
   }
-  // PE/PE+ lIMAGE_NT_HEADERS32 ayout
-  auto nh = mv.cast<IMAGE_NT_HEADERS32>(h->e_lfanew);
-  if (nh == nullptr) {
-    ec = bela::make_error_code(L"PE file size tool small");
+  bela::pe::ImageView iv;
+  if (auto status = iv.Parse(mmv.subview()); status != bela::pe::ParseStatus::OK) {
+    ec = bela::make_error_code(bela::FileSizeTooSmall, bela::pe::ParseStatusMessage(status));
+    return std::nullopt;
+  }
+  bela::pe::ExportView ev;
+  if (!ev.Parse(iv)) {
+    ec = bela::make_error_code(L"no export directory");
+    return std::nullopt;
+  }
+  std::optional<bela::pe::Export> e;
+  uint32_t ordinal = 0;
+  if (name.size() > 1 && name[0] == L'#' && bela::SimpleAtoi(name.substr(1), &ordinal)) {
+    e = ev.FindOrdinal(ordinal);
+    // name table is scanned for the name of this slot, nothing is copied
+    for (size_t i = 0; e && i < ev.NumberOfNames(); i++) {
+      if (ev.NameIndex(i) == ordinal - ev.Base()) {
+        e->Name = ev.Name(i);
+        break;
+      }
+    }
+  } else {
+    e = ev.Find(bela::ToNarrow(name));
+  }
+  if (!e || (e->Address == 0 && e->Forwarder.empty())) {
+    ec = bela::make_error_code(L"export not found");
     return std::nullopt;
   }
-  switch (nh->OptionalHeader.Magic) {
-  case IMAGE_NT_OPTIONAL_HDR64_MAGIC:
-    return pecoff_dump(mv, (PIMAGE_NT_HEADERS64)nh, ec);
-  case IMAGE_NT_OPTIONAL_HDR32_MAGIC:
-    return pecoff_dump(mv, (PIMAGE_NT_HEADERS32)nh, ec);
-  case IMAGE_ROM_OPTIONAL_HDR_MAGIC: {
-    // ROM
-  } break;
-  default:
-    break;
-  }
-  return std::nullopt;
+  return std::make_optional(
+      pe_export_t{bela::ToWide(e->Name), bela::ToWide(e->Forwarder), e->Ordinal, e->Address});
 }
 
 } // namespace inquisitive
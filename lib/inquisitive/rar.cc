@@ -0,0 +1,400 @@
+/// RAR block headers and self-extracting archive search
+#include <bela/strcat.hpp>
+#include "inquisitive.hpp"
+#include "zip.hpp"
+
+// https://www.rarlab.com/technote.htm
+namespace inquisitive {
+constexpr const uint8_t rar5Signature[] = {0x52, 0x61, 0x72, 0x21, 0x1A, 0x07, 0x01, 0x00};
+constexpr const uint8_t rar4Signature[] = {0x52, 0x61, 0x72, 0x21, 0x1A, 0x07, 0x00};
+// RAR5 header size is limited to 2 MB, RAR4 header size is 16-bit
+constexpr size_t rar5_header_max = 2 * 1024 * 1024;
+constexpr size_t rar4_header_min = 7;
+// largest SFX module unrar searches, MAXSFXSIZE
+constexpr size_t sfx_search_size = 4 * 1024 * 1024;
+
+enum rar5_header_type_t : uint8_t {
+  rar5_main = 1,
+  rar5_file = 2,
+  rar5_service = 3,
+  rar5_encryption = 4,
+  rar5_end = 5
+};
+
+constexpr uint64_t rar5_flag_extra = 0x0001;
+constexpr uint64_t rar5_flag_data = 0x0002;
+constexpr uint64_t rar5_flag_split_before = 0x0008;
+
+enum rar4_header_type_t : uint8_t {
+  rar4_main = 0x73,
+  rar4_file = 0x74,
+  rar4_end = 0x7B
+};
+
+constexpr uint16_t rar4_flag_split_before = 0x0001;
+constexpr uint16_t rar4_flag_large = 0x0100;
+constexpr uint16_t rar4_flag_directory = 0x00E0;
+constexpr uint16_t rar4_flag_long_block = 0x8000;
+
+// seven bits per byte, low bits first, at most ten bytes
+bool rar5_vint(base::MemView mv, size_t &pos, uint64_t &v) {
+  v = 0;
+  for (int shift = 0; shift < 64 && pos < mv.size(); shift += 7) {
+    auto b = mv[pos++];
+    v |= static_cast<uint64_t>(b & 0x7F) << shift;
+    if ((b & 0x80) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// header CRC32 covers header size field and header data, block length includes data area
+bool rar5_header(base::WindowView &wv, uint64_t pos, base::MemView &hv, uint64_t &blocklen) {
+  bela::error_code ec;
+  // CRC32 and three bytes of header size vint are enough for any header under 2 MB
+  auto sv = wv.Window(pos, 7, ec);
+  size_t hpos = 4;
+  uint64_t hsize = 0;
+  if (sv.size() < 5 || !rar5_vint(sv, hpos, hsize) || hsize == 0 || hsize > rar5_header_max) {
+    return false;
+  }
+  auto crc = bela::readle<uint32_t>(sv.data());
+  auto total = hpos + static_cast<size_t>(hsize);
+  hv = wv.Window(pos, total, ec);
+  if (hv.size() != total || byte_crc32(hv.data() + 4, total - 4) != crc) {
+    return false;
+  }
+  hv = base::MemView(hv.data() + hpos, static_cast<size_t>(hsize));
+  blocklen = total;
+  return true;
+}
+
+bool rar5_walk(base::WindowView &wv, uint64_t offset, rar_minutiae_t &rm) {
+  auto pos = offset + sizeof(rar5Signature);
+  while (pos < wv.size()) {
+    base::MemView hv;
+    uint64_t blocklen = 0;
+    if (!rar5_header(wv, pos, hv, blocklen)) {
+      return false;
+    }
+    size_t hpos = 0;
+    uint64_t type = 0;
+    uint64_t flags = 0;
+    uint64_t extrasize = 0;
+    uint64_t datasize = 0;
+    if (!rar5_vint(hv, hpos, type) || !rar5_vint(hv, hpos, flags)) {
+      return false;
+    }
+    if ((flags & rar5_flag_extra) != 0 && !rar5_vint(hv, hpos, extrasize)) {
+      return false;
+    }
+    if ((flags & rar5_flag_data) != 0 && !rar5_vint(hv, hpos, datasize)) {
+      return false;
+    }
+    switch (type) {
+    case rar5_main: {
+      uint64_t af = 0;
+      if (!rar5_vint(hv, hpos, af)) {
+        return false;
+      }
+      rm.volume = (af & 0x0001) != 0;
+      rm.solid = (af & 0x0004) != 0;
+      rm.recovery = (af & 0x0008) != 0;
+      rm.locked = (af & 0x0010) != 0;
+    } break;
+    case rar5_file: {
+      uint64_t ff = 0;
+      uint64_t unpacked = 0;
+      if (!rar5_vint(hv, hpos, ff) || !rar5_vint(hv, hpos, unpacked)) {
+        return false;
+      }
+      // split file is counted in volume holding its first part
+      if ((flags & rar5_flag_split_before) != 0) {
+        break;
+      }
+      if ((ff & 0x0001) != 0) {
+        rm.directories++;
+        break;
+      }
+      rm.files++;
+      rm.packed += datasize;
+      // size unknown flag, file was compressed from a stream
+      if ((ff & 0x0008) == 0) {
+        rm.size += unpacked;
+      }
+    } break;
+    case rar5_encryption:
+      // every following header is encrypted
+      rm.encryptedheaders = true;
+      return true;
+    case rar5_end:
+      return true;
+    default:
+      break;
+    }
+    if (datasize > wv.size() - pos - blocklen) {
+      return false;
+    }
+    pos += blocklen + datasize;
+  }
+  return false;
+}
+
+bool rar4_walk(base::WindowView &wv, uint64_t offset, rar_minutiae_t &rm) {
+  bela::error_code ec;
+  auto pos = offset + sizeof(rar4Signature);
+  while (pos < wv.size()) {
+    auto sv = wv.Window(pos, rar4_header_min, ec);
+    if (sv.size() != rar4_header_min) {
+      return false;
+    }
+    auto type = sv[2];
+    auto flags = bela::readle<uint16_t>(sv.data() + 3);
+    auto hsize = bela::readle<uint16_t>(sv.data() + 5);
+    auto crc = bela::readle<uint16_t>(sv.data());
+    if (hsize < rar4_header_min) {
+      return false;
+    }
+    auto hv = wv.Window(pos, hsize, ec);
+    // HEAD_CRC is low 16 bits of CRC32 from HEAD_TYPE to end of header
+    if (hv.size() != hsize || static_cast<uint16_t>(byte_crc32(hv.data() + 2, hsize - 2)) != crc) {
+      return false;
+    }
+    uint64_t datasize = 0;
+    if ((flags & rar4_flag_long_block) != 0 && hsize >= 11) {
+      datasize = bela::readle<uint32_t>(hv.data() + 7);
+    }
+    switch (type) {
+    case rar4_main:
+      rm.volume = (flags & 0x0001) != 0;
+      rm.locked = (flags & 0x0004) != 0;
+      rm.solid = (flags & 0x0008) != 0;
+      rm.recovery = (flags & 0x0040) != 0;
+      if ((flags & 0x0080) != 0) {
+        rm.encryptedheaders = true;
+        return true;
+      }
+      break;
+    case rar4_file: {
+      if (hsize < 32) {
+        return false;
+      }
+      uint64_t unpacked = bela::readle<uint32_t>(hv.data() + 11);
+      if ((flags & rar4_flag_large) != 0) {
+        if (hsize < 40) {
+          return false;
+        }
+        datasize |= static_cast<uint64_t>(bela::readle<uint32_t>(hv.data() + 32)) << 32;
+        unpacked |= static_cast<uint64_t>(bela::readle<uint32_t>(hv.data() + 36)) << 32;
+      }
+      if ((flags & rar4_flag_split_before) != 0) {
+        break;
+      }
+      if ((flags & rar4_flag_directory) == rar4_flag_directory) {
+        rm.directories++;
+        break;
+      }
+      rm.files++;
+      rm.size += unpacked;
+      rm.packed += datasize;
+    } break;
+    case rar4_end:
+      return true;
+    default:
+      break;
+    }
+    if (datasize > wv.size() - pos - hsize) {
+      return false;
+    }
+    pos += hsize + datasize;
+  }
+  // RAR 2.x and older do not write end of archive block
+  return pos == wv.size();
+}
+
+// first header after signature must carry a valid CRC, SFX stubs keep signature as constant
+bool rar_verify(base::WindowView &wv, uint64_t offset, uint32_t version) {
+  bela::error_code ec;
+  if (version == 5) {
+    base::MemView hv;
+    uint64_t blocklen = 0;
+    return rar5_header(wv, offset + sizeof(rar5Signature), hv, blocklen);
+  }
+  auto pos = offset + sizeof(rar4Signature);
+  auto sv = wv.Window(pos, rar4_header_min, ec);
+  if (sv.size() != rar4_header_min || sv[2] != rar4_main) {
+    return false;
+  }
+  auto hsize = bela::readle<uint16_t>(sv.data() + 5);
+  auto crc = bela::readle<uint16_t>(sv.data());
+  auto hv = wv.Window(pos, hsize, ec);
+  return hsize >= rar4_header_min && hv.size() == hsize &&
+         static_cast<uint16_t>(byte_crc32(hv.data() + 2, hsize - 2)) == crc;
+}
+
+bool p7z_verify(base::WindowView &wv, uint64_t offset) {
+  bela::error_code ec;
+  uint8_t sh[32];
+  return wv.ReadAt(offset, sh, sizeof(sh), ec) == sizeof(sh) &&
+         byte_crc32(sh + 12, 20) == bela::readle<uint32_t>(sh + 8);
+}
+
+// ZIP SFX begins with local header of first central directory entry, UINT64_MAX when absent
+uint64_t zip_first_local(base::WindowView &wv) {
+  bela::error_code ec;
+  zip_directory_t zd;
+  if (!zip_directory_locate(wv, zd, ec) || zd.entries == 0) {
+    return UINT64_MAX;
+  }
+  auto cd = wv.Window(zd.offset, static_cast<size_t>((std::min)(zd.size, uint64_t(64 * 1024))), ec);
+  zip_central_reader reader(cd, zd.prefix);
+  zip_entry_t e;
+  return reader.next(e) ? e.localoffset : UINT64_MAX;
+}
+
+std::optional<sfx_archive_t> sfx_locate(base::WindowView &wv) {
+  // index of matched needle selects verification below
+  constexpr std::string_view needles[] = {{"Rar!\x1A\x07\x01\x00", 8},
+                                          {"Rar!\x1A\x07\x00", 7},
+                                          {"7z\xBC\xAF\x27\x1C", 6},
+                                          {"PK\x03\x04", 4}};
+  bela::error_code ec;
+  auto len = static_cast<size_t>((std::min)(wv.size(), uint64_t(sfx_search_size)));
+  std::optional<uint64_t> zipstart;
+  for (size_t pos = 1; pos < len;) {
+    // verifying a hit maps other windows, search window is fetched again and usually still mapped
+    auto mv = wv.Window(0, len, ec);
+    if (mv.size() != len) {
+      break;
+    }
+    auto data = mv.data();
+    size_t which = 0;
+    auto p = byte_search_any(data + pos, len - pos, needles, std::size(needles), which);
+    if (p == nullptr) {
+      break;
+    }
+    auto offset = static_cast<uint64_t>(p - data);
+    sfx_archive_t sa{offset, types::none};
+    switch (which) {
+    case 0:
+    case 1:
+      if (rar_verify(wv, offset, which == 0 ? 5 : 4)) {
+        sa.t = types::rar;
+      }
+      break;
+    case 2:
+      if (p7z_verify(wv, offset)) {
+        sa.t = types::p7z;
+      }
+      break;
+    default:
+      // ZIP SFX is confirmed by central directory at end of file
+      if (!zipstart) {
+        zipstart = zip_first_local(wv);
+      }
+      if (*zipstart == offset) {
+        sa.t = types::zip;
+      }
+      break;
+    }
+    if (sa.t != types::none) {
+      return std::make_optional(sa);
+    }
+    pos = offset + 1;
+  }
+  return std::nullopt;
+}
+
+std::optional<rar_minutiae_t> inquisitive_rar(std::wstring_view sv, bela::error_code &ec,
+                                              uint64_t offset) {
+  base::WindowView wv;
+  if (!wv.Open(sv, ec, offset + sizeof(rar4Signature))) {
+    return std::nullopt;
+  }
+  uint8_t sig[sizeof(rar5Signature)] = {0};
+  wv.ReadAt(offset, sig, sizeof(sig), ec);
+  rar_minutiae_t rm;
+  rm.offset = offset;
+  if (memcmp(sig, rar5Signature, sizeof(rar5Signature)) == 0) {
+    rm.version = 5;
+    rm.damaged = !rar5_walk(wv, offset, rm);
+  } else if (memcmp(sig, rar4Signature, sizeof(rar4Signature)) == 0) {
+    rm.version = 4;
+    rm.damaged = !rar4_walk(wv, offset, rm);
+  } else {
+    ec = bela::make_error_code(L"not a RAR archive");
+    return std::nullopt;
+  }
+  return std::make_optional(std::move(rm));
+}
+
+status_t inquisitive_rar_container(std::wstring_view sv, inquisitive_result_t &ir,
+                                   uint64_t offset) {
+  bela::error_code ec;
+  auto rm = inquisitive_rar(sv, ec, offset);
+  if (!rm) {
+    return None;
+  }
+  std::vector<std::wstring> flags;
+  if (rm->solid) {
+    flags.emplace_back(L"solid");
+  }
+  if (rm->volume) {
+    flags.emplace_back(L"volume");
+  }
+  if (rm->encryptedheaders) {
+    flags.emplace_back(L"encrypted headers");
+  }
+  if (rm->locked) {
+    flags.emplace_back(L"locked");
+  }
+  if (rm->recovery) {
+    flags.emplace_back(L"recovery record");
+  }
+  if (!flags.empty()) {
+    ir.add(L"Flags", flags);
+  }
+  // file headers of encrypted archive cannot be read without password
+  if (!rm->encryptedheaders) {
+    ir.add(L"Files", rm->files);
+    ir.add(L"Directories", rm->directories);
+    ir.add(L"Size", rm->size);
+    ir.add(L"Packed Size", rm->packed);
+  }
+  if (rm->damaged) {
+    ir.add(L"Damaged", std::wstring_view(L"block chain is broken or truncated"));
+  }
+  return Found;
+}
+
+status_t inquisitive_sfx_container(std::wstring_view sv, inquisitive_result_t &ir) {
+  base::WindowView wv;
+  bela::error_code ec;
+  if (!wv.Open(sv, ec)) {
+    return None;
+  }
+  auto sa = sfx_locate(wv);
+  if (!sa) {
+    return None;
+  }
+  ir.add(L"SFX Offset", sa->offset);
+  switch (sa->t) {
+  case types::rar:
+    ir.add(L"SFX Archive", std::wstring_view(L"RAR"));
+    return inquisitive_rar_container(sv, ir, sa->offset);
+  case types::p7z:
+    ir.add(L"SFX Archive", std::wstring_view(L"7z"));
+    return inquisitive_7z_container(sv, ir, sa->offset);
+  default:
+    break;
+  }
+  zip_directory_t zd;
+  ir.add(L"SFX Archive", std::wstring_view(L"ZIP"));
+  if (zip_directory_locate(wv, zd, ec)) {
+    ir.add(L"Entries", zd.entries);
+  }
+  return Found;
+}
+
+} // namespace inquisitive
@@ -0,0 +1,727 @@
+/// 7z start header and property database
+#include <bela/strcat.hpp>
+#include "inquisitive.hpp"
+
+// https://github.com/mcmilk/7-Zip-zstd/blob/master/DOC/7zFormat.txt
+namespace inquisitive {
+constexpr size_t p7z_start_header_size = 32;
+// property database larger than it is not mapped
+constexpr uint64_t p7z_header_max = 256 * 1024 * 1024;
+// coders and streams of one folder, 7-Zip itself writes at most 4 coders
+constexpr uint64_t p7z_coders_max = 64;
+
+enum p7z_property_t : uint8_t {
+  k7zEnd = 0x00,
+  k7zHeader = 0x01,
+  k7zArchiveProperties = 0x02,
+  k7zAdditionalStreamsInfo = 0x03,
+  k7zMainStreamsInfo = 0x04,
+  k7zFilesInfo = 0x05,
+  k7zPackInfo = 0x06,
+  k7zUnPackInfo = 0x07,
+  k7zSubStreamsInfo = 0x08,
+  k7zSize = 0x09,
+  k7zCRC = 0x0A,
+  k7zFolder = 0x0B,
+  k7zCodersUnPackSize = 0x0C,
+  k7zNumUnPackStream = 0x0D,
+  k7zEmptyStream = 0x0E,
+  k7zEmptyFile = 0x0F,
+  k7zName = 0x11,
+  k7zEncodedHeader = 0x17
+};
+
+constexpr uint64_t p7z_coder_copy = 0x00;
+constexpr uint64_t p7z_coder_lzma = 0x030101;
+constexpr uint64_t p7z_coder_lzma2 = 0x21;
+constexpr uint64_t p7z_coder_aes = 0x06F10701;
+
+// p7z_reader reads property database, read past end marks it bad and returns zero
+class p7z_reader {
+public:
+  p7z_reader(base::MemView mv) : mv_(mv) {}
+  uint8_t byte() {
+    if (pos_ >= mv_.size()) {
+      bad_ = true;
+      return 0;
+    }
+    return mv_[pos_++];
+  }
+  // leading one bits of first byte count extra little-endian bytes
+  uint64_t number() {
+    auto first = byte();
+    uint8_t mask = 0x80;
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++) {
+      if ((first & mask) == 0) {
+        return v | (static_cast<uint64_t>(first & (mask - 1)) << (8 * i));
+      }
+      v |= static_cast<uint64_t>(byte()) << (8 * i);
+      mask >>= 1;
+    }
+    return v;
+  }
+  base::MemView bytes(uint64_t n) {
+    if (n > remaining()) {
+      bad_ = true;
+      pos_ = mv_.size();
+      return base::MemView();
+    }
+    auto mv = base::MemView(mv_.data() + pos_, static_cast<size_t>(n));
+    pos_ += static_cast<size_t>(n);
+    return mv;
+  }
+  // count read from database must fit remaining bytes, or vectors could be huge
+  bool fits(uint64_t n, uint64_t perbyte = 1) {
+    if (n > remaining() * perbyte) {
+      bad_ = true;
+    }
+    return !bad_;
+  }
+  // bit vector, most significant bit first
+  bool bits(uint64_t n, std::vector<bool> &v) {
+    if (!fits(n, 8)) {
+      return false;
+    }
+    v.resize(static_cast<size_t>(n));
+    uint8_t b = 0;
+    for (size_t i = 0; i < v.size(); i++) {
+      if (i % 8 == 0) {
+        b = byte();
+      }
+      v[i] = (b & (0x80 >> (i % 8))) != 0;
+    }
+    return !bad_;
+  }
+  // all defined flag or bit vector, then CRC32 of each defined item
+  bool digests(uint64_t n, std::vector<bool> &defined) {
+    if (byte() != 0) {
+      if (!fits(n, 8)) {
+        return false;
+      }
+      defined.assign(static_cast<size_t>(n), true);
+    } else if (!bits(n, defined)) {
+      return false;
+    }
+    auto count = static_cast<uint64_t>(std::count(defined.begin(), defined.end(), true));
+    bytes(count * 4);
+    return !bad_;
+  }
+  size_t remaining() const { return mv_.size() - pos_; }
+  bool bad() const { return bad_; }
+
+private:
+  base::MemView mv_;
+  size_t pos_{0};
+  bool bad_{false};
+};
+
+struct p7z_coder_t {
+  uint64_t id{0};
+  base::MemView props;
+};
+
+struct p7z_folder_t {
+  std::vector<p7z_coder_t> coders;
+  std::vector<uint64_t> bindouts; /// output streams consumed by other coders
+  std::vector<uint64_t> unpacksizes;
+  std::vector<uint64_t> sizes; /// sizes of files but last one, which takes what is left
+  uint64_t outputs{0};
+  uint64_t packstreams{1}; /// coder inputs read from packed streams
+  uint64_t streams{1};     /// files stored in folder
+  bool crc{false};
+  // main output is the only one not bound to a coder input
+  uint64_t unpacked() const {
+    for (size_t i = 0; i < unpacksizes.size(); i++) {
+      if (std::find(bindouts.begin(), bindouts.end(), i) == bindouts.end()) {
+        return unpacksizes[i];
+      }
+    }
+    return 0;
+  }
+};
+
+struct p7z_streams_t {
+  uint64_t packpos{0};
+  uint64_t packed{0};
+  std::vector<uint64_t> packsizes;
+  std::vector<p7z_folder_t> folders;
+};
+
+// files of property database, entries are built from it and main streams
+struct p7z_files_t {
+  std::vector<std::wstring> names;
+  std::vector<bool> emptystreams;
+  std::vector<bool> emptyfiles;
+  uint64_t count{0};
+};
+
+bool p7z_pack_info(p7z_reader &r, p7z_streams_t &st) {
+  st.packpos = r.number();
+  auto n = r.number();
+  if (!r.fits(n)) {
+    return false;
+  }
+  for (;;) {
+    auto id = r.number();
+    if (r.bad()) {
+      return false;
+    }
+    if (id == k7zEnd) {
+      return true;
+    }
+    std::vector<bool> defined;
+    if (id == k7zSize) {
+      for (uint64_t i = 0; i < n; i++) {
+        st.packsizes.push_back(r.number());
+        st.packed += st.packsizes.back();
+      }
+    } else if (id != k7zCRC || !r.digests(n, defined)) {
+      return false;
+    }
+  }
+}
+
+bool p7z_folder(p7z_reader &r, p7z_folder_t &f) {
+  auto n = r.number();
+  if (n == 0 || n > p7z_coders_max) {
+    return false;
+  }
+  uint64_t inputs = 0;
+  for (uint64_t i = 0; i < n; i++) {
+    auto flags = r.byte();
+    auto idsize = flags & 0x0F;
+    // alternative methods were never written by any 7-Zip
+    if (idsize > 8 || (flags & 0x80) != 0) {
+      return false;
+    }
+    auto &c = f.coders.emplace_back();
+    for (int k = 0; k < idsize; k++) {
+      c.id = (c.id << 8) | r.byte();
+    }
+    uint64_t in = 1;
+    uint64_t out = 1;
+    if ((flags & 0x10) != 0) {
+      in = r.number();
+      out = r.number();
+    }
+    if (in > p7z_coders_max || out > p7z_coders_max) {
+      return false;
+    }
+    inputs += in;
+    f.outputs += out;
+    if ((flags & 0x20) != 0) {
+      c.props = r.bytes(r.number());
+    }
+  }
+  // every output but main one is bound to an input, the other inputs are packed streams
+  if (f.outputs == 0 || f.outputs - 1 > inputs) {
+    return false;
+  }
+  for (uint64_t i = 0; i + 1 < f.outputs; i++) {
+    r.number();
+    f.bindouts.push_back(r.number());
+  }
+  f.packstreams = inputs - (f.outputs - 1);
+  if (f.packstreams > 1) {
+    for (uint64_t i = 0; i < f.packstreams; i++) {
+      r.number();
+    }
+  }
+  return !r.bad();
+}
+
+bool p7z_unpack_info(p7z_reader &r, p7z_streams_t &st) {
+  if (r.number() != k7zFolder) {
+    return false;
+  }
+  auto n = r.number();
+  // external folders live in additional streams, no writer uses them
+  if (!r.fits(n) || r.byte() != 0) {
+    return false;
+  }
+  st.folders.resize(static_cast<size_t>(n));
+  for (auto &f : st.folders) {
+    if (!p7z_folder(r, f)) {
+      return false;
+    }
+  }
+  if (r.number() != k7zCodersUnPackSize) {
+    return false;
+  }
+  for (auto &f : st.folders) {
+    for (uint64_t i = 0; i < f.outputs; i++) {
+      f.unpacksizes.push_back(r.number());
+    }
+  }
+  for (;;) {
+    auto id = r.number();
+    if (r.bad()) {
+      return false;
+    }
+    if (id == k7zEnd) {
+      return true;
+    }
+    std::vector<bool> defined;
+    if (id != k7zCRC || !r.digests(n, defined)) {
+      return false;
+    }
+    for (size_t i = 0; i < st.folders.size(); i++) {
+      st.folders[i].crc = defined[i];
+    }
+  }
+}
+
+bool p7z_substreams_info(p7z_reader &r, p7z_streams_t &st) {
+  for (;;) {
+    auto id = r.number();
+    if (r.bad()) {
+      return false;
+    }
+    if (id == k7zEnd) {
+      return true;
+    }
+    std::vector<bool> defined;
+    switch (id) {
+    case k7zNumUnPackStream:
+      for (auto &f : st.folders) {
+        f.streams = r.number();
+        if (!r.fits(f.streams, 8)) {
+          return false;
+        }
+      }
+      break;
+    case k7zSize:
+      // last stream of folder takes whatever is left
+      for (auto &f : st.folders) {
+        for (uint64_t i = 1; i < f.streams && !r.bad(); i++) {
+          f.sizes.push_back(r.number());
+        }
+      }
+      break;
+    case k7zCRC: {
+      // folder CRC already covers folder with one stream
+      uint64_t n = 0;
+      for (const auto &f : st.folders) {
+        n += (f.streams == 1 && f.crc) ? 0 : f.streams;
+      }
+      if (!r.digests(n, defined)) {
+        return false;
+      }
+    } break;
+    default:
+      return false;
+    }
+  }
+}
+
+bool p7z_streams_info(p7z_reader &r, p7z_streams_t &st) {
+  for (;;) {
+    auto id = r.number();
+    if (r.bad()) {
+      return false;
+    }
+    bool ok = false;
+    switch (id) {
+    case k7zEnd:
+      return true;
+    case k7zPackInfo:
+      ok = p7z_pack_info(r, st);
+      break;
+    case k7zUnPackInfo:
+      ok = p7z_unpack_info(r, st);
+      break;
+    case k7zSubStreamsInfo:
+      ok = p7z_substreams_info(r, st);
+      break;
+    default:
+      break;
+    }
+    if (!ok) {
+      return false;
+    }
+  }
+}
+
+// UTF-16LE names, each one is NUL terminated
+void p7z_names(p7z_reader &r, uint64_t n, std::vector<std::wstring> &names) {
+  // names stored in additional streams, no writer uses them
+  if (r.byte() != 0) {
+    return;
+  }
+  for (uint64_t i = 0; i < n && r.remaining() >= 2; i++) {
+    auto &name = names.emplace_back();
+    for (;;) {
+      auto lo = r.byte();
+      auto c = static_cast<uint16_t>(lo | (r.byte() << 8));
+      if (c == 0 || r.bad()) {
+        break;
+      }
+      name.push_back(static_cast<wchar_t>(c));
+    }
+  }
+}
+
+// directories are empty streams which are not empty files, names are read when files is set
+bool p7z_files_info(p7z_reader &r, p7z_minutiae_t &pm, p7z_files_t *files) {
+  auto n = r.number();
+  if (!r.fits(n, 8)) {
+    return false;
+  }
+  p7z_files_t local;
+  auto &fs = files != nullptr ? *files : local;
+  auto &emptystreams = fs.emptystreams;
+  auto &emptyfiles = fs.emptyfiles;
+  fs.count = n;
+  for (;;) {
+    auto type = r.number();
+    if (r.bad()) {
+      return false;
+    }
+    if (type == k7zEnd) {
+      break;
+    }
+    p7z_reader pr(r.bytes(r.number()));
+    if (r.bad()) {
+      return false;
+    }
+    if (type == k7zEmptyStream) {
+      pr.bits(n, emptystreams);
+    } else if (type == k7zEmptyFile) {
+      pr.bits(std::count(emptystreams.begin(), emptystreams.end(), true), emptyfiles);
+    } else if (type == k7zName && files != nullptr) {
+      p7z_names(pr, n, files->names);
+    }
+  }
+  uint64_t directories = 0;
+  size_t k = 0;
+  for (auto empty : emptystreams) {
+    if (empty) {
+      directories += (k >= emptyfiles.size() || !emptyfiles[k]) ? 1 : 0;
+      k++;
+    }
+  }
+  pm.directories = directories;
+  pm.files = n - directories;
+  return true;
+}
+
+std::wstring p7z_dictionary(uint64_t dict) {
+  if (dict != 0 && (dict & (dict - 1)) == 0) {
+    int log = 0;
+    for (; (uint64_t(1) << log) < dict; log++) {
+    }
+    return bela::StringCat(log);
+  }
+  if (dict % (1024 * 1024) == 0) {
+    return bela::StringCat(dict / (1024 * 1024), L"m");
+  }
+  if (dict % 1024 == 0) {
+    return bela::StringCat(dict / 1024, L"k");
+  }
+  return bela::StringCat(dict);
+}
+
+std::wstring p7z_coder_name(const p7z_coder_t &c) {
+  switch (c.id) {
+  case p7z_coder_copy:
+    return L"Copy";
+  case 0x03:
+    return L"Delta";
+  case p7z_coder_lzma:
+    if (c.props.size() == 5) {
+      return bela::StringCat(L"LZMA:", p7z_dictionary(bela::readle<uint32_t>(c.props.data() + 1)));
+    }
+    return L"LZMA";
+  case p7z_coder_lzma2:
+    if (c.props.size() == 1 && c.props[0] < 40) {
+      auto p = c.props[0];
+      return bela::StringCat(L"LZMA2:", p7z_dictionary(uint64_t(2 | (p & 1)) << (p / 2 + 11)));
+    }
+    return L"LZMA2";
+  case 0x030401:
+    return L"PPMD";
+  case 0x03030103:
+    return L"BCJ";
+  case 0x0303011B:
+    return L"BCJ2";
+  case 0x03030205:
+    return L"PPC";
+  case 0x03030401:
+    return L"IA64";
+  case 0x03030501:
+    return L"ARM";
+  case 0x03030701:
+    return L"ARMT";
+  case 0x03030805:
+    return L"SPARC";
+  case 0x0A:
+    return L"ARM64";
+  case 0x040108:
+    return L"Deflate";
+  case 0x040109:
+    return L"Deflate64";
+  case 0x040202:
+    return L"BZip2";
+  case 0x04F71101:
+    return L"ZSTD";
+  case 0x04F71102:
+    return L"Brotli";
+  case 0x04F71104:
+    return L"LZ4";
+  case p7z_coder_aes:
+    return L"7zAES";
+  default:
+    break;
+  }
+  return bela::StringCat(L"0x", bela::AlphaNum(bela::Hex(c.id)));
+}
+
+// 7-Zip lists coders from last to first, such as LZMA2:24 BCJ
+std::wstring p7z_method(const p7z_folder_t &f, bool &encrypted) {
+  std::wstring s;
+  for (auto it = f.coders.rbegin(); it != f.coders.rend(); it++) {
+    if (!s.empty()) {
+      s.push_back(L' ');
+    }
+    s.append(p7z_coder_name(*it));
+    encrypted = encrypted || it->id == p7z_coder_aes;
+  }
+  return s;
+}
+
+bool p7z_header(p7z_reader &r, p7z_minutiae_t &pm, p7z_streams_t &main, p7z_files_t *files) {
+  for (;;) {
+    auto id = r.number();
+    if (r.bad()) {
+      return false;
+    }
+    if (id == k7zEnd) {
+      break;
+    }
+    p7z_streams_t additional;
+    bool ok = false;
+    switch (id) {
+    case k7zArchiveProperties:
+      for (;;) {
+        auto type = r.number();
+        if (type == k7zEnd || r.bad()) {
+          break;
+        }
+        r.bytes(r.number());
+      }
+      ok = !r.bad();
+      break;
+    case k7zAdditionalStreamsInfo:
+      ok = p7z_streams_info(r, additional);
+      break;
+    case k7zMainStreamsInfo:
+      ok = p7z_streams_info(r, main);
+      break;
+    case k7zFilesInfo:
+      ok = p7z_files_info(r, pm, files);
+      break;
+    default:
+      break;
+    }
+    if (!ok) {
+      return false;
+    }
+  }
+  pm.folders = main.folders.size();
+  pm.packed = main.packed;
+  for (const auto &f : main.folders) {
+    pm.size += f.unpacked();
+    auto method = p7z_method(f, pm.encrypted);
+    if (std::find(pm.methods.begin(), pm.methods.end(), method) == pm.methods.end()) {
+      pm.methods.emplace_back(std::move(method));
+    }
+  }
+  pm.decoded = true;
+  return true;
+}
+
+// files with stream take substreams of folders in order, folder of one Copy coder is one packed
+// stream holding its files back to back
+bool p7z_locate(const p7z_streams_t &st, const p7z_files_t &fs, uint64_t base,
+                std::vector<p7z_entry_t> &entries) {
+  size_t folder = 0;
+  uint64_t stream = 0;
+  uint64_t inner = 0;
+  size_t packindex = 0;
+  uint64_t packoffset = st.packpos;
+  size_t k = 0;
+  for (uint64_t i = 0; i < fs.count; i++) {
+    std::wstring_view name = i < fs.names.size() ? std::wstring_view(fs.names[i]) : L"";
+    if (i < fs.emptystreams.size() && fs.emptystreams[i]) {
+      auto file = k < fs.emptyfiles.size() && fs.emptyfiles[k];
+      k++;
+      if (file) {
+        auto &e = entries.emplace_back();
+        e.name.assign(name);
+        e.stored = true;
+      }
+      continue;
+    }
+    while (folder < st.folders.size() && stream >= st.folders[folder].streams) {
+      for (uint64_t n = 0; n < st.folders[folder].packstreams && packindex < st.packsizes.size();
+           n++) {
+        packoffset += st.packsizes[packindex++];
+      }
+      folder++;
+      stream = 0;
+      inner = 0;
+    }
+    if (folder == st.folders.size()) {
+      return false;
+    }
+    const auto &f = st.folders[folder];
+    auto unpacked = f.unpacked();
+    uint64_t size = unpacked - inner;
+    if (stream + 1 < f.streams) {
+      if (stream >= f.sizes.size()) {
+        return false;
+      }
+      size = f.sizes[stream];
+    }
+    if (inner > unpacked || size > unpacked - inner) {
+      return false;
+    }
+    auto &e = entries.emplace_back();
+    e.name.assign(name);
+    e.size = size;
+    if (f.streams == 1 && packindex < st.packsizes.size()) {
+      e.packed = st.packsizes[packindex];
+    }
+    e.stored = f.coders.size() == 1 && f.coders[0].id == p7z_coder_copy && f.packstreams == 1 &&
+               packindex < st.packsizes.size() && st.packsizes[packindex] == unpacked;
+    if (e.stored) {
+      e.offset = base + packoffset + inner;
+    }
+    e.encrypted = std::any_of(f.coders.begin(), f.coders.end(),
+                              [](const p7z_coder_t &c) { return c.id == p7z_coder_aes; });
+    inner += size;
+    stream++;
+  }
+  return true;
+}
+
+std::optional<p7z_minutiae_t> inquisitive_7z(std::wstring_view sv, bela::error_code &ec,
+                                            uint64_t offset) {
+  base::WindowView wv;
+  if (!wv.Open(sv, ec, offset + p7z_start_header_size)) {
+    return std::nullopt;
+  }
+  return inquisitive_7z(wv, ec, offset, nullptr);
+}
+
+std::optional<p7z_minutiae_t> inquisitive_7z(base::WindowView &wv, bela::error_code &ec,
+                                            uint64_t offset, std::vector<p7z_entry_t> *entries) {
+  constexpr const uint8_t k7zSignature[] = {'7', 'z', 0xBC, 0xAF, 0x27, 0x1C};
+  uint8_t sh[p7z_start_header_size];
+  if (wv.ReadAt(offset, sh, sizeof(sh), ec) != sizeof(sh) ||
+      memcmp(sh, k7zSignature, sizeof(k7zSignature)) != 0) {
+    ec = bela::make_error_code(L"not a 7z archive");
+    return std::nullopt;
+  }
+  if (byte_crc32(sh + 12, 20) != bela::readle<uint32_t>(sh + 8)) {
+    ec = bela::make_error_code(bela::ParseBroken, L"7z start header CRC mismatch");
+    return std::nullopt;
+  }
+  p7z_minutiae_t pm;
+  pm.major = sh[6];
+  pm.minor = sh[7];
+  auto nextoffset = bela::readle<uint64_t>(sh + 12);
+  pm.headersize = bela::readle<uint64_t>(sh + 20);
+  auto nextcrc = bela::readle<uint32_t>(sh + 28);
+  // offsets are relative to end of start header, SFX stub comes before signature
+  auto base = offset + p7z_start_header_size;
+  auto limit = wv.size() - base;
+  // archive still being written or cut short has no next header
+  if (nextoffset > limit || pm.headersize > limit - nextoffset) {
+    ec = bela::make_error_code(bela::ParseBroken, L"7z next header beyond end of file");
+    return std::nullopt;
+  }
+  if (pm.headersize == 0) {
+    pm.decoded = true;
+    return std::make_optional(std::move(pm));
+  }
+  if (pm.headersize > p7z_header_max) {
+    ec = bela::make_error_code(bela::ParseBroken, L"7z header too large: ", pm.headersize);
+    return std::nullopt;
+  }
+  auto hv = wv.Window(base + nextoffset, static_cast<size_t>(pm.headersize), ec);
+  if (hv.size() != pm.headersize || byte_crc32(hv.data(), hv.size()) != nextcrc) {
+    ec = bela::make_error_code(bela::ParseBroken, L"7z header CRC mismatch");
+    return std::nullopt;
+  }
+  p7z_reader r(hv);
+  p7z_streams_t main;
+  p7z_files_t fs;
+  auto files = entries != nullptr ? &fs : nullptr;
+  auto id = r.number();
+  if (id == k7zHeader) {
+    if (!p7z_header(r, pm, main, files)) {
+      ec = bela::make_error_code(bela::ParseBroken, L"7z header damaged");
+      return std::nullopt;
+    }
+  } else if (id == k7zEncodedHeader) {
+    // encoded header is packed like file data, usually with LZMA which we do not decode
+    p7z_streams_t st;
+    if (!p7z_streams_info(r, st) || st.folders.size() != 1) {
+      ec = bela::make_error_code(bela::ParseBroken, L"7z encoded header damaged");
+      return std::nullopt;
+    }
+    const auto &f = st.folders[0];
+    pm.headermethod = p7z_method(f, pm.encrypted);
+    pm.headerpacked = st.packed;
+    pm.headersize = f.unpacked();
+    // stored header is read in place
+    if (f.coders.size() == 1 && f.coders[0].id == p7z_coder_copy && st.packpos <= limit &&
+        st.packed <= limit - st.packpos && st.packed <= p7z_header_max) {
+      p7z_reader sr(wv.Window(base + st.packpos, static_cast<size_t>(st.packed), ec));
+      if (sr.number() == k7zHeader) {
+        p7z_header(sr, pm, main, files);
+      }
+    }
+  } else {
+    ec = bela::make_error_code(bela::ParseBroken, L"7z header damaged");
+    return std::nullopt;
+  }
+  if (entries != nullptr && pm.decoded && !p7z_locate(main, fs, base, *entries)) {
+    ec = bela::make_error_code(bela::ParseBroken, L"7z streams do not match files");
+    return std::nullopt;
+  }
+  return std::make_optional(std::move(pm));
+}
+
+status_t inquisitive_7z_container(std::wstring_view sv, inquisitive_result_t &ir,
+                                  uint64_t offset) {
+  bela::error_code ec;
+  auto pm = inquisitive_7z(sv, ec, offset);
+  if (!pm) {
+    ir.add(L"Damaged", ec.message);
+    return None;
+  }
+  if (pm->decoded) {
+    ir.add(L"Files", pm->files);
+    ir.add(L"Directories", pm->directories);
+    ir.add(L"Size", pm->size);
+    ir.add(L"Packed Size", pm->packed);
+    ir.add(L"Folders", pm->folders);
+    if (!pm->methods.empty()) {
+      ir.add(L"Methods", pm->methods);
+    }
+  }
+  if (!pm->headermethod.empty()) {
+    ir.add(L"Header Method", pm->headermethod);
+    ir.add(L"Header Packed Size", pm->headerpacked);
+  }
+  ir.add(L"Header Size", pm->headersize);
+  if (pm->encrypted) {
+    ir.add(L"Encrypted", std::wstring_view(pm->decoded ? L"data" : L"header or data"));
+  }
+  return Found;
+}
+
+} // namespace inquisitive
@@ -0,0 +1,218 @@
+/// SQLite schema from page 1 b-tree, libsqlite is not needed
+#include <bela/codecvt.hpp>
+#include "inquisitive.hpp"
+
+// https://www.sqlite.org/fileformat.html
+namespace inquisitive {
+constexpr size_t sqlite_header_size = 100;
+// schema of a few hundred tables fits in tens of pages, budget also stops page cycles
+constexpr size_t sqlite_schema_pages_max = 256;
+// usable page size is at least 480 bytes
+constexpr uint32_t sqlite_usable_min = 480;
+
+enum sqlite_page_type_t : uint8_t {
+  sqlite_interior_table = 0x05,
+  sqlite_leaf_table = 0x0D,
+};
+
+uint32_t sqlite_page_size(uint16_t v) {
+  uint32_t size = v == 1 ? 65536 : v;
+  return (size >= 512 && (size & (size - 1)) == 0) ? size : 0;
+}
+
+// big-endian, high bit continues, ninth byte contributes all 8 bits
+bool sqlite_varint(base::MemView mv, size_t &pos, uint64_t &v) {
+  v = 0;
+  for (int i = 0; i < 9; i++) {
+    if (pos >= mv.size()) {
+      return false;
+    }
+    auto b = mv[pos++];
+    if (i == 8) {
+      v = (v << 8) | b;
+      return true;
+    }
+    v = (v << 7) | (b & 0x7F);
+    if ((b & 0x80) == 0) {
+      return true;
+    }
+  }
+  return true;
+}
+
+// bytes of leaf table cell payload stored on page, the rest spills to overflow pages
+uint64_t sqlite_local_payload(uint64_t payload, uint32_t usable) {
+  uint64_t x = usable - 35;
+  if (payload <= x) {
+    return payload;
+  }
+  uint64_t m = (uint64_t(usable - 12) * 32 / 255) - 23;
+  uint64_t k = m + (payload - m) % (usable - 4);
+  return k <= x ? k : m;
+}
+
+std::wstring sqlite_text(base::MemView mv, uint32_t encoding) {
+  if (encoding != 2 && encoding != 3) {
+    return bela::ToWide(reinterpret_cast<const char *>(mv.data()), mv.size());
+  }
+  std::wstring s;
+  s.reserve(mv.size() / 2);
+  for (size_t i = 0; i + 1 < mv.size(); i += 2) {
+    s.push_back(static_cast<wchar_t>(encoding == 2 ? bela::readle<uint16_t>(mv.data() + i)
+                                                   : bela::readbe<uint16_t>(mv.data() + i)));
+  }
+  return s;
+}
+
+// row columns are type, name, tbl_name, rootpage and sql, only first two are read
+bool sqlite_schema_row(base::MemView payload, uint32_t encoding, sqlite_schema_t &ss) {
+  size_t pos = 0;
+  uint64_t hsize = 0;
+  uint64_t coltype = 0;
+  uint64_t colname = 0;
+  if (!sqlite_varint(payload, pos, hsize) || hsize > payload.size() ||
+      !sqlite_varint(payload, pos, coltype) || !sqlite_varint(payload, pos, colname) ||
+      pos > hsize) {
+    return false;
+  }
+  // text serial types are odd and at least 13
+  if (coltype < 13 || coltype % 2 == 0 || colname < 13 || colname % 2 == 0) {
+    return false;
+  }
+  auto typelen = (coltype - 13) / 2;
+  auto namelen = (colname - 13) / 2;
+  // long name may continue on overflow page, such row is skipped
+  if (typelen > payload.size() - hsize || namelen > payload.size() - hsize - typelen) {
+    return false;
+  }
+  auto type = sqlite_text(base::MemView(payload.data() + hsize, typelen), encoding);
+  auto name = sqlite_text(base::MemView(payload.data() + hsize + typelen, namelen), encoding);
+  if (type == L"table") {
+    ss.tables.emplace_back(std::move(name));
+  } else if (type == L"view") {
+    ss.views.emplace_back(std::move(name));
+  } else if (type == L"index") {
+    ss.indexes++;
+  } else if (type == L"trigger") {
+    ss.triggers++;
+  }
+  return true;
+}
+
+// cells of one page are read before next window is mapped, so page view stays valid
+bool sqlite_schema_page(base::MemView pv, uint32_t pgno, uint32_t usable, uint32_t encoding,
+                        std::vector<uint32_t> &children, sqlite_schema_t &ss) {
+  // page 1 b-tree header follows database header
+  size_t hdr = pgno == 1 ? sqlite_header_size : 0;
+  if (hdr + 12 > usable) {
+    return false;
+  }
+  auto type = pv[hdr];
+  auto cells = bela::readbe<uint16_t>(pv.data() + hdr + 3);
+  size_t ptrs = hdr + (type == sqlite_interior_table ? 12 : 8);
+  if ((type != sqlite_interior_table && type != sqlite_leaf_table) ||
+      ptrs + size_t(cells) * 2 > usable) {
+    return false;
+  }
+  bool ok = true;
+  for (size_t i = 0; i < cells; i++) {
+    size_t cell = bela::readbe<uint16_t>(pv.data() + ptrs + i * 2);
+    if (cell >= usable) {
+      ok = false;
+      continue;
+    }
+    auto cv = base::MemView(pv.data() + cell, usable - cell);
+    if (type == sqlite_interior_table) {
+      if (cv.size() < 4) {
+        ok = false;
+        continue;
+      }
+      children.push_back(bela::readbe<uint32_t>(cv.data()));
+      continue;
+    }
+    size_t pos = 0;
+    uint64_t payload = 0;
+    uint64_t rowid = 0;
+    if (!sqlite_varint(cv, pos, payload) || !sqlite_varint(cv, pos, rowid)) {
+      ok = false;
+      continue;
+    }
+    auto local = sqlite_local_payload(payload, usable);
+    if (local > cv.size() - pos ||
+        !sqlite_schema_row(base::MemView(cv.data() + pos, static_cast<size_t>(local)), encoding,
+                           ss)) {
+      ok = false;
+    }
+  }
+  if (type == sqlite_interior_table) {
+    children.push_back(bela::readbe<uint32_t>(pv.data() + hdr + 8));
+  }
+  return ok;
+}
+
+std::optional<sqlite_schema_t> inquisitive_sqlite(std::wstring_view sv, bela::error_code &ec) {
+  base::WindowView wv;
+  if (!wv.Open(sv, ec, sqlite_header_size)) {
+    return std::nullopt;
+  }
+  uint8_t hd[sqlite_header_size];
+  if (wv.ReadAt(0, hd, sizeof(hd), ec) != sizeof(hd) ||
+      memcmp(hd, "SQLite format 3\0", 16) != 0) {
+    ec = bela::make_error_code(L"not a SQLite database");
+    return std::nullopt;
+  }
+  sqlite_schema_t ss;
+  ss.pagesize = sqlite_page_size(bela::readbe<uint16_t>(hd + 16));
+  auto usable = ss.pagesize - hd[20];
+  if (ss.pagesize == 0 || usable < sqlite_usable_min) {
+    ec = bela::make_error_code(bela::ParseBroken, L"SQLite page size invalid");
+    return std::nullopt;
+  }
+  auto encoding = bela::readbe<uint32_t>(hd + 56);
+  // depth first in rowid order, children are pushed in reverse
+  std::vector<uint32_t> pages{1};
+  std::vector<uint32_t> children;
+  for (size_t visited = 0; !pages.empty(); visited++) {
+    if (visited == sqlite_schema_pages_max) {
+      ss.truncated = true;
+      break;
+    }
+    auto pgno = pages.back();
+    pages.pop_back();
+    // page numbers start at 1, child pointer 0 is damage
+    if (pgno == 0) {
+      ss.truncated = true;
+      continue;
+    }
+    auto pv = wv.Window(uint64_t(pgno - 1) * ss.pagesize, ss.pagesize, ec);
+    children.clear();
+    if (pv.size() != ss.pagesize ||
+        !sqlite_schema_page(pv, pgno, usable, encoding, children, ss)) {
+      ss.truncated = true;
+    }
+    pages.insert(pages.end(), children.rbegin(), children.rend());
+  }
+  return std::make_optional(std::move(ss));
+}
+
+status_t inquisitive_sqlite_container(std::wstring_view sv, inquisitive_result_t &ir) {
+  bela::error_code ec;
+  auto ss = inquisitive_sqlite(sv, ec);
+  if (!ss) {
+    return None;
+  }
+  if (!ss->tables.empty()) {
+    ir.add(L"Tables", ss->tables);
+  }
+  if (!ss->views.empty()) {
+    ir.add(L"Views", ss->views);
+  }
+  ir.add(L"Indexes", ss->indexes);
+  ir.add(L"Triggers", ss->triggers);
+  if (ss->truncated) {
+    ir.add(L"Schema", std::wstring_view(L"incomplete, page missing or damaged"));
+  }
+  return Found;
+}
+
+} // namespace inquisitive
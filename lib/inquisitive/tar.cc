@@ -0,0 +1,340 @@
+/// TAR walker
+#include <cstddef>
+#include <cstring>
+#include <charconv>
+#include <algorithm>
+#include "inquisitive.hpp"
+#include "tar.hpp"
+
+namespace inquisitive {
+
+bool tar_number(const char *field, size_t len, uint64_t &v) {
+  auto p = reinterpret_cast<const uint8_t *>(field);
+  v = 0;
+  if ((p[0] & 0x80) != 0) {
+    // base-256, negative values (0xFF) are not sizes or offsets
+    if (p[0] == 0xFF) {
+      return false;
+    }
+    v = p[0] & 0x7F;
+    for (size_t i = 1; i < len; i++) {
+      if ((v >> 56) != 0) {
+        return false;
+      }
+      v = (v << 8) | p[i];
+    }
+    return true;
+  }
+  size_t i = 0;
+  while (i < len && (p[i] == ' ' || p[i] == 0)) {
+    i++;
+  }
+  for (; i < len && p[i] >= '0' && p[i] <= '7'; i++) {
+    v = (v << 3) | (p[i] - '0');
+  }
+  return i == len || p[i] == ' ' || p[i] == 0;
+}
+
+bool tar_checksum(const uint8_t *block) {
+  auto hd = reinterpret_cast<const ustar_header_t *>(block);
+  uint64_t expected = 0;
+  if (!tar_number(hd->checksum, sizeof(hd->checksum), expected)) {
+    return false;
+  }
+  constexpr size_t begin = offsetof(ustar_header_t, checksum);
+  constexpr size_t end = begin + sizeof(hd->checksum);
+  uint64_t usum = 0;
+  int64_t ssum = 0;
+  for (size_t i = 0; i < tar_block_size; i++) {
+    auto ch = (i >= begin && i < end) ? uint8_t(' ') : block[i];
+    usum += ch;
+    ssum += static_cast<int8_t>(ch);
+  }
+  return usum == expected || static_cast<uint64_t>(ssum) == expected;
+}
+
+inline std::string_view tar_field(const char *field, size_t len) {
+  return std::string_view(field, byte_strnlen(field, len));
+}
+
+// member data is padded to whole blocks, 0 on overflow
+inline uint64_t tar_padded(uint64_t size) {
+  auto padded = (size + tar_block_size - 1) / tar_block_size * tar_block_size;
+  return padded < size ? 0 : padded;
+}
+
+template <typename I> bool tar_decimal(std::string_view sv, I &v) {
+  auto r = std::from_chars(sv.data(), sv.data() + sv.size(), v);
+  return r.ec == std::errc{} && r.ptr == sv.data() + sv.size();
+}
+
+void tar_pax_t::merge(const tar_pax_t &global) {
+  if (path.empty()) {
+    path = global.path;
+  }
+  if (linkpath.empty()) {
+    linkpath = global.linkpath;
+  }
+  if (!size) {
+    size = global.size;
+  }
+  if (!realsize) {
+    realsize = global.realsize;
+  }
+  if (!mtime) {
+    mtime = global.mtime;
+  }
+  if (sparsename.empty()) {
+    sparsename = global.sparsename;
+  }
+  sparse = sparse || global.sparse;
+}
+
+bool tar_pax_parse(std::string_view sv, tar_pax_t &pax) {
+  // some writers pad payload with NUL
+  while (!sv.empty() && sv[0] != 0) {
+    size_t len = 0;
+    auto r = std::from_chars(sv.data(), sv.data() + sv.size(), len);
+    auto n = static_cast<size_t>(r.ptr - sv.data());
+    if (r.ec != std::errc{} || n >= sv.size() || sv[n] != ' ' || len <= n + 1 ||
+        len > sv.size() || sv[len - 1] != '\n') {
+      return false;
+    }
+    auto record = sv.substr(n + 1, len - n - 2);
+    sv.remove_prefix(len);
+    auto eq = record.find('=');
+    if (eq == std::string_view::npos) {
+      return false;
+    }
+    auto key = record.substr(0, eq);
+    auto value = record.substr(eq + 1);
+    if (key.substr(0, 11) == "GNU.sparse.") {
+      pax.sparse = true;
+    }
+    // empty value removes the key
+    if (key == "path") {
+      pax.path.assign(value);
+    } else if (key == "linkpath") {
+      pax.linkpath.assign(value);
+    } else if (key == "size") {
+      // size decides where next header is, so it must be valid
+      uint64_t v = 0;
+      if (value.empty()) {
+        pax.size.reset();
+      } else if (!tar_decimal(value, v)) {
+        return false;
+      } else {
+        pax.size = v;
+      }
+    } else if (key == "mtime") {
+      // seconds with optional fraction
+      int64_t v = 0;
+      if (tar_decimal(value.substr(0, value.find('.')), v)) {
+        pax.mtime = v;
+      } else {
+        pax.mtime.reset();
+      }
+    } else if (key == "GNU.sparse.name") {
+      pax.sparsename.assign(value);
+    } else if (key == "GNU.sparse.realsize" || key == "GNU.sparse.size") {
+      // 1.0 and 0.x names of expanded size
+      uint64_t v = 0;
+      if (tar_decimal(value, v)) {
+        pax.realsize = v;
+      } else {
+        pax.realsize.reset();
+      }
+    }
+  }
+  return true;
+}
+
+tar_reader::tar_reader(HANDLE stream) : stream_(stream) {
+  // redirected file can be read at any offset, pipe only forward
+  LARGE_INTEGER li;
+  if (GetFileType(stream) == FILE_TYPE_DISK && GetFileSizeEx(stream, &li) == TRUE) {
+    seekable_ = true;
+    size_ = static_cast<uint64_t>(li.QuadPart);
+  }
+}
+
+// pipe data before off is read and dropped, that is the only way to skip it
+bool tar_reader::skip(uint64_t off) {
+  if (off < streampos_) {
+    return false;
+  }
+  constexpr size_t chunk = 64 * 1024;
+  if (buffer_.size() < chunk) {
+    buffer_.resize(chunk);
+  }
+  while (streampos_ < off) {
+    auto n = static_cast<DWORD>((std::min)(off - streampos_, uint64_t(buffer_.size())));
+    DWORD got = 0;
+    if (ReadFile(stream_, buffer_.data(), n, &got, nullptr) != TRUE || got == 0) {
+      // member data ends before its size
+      bad_ = true;
+      return false;
+    }
+    streampos_ += got;
+  }
+  return true;
+}
+
+// mapped archive returns view into window, stream copies into buffer. Either is valid until next
+// fetch only.
+const uint8_t *tar_reader::fetch(uint64_t off, size_t len) {
+  if (wv_ != nullptr) {
+    bela::error_code ec;
+    auto mv = wv_->Window(off, len, ec);
+    return mv.size() == len ? mv.data() : nullptr;
+  }
+  if (!seekable_ && !skip(off)) {
+    return nullptr;
+  }
+  buffer_.resize(len);
+  size_t total = 0;
+  while (total < len) {
+    DWORD got = 0;
+    auto n = static_cast<DWORD>(len - total);
+    BOOL ok = FALSE;
+    if (seekable_) {
+      // positioned read like pread, data between headers is never touched
+      OVERLAPPED ov{};
+      ov.Offset = static_cast<DWORD>(off + total);
+      ov.OffsetHigh = static_cast<DWORD>((off + total) >> 32);
+      ok = ReadFile(stream_, buffer_.data() + total, n, &got, &ov);
+    } else {
+      ok = ReadFile(stream_, buffer_.data() + total, n, &got, nullptr);
+      streampos_ += got;
+    }
+    if (ok != TRUE || got == 0) {
+      return nullptr;
+    }
+    total += got;
+  }
+  return buffer_.data();
+}
+
+bool tar_reader::next(tar_entry_t &e) {
+  if (bad_) {
+    return false;
+  }
+  // pax and GNU long name headers describe the member which follows them
+  tar_pax_t pax;
+  std::string longname;
+  std::string longlink;
+  for (;;) {
+    auto block = fetch(pos_, tar_block_size);
+    if (block == nullptr) {
+      // archive without end-of-archive blocks ends here too
+      return false;
+    }
+    // end of archive is marked by zero blocks
+    constexpr uint8_t zeroBlock[tar_block_size] = {0};
+    if (block[0] == 0 && memcmp(block, zeroBlock, tar_block_size) == 0) {
+      return false;
+    }
+    if (!tar_checksum(block)) {
+      bad_ = true;
+      return false;
+    }
+    auto hd = reinterpret_cast<const ustar_header_t *>(block);
+    uint64_t size = 0;
+    if (!tar_number(hd->size, sizeof(hd->size), size)) {
+      bad_ = true;
+      return false;
+    }
+    auto typeflag = hd->typeflag;
+    auto data = pos_ + tar_block_size;
+    if (typeflag == 'x' || typeflag == 'g' || typeflag == 'L' || typeflag == 'K') {
+      const uint8_t *payload = nullptr;
+      if (size > tar_meta_max || (size != 0 && (payload = fetch(data, size)) == nullptr)) {
+        bad_ = true;
+        return false;
+      }
+      std::string_view sv(reinterpret_cast<const char *>(payload), static_cast<size_t>(size));
+      if (typeflag == 'L' || typeflag == 'K') {
+        (typeflag == 'L' ? longname : longlink).assign(tar_field(sv.data(), sv.size()));
+      } else if (!tar_pax_parse(sv, typeflag == 'x' ? pax : global_)) {
+        bad_ = true;
+        return false;
+      }
+      pos_ = data + tar_padded(size);
+      continue;
+    }
+    uint64_t mode = 0;
+    uint64_t mtime = 0;
+    tar_number(hd->mode, sizeof(hd->mode), mode);
+    tar_number(hd->mtime, sizeof(hd->mtime), mtime);
+    e.name.clear();
+    // POSIX ustar splits long path into prefix and name
+    constexpr const char ustarMagic[] = {'u', 's', 't', 'a', 'r', 0};
+    if (memcmp(hd->magic, ustarMagic, sizeof(ustarMagic)) == 0 && hd->prefix[0] != 0) {
+      e.name.assign(tar_field(hd->prefix, sizeof(hd->prefix))).push_back('/');
+    }
+    e.name.append(tar_field(hd->name, sizeof(hd->name)));
+    e.linkname.assign(tar_field(hd->linkname, sizeof(hd->linkname)));
+    e.typeflag = typeflag;
+    e.mode = static_cast<uint32_t>(mode);
+    e.mtime = static_cast<int64_t>(mtime);
+    e.sparse = typeflag == 'S';
+    e.realsize = 0;
+    bool extended = false;
+    if (e.sparse) {
+      auto gh = reinterpret_cast<const gnutar_header_t *>(block);
+      tar_number(gh->realsize, sizeof(gh->realsize), e.realsize);
+      extended = gh->isextended != 0;
+    }
+    // old GNU sparse map continues in extension blocks before member data
+    while (extended) {
+      auto ext = fetch(data, tar_block_size);
+      if (ext == nullptr) {
+        bad_ = true;
+        return false;
+      }
+      extended = ext[tar_sparse_ext_entries * sizeof(gnu_sparse_t)] != 0;
+      data += tar_block_size;
+    }
+    pax.merge(global_);
+    if (!pax.sparsename.empty()) {
+      e.name = pax.sparsename;
+    } else if (!pax.path.empty()) {
+      e.name = pax.path;
+    } else if (!longname.empty()) {
+      e.name = longname;
+    }
+    if (!pax.linkpath.empty()) {
+      e.linkname = pax.linkpath;
+    } else if (!longlink.empty()) {
+      e.linkname = longlink;
+    }
+    if (pax.size) {
+      // pax size overrides octal field, which cannot hold 8 GiB or more
+      size = *pax.size;
+    }
+    if (pax.mtime) {
+      e.mtime = *pax.mtime;
+    }
+    // pax sparse 1.0 keeps its map in first data blocks, which stay part of member data
+    e.sparse = e.sparse || pax.sparse;
+    if (pax.sparse && pax.realsize) {
+      e.realsize = *pax.realsize;
+    }
+    if (!e.sparse || e.realsize == 0) {
+      e.realsize = size;
+    }
+    e.size = size;
+    e.offset = data;
+    auto padded = tar_padded(size);
+    if ((padded == 0 && size != 0) || padded > size_ - e.offset) {
+      // truncated member is still reported, walking stops after it
+      bad_ = true;
+      pos_ = size_;
+      return true;
+    }
+    pos_ = e.offset + padded;
+    return true;
+  }
+}
+
+} // namespace inquisitive
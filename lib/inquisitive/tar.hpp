@@ -0,0 +1,142 @@
+//// TAR
+#ifndef INQUISITIVE_TAR_HPP
+#define INQUISITIVE_TAR_HPP
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <optional>
+#include <vector>
+#include <mapview.hpp>
+// https://www.gnu.org/software/tar/manual/html_node/Standard.html
+// https://pubs.opengroup.org/onlinepubs/9699919799/utilities/pax.html
+// https://www.gnu.org/software/tar/manual/html_node/Sparse-Formats.html
+
+namespace inquisitive {
+#pragma pack(1)
+struct ustar_header_t {
+  char name[100];
+  char mode[8];
+  char uid[8];
+  char gid[8];
+  char size[12];
+  char mtime[12];
+  char checksum[8];
+  char typeflag;
+  char linkname[100]; /* "old format" header ends here */
+  char magic[6];      /* For POSIX: "ustar\0" */
+  char version[2];    /* For POSIX: "00" */
+  char uname[32];
+  char gname[32];
+  char rdevmajor[8];
+  char rdevminor[8];
+  char prefix[155];
+};
+
+/*
+ * Structure of GNU tar header
+ */
+struct gnu_sparse_t {
+  char offset[12];
+  char numbytes[12];
+};
+
+struct gnutar_header_t {
+  char name[100];
+  char mode[8];
+  char uid[8];
+  char gid[8];
+  char size[12];
+  char mtime[12];
+  char checksum[8];
+  char typeflag;
+  char linkname[100];
+  char magic[8]; /* "ustar  \0" (note blank/blank/null at end) */
+  char uname[32];
+  char gname[32];
+  char rdevmajor[8];
+  char rdevminor[8];
+  char atime[12];
+  char ctime[12];
+  char offset[12];
+  char longnames[4];
+  char unused;
+  gnu_sparse_t sparse[4];
+  char isextended;
+  char realsize[12];
+  /*
+   * Old GNU format doesn't use POSIX 'prefix' field; they use
+   * the 'L' (longname) entry instead.
+   */
+};
+#pragma pack()
+
+constexpr size_t tar_block_size = 512;
+// pax extended header and GNU long name payloads larger than this are treated as damage
+constexpr size_t tar_meta_max = 1024 * 1024;
+// GNU sparse extension block holds 21 entries followed by isextended
+constexpr size_t tar_sparse_ext_entries = 21;
+
+struct tar_entry_t {
+  std::string name;
+  std::string linkname;
+  uint64_t offset{0};   /// member data offset
+  uint64_t size{0};     /// bytes stored in archive
+  uint64_t realsize{0}; /// size with sparse holes filled, same as size for other members
+  int64_t mtime{0};
+  uint32_t mode{0};
+  char typeflag{0};
+  bool sparse{false}; /// GNU 'S' or pax GNU.sparse member, stored data is not the whole file
+  bool regular() const {
+    return typeflag == '0' || typeflag == '\0' || typeflag == '7' || typeflag == 'S';
+  }
+};
+
+// pax extended header values, global ('g') ones are defaults of every following member
+struct tar_pax_t {
+  std::string path;
+  std::string linkpath;
+  std::optional<uint64_t> size;
+  std::optional<uint64_t> realsize;
+  std::optional<int64_t> mtime;
+  std::string sparsename; /// GNU.sparse.name, path holds a placeholder
+  bool sparse{false};
+  void merge(const tar_pax_t &global);
+};
+
+// records are "length key=value\n", length counts the whole record
+bool tar_pax_parse(std::string_view sv, tar_pax_t &pax);
+
+// tar_reader hops between headers by member size, member data is never read. Mapped archive is
+// pure offset arithmetic; stream such as pipe is read forward, skipped data is discarded unless
+// the handle can seek (redirected file).
+class tar_reader {
+public:
+  tar_reader(base::WindowView &wv) : wv_(&wv), size_(wv.size()) {}
+  tar_reader(HANDLE stream);
+  tar_reader(const tar_reader &) = delete;
+  tar_reader &operator=(const tar_reader &) = delete;
+  bool next(tar_entry_t &e);
+  bool bad() const { return bad_; }
+
+private:
+  const uint8_t *fetch(uint64_t off, size_t len);
+  bool skip(uint64_t off);
+  base::WindowView *wv_{nullptr};
+  uint64_t size_{UINT64_MAX}; /// archive size, unknown for pipe
+  HANDLE stream_{INVALID_HANDLE_VALUE};
+  uint64_t streampos_{0}; /// pipe offset, never goes back
+  bool seekable_{false};
+  std::vector<uint8_t> buffer_;
+  tar_pax_t global_;
+  uint64_t pos_{0};
+  bool bad_{false};
+};
+
+// numeric field, octal or GNU base-256 when high bit of first byte is set
+bool tar_number(const char *field, size_t len, uint64_t &v);
+// header checksum, historic implementations summed signed chars
+bool tar_checksum(const uint8_t *block);
+
+} // namespace inquisitive
+
+#endif
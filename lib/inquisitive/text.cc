@@ -8,7 +8,7 @@ namespace inquisitive {
 
 bool buffer_is_binary(base::MemView mv) {
   auto size = (std::min)(mv.size(), size_t(0x8000));
-  if (memchr(mv.data(), 0, size) != nullptr) {
+  if (byte_strnlen(mv.data(), size) != size) {
     return true;
   }
   return false;
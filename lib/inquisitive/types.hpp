@@ -46,6 +46,10 @@ enum Type {
   /// archive
   epub,
   zip,
+  jar,
+  apk,
+  vsix,
+  appx,
   tar,
   rar,
   gz,
@@ -69,6 +73,8 @@ enum Type {
   xar,
   wim,
   z,
+  zstd,
+  lz4,
   // image
   jpg,
   jp2,
@@ -88,6 +94,10 @@ enum Type {
   xlsx,
   ppt,
   pptx,
+  odt,
+  ods,
+  odp,
+  odg,
   // font
   woff,
   woff2,
@@ -0,0 +1,281 @@
+/// ZIP and gzip integrity verification
+#include <atomic>
+#include <thread>
+#include <bela/codecvt.hpp>
+#include "inquisitive.hpp"
+#include "zip.hpp"
+#include "inflate.hpp"
+
+namespace inquisitive {
+// member data is hashed or inflated straight from mapped file, window by window
+constexpr size_t verify_window_size = 64 * 1024 * 1024;
+
+struct verify_entry_t {
+  std::string_view name; /// view into central directory copy
+  uint64_t localoffset{0};
+  uint64_t compressed{0};
+  uint64_t size{0};
+  uint32_t crc{0};
+  uint16_t method{0};
+  uint16_t flags{0};
+};
+
+struct verify_state_t {
+  uint64_t actual{0};
+  uint32_t computed{0};
+  verify_status_t status{VerifyOk};
+};
+
+verify_status_t verify_zip_member(base::WindowView &wv, inflate_stream &s,
+                                  const verify_entry_t &e, verify_state_t &st) {
+  if ((e.flags & zip_flag_encrypted) != 0) {
+    return VerifyEncrypted;
+  }
+  if (e.method != 0 && e.method != 8) {
+    return VerifyUnsupported;
+  }
+  bela::error_code ec;
+  auto offset = zip_data_offset(wv, e.localoffset, ec);
+  if (offset == 0) {
+    return VerifyDamaged;
+  }
+  uint32_t crc = 0;
+  if (e.method == 0) {
+    for (uint64_t pos = 0; pos < e.compressed;) {
+      auto n = static_cast<size_t>((std::min)(e.compressed - pos, uint64_t(verify_window_size)));
+      auto mv = wv.Window(offset + pos, n, ec);
+      if (mv.size() != n) {
+        return VerifyDamaged;
+      }
+      crc = byte_crc32(mv.data(), mv.size(), crc);
+      pos += n;
+    }
+    st.actual = e.compressed;
+  } else {
+    // next window starts at first input byte inflater has not taken into its bit buffer
+    auto window = [&](uint64_t pos, bool first) {
+      auto n = static_cast<size_t>((std::min)(e.compressed - pos, uint64_t(verify_window_size)));
+      auto cv = wv.Window(offset + pos, n, ec);
+      if (cv.size() != n) {
+        return false;
+      }
+      auto more = pos + n < e.compressed;
+      if (first) {
+        s.reset(cv.data(), cv.size(), more);
+      } else {
+        s.feed(cv.data(), cv.size(), more);
+      }
+      return true;
+    };
+    uint64_t pos = 0;
+    if (!window(pos, true)) {
+      return VerifyDamaged;
+    }
+    while (!s.eof()) {
+      auto out = s.read();
+      crc = byte_crc32(out.data(), out.size(), crc);
+      if (s.starved()) {
+        pos += s.input_used();
+        if (!window(pos, false)) {
+          return VerifyDamaged;
+        }
+      }
+    }
+    st.actual = s.total_out();
+    if (!s.done()) {
+      st.computed = crc;
+      return VerifyDamaged;
+    }
+  }
+  st.computed = crc;
+  if (st.actual != e.size) {
+    return VerifySize;
+  }
+  return crc == e.crc ? VerifyOk : VerifyCRC;
+}
+
+bool verify_zip(std::wstring_view sv, base::WindowView &wv, const zip_directory_t &zd,
+                verify_result_t &vr, uint32_t concurrency, bela::error_code &ec) {
+  // central directory is copied, workers map their own windows
+  std::string cd;
+  cd.assign(wv.Window(zd.offset, static_cast<size_t>(zd.size), ec).sv());
+  if (cd.size() != zd.size) {
+    ec = bela::make_error_code(L"zip central directory unreadable");
+    return false;
+  }
+  auto cv = bela::MemView(reinterpret_cast<const uint8_t *>(cd.data()), cd.size());
+  zip_central_reader reader(cv, zd.prefix);
+  std::vector<verify_entry_t> entries;
+  entries.reserve(static_cast<size_t>((std::min)(zd.entries, uint64_t(1) << 20)));
+  zip_entry_t e;
+  while (reader.next(e)) {
+    auto &v = entries.emplace_back();
+    v.name = e.name;
+    v.localoffset = e.localoffset;
+    v.compressed = e.compressedsize;
+    v.size = e.uncompressedsize;
+    v.crc = e.crc32;
+    v.method = e.method;
+    v.flags = e.flags;
+  }
+  if (!reader.complete(entries.size(), zd)) {
+    ec = bela::make_error_code(bela::ParseBroken, L"zip central directory damaged, read ",
+                               entries.size(), L" of ", zd.entries);
+    return false;
+  }
+  // members no worker reached, such as when file cannot be mapped again, stay damaged
+  std::vector<verify_state_t> states(entries.size(), verify_state_t{0, 0, VerifyDamaged});
+  if (concurrency == 0) {
+    concurrency = (std::max)(std::thread::hardware_concurrency(), 1u);
+  }
+  concurrency =
+      static_cast<uint32_t>((std::min)(static_cast<size_t>(concurrency), entries.size()));
+  std::atomic_size_t next{0};
+  auto worker = [&](base::WindowView &mwv) {
+    inflate_stream s;
+    for (auto i = next++; i < entries.size(); i = next++) {
+      states[i].status = verify_zip_member(mwv, s, entries[i], states[i]);
+    }
+  };
+  if (concurrency <= 1) {
+    worker(wv);
+  } else {
+    std::vector<std::thread> workers;
+    workers.reserve(concurrency);
+    for (uint32_t i = 0; i < concurrency; i++) {
+      workers.emplace_back([&]() {
+        base::WindowView mwv;
+        bela::error_code mec;
+        if (mwv.Open(sv, mec)) {
+          worker(mwv);
+        }
+      });
+    }
+    for (auto &w : workers) {
+      w.join();
+    }
+  }
+  vr.members = entries.size();
+  for (size_t i = 0; i < entries.size(); i++) {
+    const auto &st = states[i];
+    vr.bytes += st.actual;
+    if (st.status == VerifyOk) {
+      vr.verified++;
+      continue;
+    }
+    auto &f = vr.failures.emplace_back();
+    f.name = bela::ToWide(entries[i].name);
+    f.size = entries[i].size;
+    f.crc = entries[i].crc;
+    f.actual = st.actual;
+    f.computed = st.computed;
+    f.status = st.status;
+  }
+  return true;
+}
+
+// concatenated members are checked one by one, zero padding after last member is allowed
+bool verify_gzip(std::wstring_view sv, base::WindowView &wv, verify_result_t &vr) {
+  bela::error_code ec;
+  inflate_stream s;
+  uint64_t pos = 0;
+  while (pos < wv.size()) {
+    auto hv = wv.Window(pos, zip_sniff_input_max, ec);
+    if (vr.members != 0 && hv.size() != 0 && hv[0] == 0) {
+      break;
+    }
+    vr.members++;
+    auto &f = vr.failures.emplace_back();
+    auto name = gzip_member_name(hv);
+    if (!name.empty()) {
+      f.name = bela::ToWide(name);
+    } else {
+      auto sep = sv.find_last_of(L"\\/");
+      f.name.assign(sep == std::wstring_view::npos ? sv : sv.substr(sep + 1));
+    }
+    auto offset = gzip_data_offset(hv);
+    if (offset == 0) {
+      f.status = VerifyDamaged;
+      return true;
+    }
+    auto data = pos + offset;
+    // member end is not known, windows run to end of file until inflater stops
+    uint64_t part = data;
+    auto window = [&](bool first) {
+      auto n = static_cast<size_t>((std::min)(wv.size() - part, uint64_t(verify_window_size)));
+      auto dv = wv.Window(part, n, ec);
+      if (dv.size() != n) {
+        return false;
+      }
+      auto more = part + n < wv.size();
+      if (first) {
+        s.reset(dv.data(), dv.size(), more);
+      } else {
+        s.feed(dv.data(), dv.size(), more);
+      }
+      return true;
+    };
+    if (!window(true)) {
+      f.status = VerifyDamaged;
+      return true;
+    }
+    uint32_t crc = 0;
+    bool mapped = true;
+    while (!s.eof()) {
+      auto out = s.read();
+      crc = byte_crc32(out.data(), out.size(), crc);
+      if (s.starved()) {
+        part += s.input_used();
+        if (!(mapped = window(false))) {
+          break;
+        }
+      }
+    }
+    f.actual = s.total_out();
+    f.computed = crc;
+    uint8_t trailer[8];
+    if (!mapped || !s.done() || wv.ReadAt(part + s.consumed(), trailer, 8, ec) != 8) {
+      f.status = VerifyDamaged;
+      return true;
+    }
+    f.crc = bela::readle<uint32_t>(trailer);
+    // ISIZE is size modulo 2^32
+    f.size = bela::readle<uint32_t>(trailer + 4);
+    vr.bytes += f.actual;
+    if (f.crc != crc) {
+      f.status = VerifyCRC;
+    } else if (f.size != (f.actual & 0xFFFFFFFF)) {
+      f.status = VerifySize;
+    } else {
+      vr.verified++;
+      vr.failures.pop_back();
+    }
+    pos = part + s.consumed() + 8;
+  }
+  return true;
+}
+
+std::optional<verify_result_t> inquisitive_verify(std::wstring_view sv, bela::error_code &ec,
+                                                  uint32_t concurrency) {
+  base::WindowView wv;
+  if (!wv.Open(sv, ec, 4)) {
+    return std::nullopt;
+  }
+  verify_result_t vr;
+  auto magic = wv.Window(0, 2, ec);
+  if (magic.size() == 2 && magic[0] == 0x1F && magic[1] == 0x8B) {
+    verify_gzip(sv, wv, vr);
+    return std::make_optional(std::move(vr));
+  }
+  zip_directory_t zd;
+  if (!zip_directory_locate(wv, zd, ec)) {
+    ec = bela::make_error_code(L"not a ZIP or gzip file");
+    return std::nullopt;
+  }
+  if (!verify_zip(sv, wv, zd, vr, concurrency, ec)) {
+    return std::nullopt;
+  }
+  return std::make_optional(std::move(vr));
+}
+
+} // namespace inquisitive
@@ -2,12 +2,12 @@
 #include <string_view>
 #include "inquisitive.hpp"
 #include "zip.hpp"
+#include "inflate.hpp"
 
 // ---------------> to
 // zip
 // docx pptx xlsx...
 // appx....
-//#include "zlib.h"
 
 namespace inquisitive {
 ///
@@ -17,115 +17,388 @@ inline bool IsZip(const byte_t *buf, size_t size) {
           (buf[3] == 0x4 || buf[3] == 0x6 || buf[3] == 0x8));
 }
 
-status_t msdocssubview(base::MemView mv, inquisitive_result_t &ir) {
-  if (mv.StartsWith("word/")) {
-    ir.assign(L"Microsoft Word (.docx)", types::docx);
-    return Found;
+bool zip_directory_locate(base::WindowView &wv, zip_directory_t &zd, bela::error_code &ec) {
+  auto fsize = wv.size();
+  if (fsize < sizeof(zip_eocd_t)) {
+    ec = bela::make_error_code(L"zip file size too small");
+    return false;
   }
-  if (mv.StartsWith("ppt/")) {
-    ir.assign(L"Microsoft PowerPoint (.pptx)", types::pptx);
-    return Found;
+  auto tail = wv.Tail(static_cast<size_t>((std::min)(fsize, uint64_t(zip_tail_size))), ec);
+  if (tail.size() < sizeof(zip_eocd_t)) {
+    if (!ec) {
+      ec = bela::make_error_code(L"zip file size too small");
+    }
+    return false;
   }
-  if (mv.StartsWith("xl/")) {
-    ir.assign(L"Microsoft Excel (.xlsx)", types::xlsx);
-    return Found;
+  auto tailoffset = fsize - tail.size();
+  auto p = tail.data();
+  // comment is at most 64K, most archives have none so the first probe usually hits
+  constexpr const byte_t eocdMagic[] = {'P', 'K', 0x05, 0x06};
+  size_t pos = 0;
+  size_t limit = tail.size() - sizeof(zip_eocd_t) + sizeof(eocdMagic);
+  const zip_eocd_t *eocd = nullptr;
+  for (const uint8_t *m = nullptr;
+       (m = byte_rsearch(p, limit, eocdMagic, sizeof(eocdMagic))) != nullptr;) {
+    pos = m - p;
+    auto e = reinterpret_cast<const zip_eocd_t *>(m);
+    if (pos + sizeof(zip_eocd_t) + bela::swaple(e->commentlen) <= tail.size()) {
+      eocd = e;
+      break;
+    }
+    limit = pos + sizeof(eocdMagic) - 1;
   }
-  return None;
+  if (eocd == nullptr) {
+    ec = bela::make_error_code(L"zip end of central directory not found");
+    return false;
+  }
+  zd.eocd = tailoffset + pos;
+  zd.entries = bela::swaple(eocd->entries);
+  zd.size = bela::swaple(eocd->cdsize);
+  zd.offset = bela::swaple(eocd->cdoffset);
+  zd.commentlen = bela::swaple(eocd->commentlen);
+  auto end = zd.eocd;
+  // ZIP64 locator immediately precedes EOCD, read it before tail window may be evicted
+  if (pos >= sizeof(zip64_eocd_locator_t)) {
+    auto loc =
+        reinterpret_cast<const zip64_eocd_locator_t *>(p + pos - sizeof(zip64_eocd_locator_t));
+    if (bela::swaple(loc->magic) == zip64_eocd_locator_magic) {
+      auto recordoffset = bela::swaple(loc->eocdoffset);
+      // self-extracting stub shifts the record but not the recorded offset, the record without
+      // extensible data sits right before the locator then, prefix is derived below
+      auto locoffset = zd.eocd - sizeof(zip64_eocd_locator_t);
+      const zip64_eocd_t *r = nullptr;
+      uint64_t before =
+          locoffset >= sizeof(zip64_eocd_t) ? locoffset - sizeof(zip64_eocd_t) : recordoffset;
+      for (auto off : {recordoffset, before}) {
+        bela::error_code rec;
+        auto rv = wv.Window(off, sizeof(zip64_eocd_t), rec);
+        if (rv.size() == sizeof(zip64_eocd_t) &&
+            bela::readle<uint32_t>(rv.data()) == zip64_eocd_magic) {
+          r = reinterpret_cast<const zip64_eocd_t *>(rv.data());
+          recordoffset = off;
+          break;
+        }
+      }
+      if (r == nullptr) {
+        ec = bela::make_error_code(L"zip64 end of central directory record invalid");
+        return false;
+      }
+      zd.entries = bela::swaple(r->entries);
+      zd.size = bela::swaple(r->cdsize);
+      zd.offset = bela::swaple(r->cdoffset);
+      zd.zip64 = true;
+      end = recordoffset;
+    }
+  }
+  if (zd.size > end || zd.offset > end - zd.size) {
+    ec = bela::make_error_code(L"zip central directory out of file range");
+    return false;
+  }
+  if (zd.entries > zd.size / sizeof(zip_central_header_t)) {
+    ec = bela::make_error_code(L"zip central directory entries too many");
+    return false;
+  }
+  // bytes prepended to archive (self-extracting stub) shift every recorded offset
+  zd.prefix = end - zd.size - zd.offset;
+  zd.offset += zd.prefix;
+  return true;
 }
 
-void *Memmem(const void *haystack, size_t haystack_len, const void *needle, size_t needle_len) {
-  const char *begin = reinterpret_cast<const char *>(haystack);
-  const char *last_possible = begin + haystack_len - needle_len;
-  const char *tail = reinterpret_cast<const char *>(needle);
-  char point;
-
-  /*
-   * The first occurrence of the empty string is deemed to occur at
-   * the beginning of the string.
-   */
-  if (needle_len == 0)
-    return (void *)begin;
-
-  /*
-   * Sanity check, otherwise the loop might search through the whole
-   * memory.
-   */
-  if (haystack_len < needle_len)
-    return nullptr;
-
-  point = *tail++;
-  for (; begin <= last_possible; begin++) {
-    if (*begin == point && !memcmp(begin + 1, tail, needle_len - 1))
-      return (void *)begin;
-  }
-  return nullptr;
+// 16-bit EOCD count of an archive without ZIP64 record wraps past 65535 entries, such count is
+// trusted modulo 65536 only when the walk consumed the recorded directory size exactly
+bool zip_central_reader::complete(uint64_t count, const zip_directory_t &zd) const {
+  if (bad_) {
+    return false;
+  }
+  if (count == zd.entries) {
+    return true;
+  }
+  return !zd.zip64 && count % 65536 == zd.entries && pos_ == mv_.size();
 }
 
-using ssize_t = SSIZE_T;
-
-ssize_t MagicIndex(base::MemView mv, size_t offset) {
-  constexpr const byte_t docsMagic[] = {'P', 'K', 0x03, 0x04};
-  if (offset > mv.size()) {
-    return -1;
+bool zip_central_reader::next(zip_entry_t &e) {
+  if (bad_ || mv_.size() - pos_ < sizeof(zip_central_header_t)) {
+    return false;
   }
-  auto p = Memmem(mv.data() + offset, mv.size() - offset, docsMagic, ArrayLength(docsMagic));
-  if (p == nullptr) {
-    return -1;
+  auto h = reinterpret_cast<const zip_central_header_t *>(mv_.data() + pos_);
+  if (bela::swaple(h->magic) != zip_central_header_magic) {
+    bad_ = true;
+    return false;
   }
-  return reinterpret_cast<const uint8_t *>(p) - mv.data();
+  size_t namelen = bela::swaple(h->namelen);
+  size_t extralen = bela::swaple(h->extralen);
+  size_t commentlen = bela::swaple(h->commentlen);
+  if (namelen + extralen + commentlen > mv_.size() - pos_ - sizeof(zip_central_header_t)) {
+    bad_ = true;
+    return false;
+  }
+  auto p = reinterpret_cast<const char *>(h) + sizeof(zip_central_header_t);
+  e.name = std::string_view(p, namelen);
+  e.extra = bela::MemView(p + namelen, extralen);
+  e.comment = std::string_view(p + namelen + extralen, commentlen);
+  e.compressedsize = bela::swaple(h->compressedsize);
+  e.uncompressedsize = bela::swaple(h->uncompressedsize);
+  e.localoffset = bela::swaple(h->localoffset);
+  e.crc32 = bela::swaple(h->crc32);
+  e.flags = bela::swaple(h->flags);
+  e.method = bela::swaple(h->method);
+  e.creatorversion = bela::swaple(h->creatorversion);
+  e.mtime = bela::swaple(h->mtime);
+  e.mdate = bela::swaple(h->mdate);
+  e.externalattrs = bela::swaple(h->externalattrs);
+  e.unixmtime = -1;
+  e.utf8 = (e.flags & zip_flag_utf8) != 0;
+  auto xp = e.extra.data();
+  for (size_t off = 0; off + 4 <= extralen;) {
+    auto tag = bela::readle<uint16_t>(xp + off);
+    size_t size = bela::readle<uint16_t>(xp + off + 2);
+    off += 4;
+    if (size > extralen - off) {
+      break;
+    }
+    auto field = xp + off;
+    off += size;
+    switch (tag) {
+    case zip64_extra_id: {
+      // ZIP64 extended information holds only the fields saturated in header, in fixed order
+      size_t n = 0;
+      for (auto v : {&e.uncompressedsize, &e.compressedsize, &e.localoffset}) {
+        if (*v != 0xFFFFFFFF) {
+          continue;
+        }
+        if (n + 8 > size) {
+          break;
+        }
+        *v = bela::readle<uint64_t>(field + n);
+        n += 8;
+      }
+    } break;
+    case zip_unicode_path_extra_id:
+      // version 1, CRC-32 of raw name then UTF-8 name, stale when raw name was changed later
+      if (size > 5 && field[0] == 1 &&
+          bela::readle<uint32_t>(field + 1) == byte_crc32(p, namelen)) {
+        e.name = std::string_view(reinterpret_cast<const char *>(field) + 5, size - 5);
+        e.utf8 = true;
+      }
+      break;
+    case zip_timestamp_extra_id:
+      // central directory copy carries modification time only
+      if (size >= 5 && (field[0] & 1) != 0) {
+        e.unixmtime = bela::readle<int32_t>(field + 1);
+      }
+      break;
+    case zip_ntfs_extra_id:
+      // reserved then tag 1 attribute: mtime, atime, ctime FILETIME
+      if (size >= 32 && bela::readle<uint16_t>(field + 4) == 1 &&
+          bela::readle<uint16_t>(field + 6) >= 24 && e.unixmtime < 0) {
+        constexpr uint64_t epochdelta = 116444736000000000ull;
+        auto ft = bela::readle<uint64_t>(field + 8);
+        if (ft >= epochdelta) {
+          e.unixmtime = static_cast<int64_t>((ft - epochdelta) / 10000000);
+        }
+      }
+      break;
+    default:
+      break;
+    }
+  }
+  e.localoffset += prefix_;
+  pos_ += sizeof(zip_central_header_t) + namelen + extralen + commentlen;
+  return true;
 }
 
-status_t inquisitive_msxmldocs(base::MemView mv, inquisitive_result_t &ir) {
-  constexpr const byte_t docsMagic[] = {'P', 'K', 0x03, 0x04};
-  if (!mv.StartsWith(docsMagic)) {
-    return None;
+// central directory entry names which identify container
+constexpr uint32_t zipContentTypes = 0x1;
+constexpr uint32_t zipWord = 0x2;
+constexpr uint32_t zipExcel = 0x4;
+constexpr uint32_t zipPowerPoint = 0x8;
+constexpr uint32_t zipJarManifest = 0x10;
+constexpr uint32_t zipJavaClass = 0x20;
+constexpr uint32_t zipAndroidManifest = 0x40;
+constexpr uint32_t zipAndroidCode = 0x80;
+constexpr uint32_t zipVsixManifest = 0x100;
+constexpr uint32_t zipAppxManifest = 0x200;
+constexpr uint32_t zipAppxBundleManifest = 0x400;
+
+struct zip_name_hint_t {
+  std::string_view name;
+  uint32_t hint;
+  bool prefix;
+};
+
+constexpr zip_name_hint_t zip_name_hints[] = {
+    {"[Content_Types].xml", zipContentTypes, false},
+    {"word/", zipWord, true},
+    {"xl/", zipExcel, true},
+    {"ppt/", zipPowerPoint, true},
+    {"META-INF/MANIFEST.MF", zipJarManifest, false},
+    {"AndroidManifest.xml", zipAndroidManifest, false},
+    {"classes.dex", zipAndroidCode, false},
+    {"resources.arsc", zipAndroidCode, false},
+    {"extension.vsixmanifest", zipVsixManifest, false},
+    {"AppxManifest.xml", zipAppxManifest, false},
+    {"AppxMetadata/AppxBundleManifest.xml", zipAppxBundleManifest, false},
+};
+
+// ODF and EPUB store 'mimetype' uncompressed as first entry
+struct zip_mimetype_t {
+  std::string_view mime;
+  const wchar_t *description;
+  types::Type t;
+};
+
+constexpr zip_mimetype_t zip_mimetypes[] = {
+    {"application/epub+zip", L"EPUB document", types::epub},
+    {"application/vnd.oasis.opendocument.text", L"OpenDocument Text (.odt)", types::odt},
+    {"application/vnd.oasis.opendocument.spreadsheet", L"OpenDocument Spreadsheet (.ods)",
+     types::ods},
+    {"application/vnd.oasis.opendocument.presentation", L"OpenDocument Presentation (.odp)",
+     types::odp},
+    {"application/vnd.oasis.opendocument.graphics", L"OpenDocument Drawing (.odg)", types::odg},
+};
+constexpr uint64_t zip_mimetype_limit = 128;
+
+uint64_t zip_data_offset(base::WindowView &wv, uint64_t localoffset, bela::error_code &ec) {
+  auto lv = wv.Window(localoffset, sizeof(zip_file_header_t), ec);
+  if (lv.size() != sizeof(zip_file_header_t) ||
+      bela::readle<uint32_t>(lv.data()) != zip_local_header_magic) {
+    return 0;
   }
-  if (msdocssubview(mv.submv(0x1E), ir) == Found) {
-    return Found;
+  // local name and extra field may differ from central directory ones
+  auto lh = reinterpret_cast<const zip_file_header_t *>(lv.data());
+  return localoffset + sizeof(zip_file_header_t) + bela::swaple(lh->namelen) +
+         bela::swaple(lh->fieldlength);
+}
+
+bela::MemView zip_member_prefix(base::WindowView &wv, const zip_entry_t &e, inflate_stream &s,
+                                size_t limit, bela::error_code &ec) {
+  if ((e.flags & zip_flag_encrypted) != 0 || (e.method != 0 && e.method != 8)) {
+    return bela::MemView();
   }
-  /// SO we known. first file must [Content_Types.xml]
-  if (!mv.IndexsWith(0x1E, "[Content_Types].xml") && !mv.IndexsWith(0x1E, "_rels/.rels")) {
-    return None;
+  auto offset = zip_data_offset(wv, e.localoffset, ec);
+  if (offset == 0) {
+    return bela::MemView();
   }
-  auto hd = mv.cast<zip_file_header_t>(0);
-  if (hd == nullptr) {
-    return None;
+  if (e.method == 0) {
+    auto n = static_cast<size_t>((std::min)(e.compressedsize, uint64_t(limit)));
+    return wv.Window(offset, n, ec);
   }
-  ssize_t startoffset = bela::readle<uint32_t>(mv.data() + 18) + 49;
-  auto index = MagicIndex(mv, startoffset);
-  if (index == -1) {
+  // limit output and input both, broken or hostile stream cannot make us read whole member
+  auto n = static_cast<size_t>((std::min)(e.compressedsize, uint64_t(zip_sniff_input_max)));
+  auto cv = wv.Window(offset, n, ec);
+  s.reset(cv);
+  return s.read(limit);
+}
+
+status_t zip_member_content(base::WindowView &wv, const zip_entry_t &e, inflate_stream &s,
+                            inquisitive_result_t &ir) {
+  bela::error_code ec;
+  auto mv = zip_member_prefix(wv, e, s, inflate_sniff_size, ec);
+  if (mv.size() == 0) {
     return None;
   }
-  startoffset = index + 4 + 26;
-  index = MagicIndex(mv, startoffset);
-  if (index == -1) {
+  return inquisitive_memview(mv, ir);
+}
+
+status_t zip_classify(base::WindowView &wv, const zip_directory_t &zd, inquisitive_result_t &ir) {
+  bela::error_code ec;
+  auto cd = wv.Window(zd.offset, static_cast<size_t>(zd.size), ec);
+  if (cd.size() != zd.size) {
     return None;
   }
-  startoffset = index + 4 + 26;
-  if (msdocssubview(mv.submv(startoffset), ir) == Found) {
+  zip_central_reader reader(cd, zd.prefix);
+  zip_entry_t e;
+  zip_entry_t first;
+  uint32_t hints = 0;
+  uint64_t count = 0;
+  bool mimetype = false;
+  for (; reader.next(e); count++) {
+    if (count == 0) {
+      // some writers deflate mimetype against the spec, accept both
+      mimetype = e.name == "mimetype" && e.uncompressedsize <= zip_mimetype_limit;
+      first = e;
+    }
+    for (const auto &h : zip_name_hints) {
+      if (h.prefix ? (e.name.compare(0, h.name.size(), h.name) == 0) : (e.name == h.name)) {
+        hints |= h.hint;
+      }
+    }
+    constexpr std::string_view classSuffix = ".class";
+    if (e.name.size() > classSuffix.size() &&
+        e.name.compare(e.name.size() - classSuffix.size(), classSuffix.size(), classSuffix) == 0) {
+      hints |= zipJavaClass;
+    }
+  }
+  // central directory window may be evicted from now on, only offsets and sizes of first are used
+  inflate_stream s;
+  if (mimetype) {
+    auto limit = static_cast<size_t>(first.uncompressedsize);
+    auto mime = zip_member_prefix(wv, first, s, limit, ec).sv();
+    for (const auto &m : zip_mimetypes) {
+      if (m.mime == mime) {
+        ir.assign(m.description, m.t, types::ZIP);
+        return Found;
+      }
+    }
+  }
+  if ((hints & zipVsixManifest) != 0 && (hints & zipContentTypes) != 0) {
+    ir.assign(L"Visual Studio Extension (.vsix)", types::vsix, types::ZIP);
     return Found;
   }
-  startoffset += 26;
-  index = MagicIndex(mv, startoffset);
-  if (index == -1) {
-    return None;
+  if ((hints & zipAppxBundleManifest) != 0) {
+    ir.assign(L"Windows App Bundle (.appxbundle/.msixbundle)", types::appx, types::ZIP);
+    return Found;
+  }
+  if ((hints & zipAppxManifest) != 0) {
+    ir.assign(L"Windows App Package (.appx/.msix)", types::appx, types::ZIP);
+    return Found;
+  }
+  if ((hints & zipContentTypes) != 0) {
+    if ((hints & zipWord) != 0) {
+      ir.assign(L"Microsoft Word (.docx)", types::docx, types::ZIP);
+      return Found;
+    }
+    if ((hints & zipPowerPoint) != 0) {
+      ir.assign(L"Microsoft PowerPoint (.pptx)", types::pptx, types::ZIP);
+      return Found;
+    }
+    if ((hints & zipExcel) != 0) {
+      ir.assign(L"Microsoft Excel (.xlsx)", types::xlsx, types::ZIP);
+      return Found;
+    }
+  }
+  if ((hints & zipAndroidManifest) != 0 && (hints & zipAndroidCode) != 0) {
+    ir.assign(L"Android Package (.apk)", types::apk, types::ZIP);
+    return Found;
   }
-  startoffset = index + 4 + 26;
-  if (msdocssubview(mv.submv(startoffset), ir) == Found) {
+  if ((hints & (zipJarManifest | zipJavaClass)) != 0) {
+    ir.assign(L"Java Archive (.jar)", types::jar, types::ZIP);
     return Found;
   }
-  // auto offset=
+  // single file archive, tell what file it is
+  inquisitive_result_t content;
+  if (count == 1 && zip_member_content(wv, first, s, content) == Found) {
+    ir.add(L"Content", content.description());
+  }
   return None;
 }
 
+status_t inquisitive_zip_container(std::wstring_view sv, inquisitive_result_t &ir) {
+  base::WindowView wv;
+  bela::error_code ec;
+  zip_directory_t zd;
+  if (!wv.Open(sv, ec, sizeof(zip_eocd_t)) || !zip_directory_locate(wv, zd, ec)) {
+    return None;
+  }
+  return zip_classify(wv, zd, ir);
+}
+
 status_t inquisitive_zip_family(base::MemView mv, inquisitive_result_t &ir) {
   if (!IsZip(mv.data(), mv.size())) {
     return None;
   }
-  if (inquisitive_msxmldocs(mv, ir) == Found) {
-    return Found;
-  }
-  ir.assign(L"Zip archive data", types::zip);
+  // prefix only tells zip, central directory entries tell which container it is
+  ir.assign(L"Zip archive data", types::zip, types::ZIP);
   return Found;
 }
 } // namespace inquisitive
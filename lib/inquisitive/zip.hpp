@@ -2,7 +2,13 @@
 #ifndef INQUISITIVE_ZIP_HPP
 #define INQUISITIVE_ZIP_HPP
 #include <cstdint>
+#include <string_view>
+#include <mapview.hpp>
+#include <bela/base.hpp>
+#include "inquisitive.hpp"
+#include "inflate.hpp"
 // https://en.wikipedia.org/wiki/Zip_(file_format)
+// https://pkware.cachefly.net/webdocs/casestudies/APPNOTE.TXT
 
 namespace inquisitive {
 // LE
@@ -21,24 +27,135 @@ struct zip_file_header_t {
   uint16_t fieldlength;
 };
 
-struct zip_file_info64_t {
-  uint16_t version;
-  uint16_t versionneeded;
-  uint16_t flag;
+struct zip_central_header_t {
+  uint32_t magic; // 0x02014b50 LE
+  uint16_t creatorversion;
+  uint16_t readerversion;
+  uint16_t flags;
   uint16_t method;
-  uint32_t dosdate; // uint61_t + uint64_t
-  uint32_t crc;
-  uint64_t compressedsize;
-  uint64_t uncompressedsize;
-  uint16_t sizefilename;
-  uint16_t sizefileextra;
-  uint16_t sizefilecomment;
-  uint16_t disknumstart;
-  uint16_t internalfa;
-  uint16_t externalfa;
+  uint16_t mtime;
+  uint16_t mdate;
+  uint32_t crc32;
+  uint32_t compressedsize;
+  uint32_t uncompressedsize;
+  uint16_t namelen;
+  uint16_t extralen;
+  uint16_t commentlen;
+  uint16_t disknumber;
+  uint16_t internalattrs;
+  uint32_t externalattrs;
+  uint32_t localoffset;
+};
+
+struct zip_eocd_t {
+  uint32_t magic; // 0x06054b50 LE
+  uint16_t disknumber;
+  uint16_t cddisknumber;
+  uint16_t diskentries;
+  uint16_t entries;
+  uint32_t cdsize;
+  uint32_t cdoffset;
+  uint16_t commentlen;
+};
+
+struct zip64_eocd_locator_t {
+  uint32_t magic; // 0x07064b50 LE
+  uint32_t disknumber;
+  uint64_t eocdoffset;
+  uint32_t disks;
+};
+
+struct zip64_eocd_t {
+  uint32_t magic; // 0x06064b50 LE
+  uint64_t recordsize;
+  uint16_t creatorversion;
+  uint16_t readerversion;
+  uint32_t disknumber;
+  uint32_t cddisknumber;
+  uint64_t diskentries;
+  uint64_t entries;
+  uint64_t cdsize;
+  uint64_t cdoffset;
 };
 
 #pragma pack()
+
+constexpr uint32_t zip_local_header_magic = 0x04034b50;
+constexpr uint32_t zip_central_header_magic = 0x02014b50;
+constexpr uint32_t zip_eocd_magic = 0x06054b50;
+constexpr uint32_t zip64_eocd_locator_magic = 0x07064b50;
+constexpr uint32_t zip64_eocd_magic = 0x06064b50;
+constexpr uint16_t zip64_extra_id = 0x0001;
+constexpr uint16_t zip_ntfs_extra_id = 0x000a;
+constexpr uint16_t zip_timestamp_extra_id = 0x5455;    // Info-ZIP extended timestamp 'UT'
+constexpr uint16_t zip_unicode_path_extra_id = 0x7075; // Info-ZIP Unicode path 'up'
+constexpr uint16_t zip_flag_encrypted = 0x0001;
+constexpr uint16_t zip_flag_utf8 = 0x0800; // language encoding flag (EFS)
+// compressed bytes read at most to sniff a deflated member
+constexpr size_t zip_sniff_input_max = 64 * 1024;
+// EOCD with max comment and ZIP64 locator ahead of it
+constexpr size_t zip_tail_size = sizeof(zip_eocd_t) + 0xFFFF + sizeof(zip64_eocd_locator_t);
+
+struct zip_directory_t {
+  uint64_t offset{0};     /// central directory offset, prefix included
+  uint64_t size{0};       /// central directory size
+  uint64_t entries{0};    /// total entries
+  uint64_t eocd{0};       /// end of central directory record offset
+  uint64_t prefix{0};     /// bytes before archive, such as self-extracting stub
+  uint16_t commentlen{0}; /// archive comment length
+  bool zip64{false};
+};
+
+// zip_entry_t points into mapped central directory, valid as long as the window is mapped
+struct zip_entry_t {
+  std::string_view name; /// Unicode path extra field replaces raw name when its CRC matches
+  std::string_view comment;
+  bela::MemView extra;
+  uint64_t compressedsize{0};
+  uint64_t uncompressedsize{0};
+  uint64_t localoffset{0}; /// local file header offset, prefix included
+  uint32_t crc32{0};
+  uint16_t flags{0};
+  uint16_t method{0};
+  uint16_t creatorversion{0};
+  uint16_t mtime{0};
+  uint16_t mdate{0};
+  uint32_t externalattrs{0};
+  int64_t unixmtime{-1}; /// extended timestamp or NTFS mtime as unix seconds, -1 if absent
+  bool utf8{false};      /// name is UTF-8, otherwise IBM437
+};
+
+// zip_central_reader walks central directory file headers in place, nothing is allocated
+class zip_central_reader {
+public:
+  zip_central_reader(bela::MemView mv, uint64_t prefix) : mv_(mv), prefix_(prefix) {}
+  bool next(zip_entry_t &e);
+  bool bad() const { return bad_; }
+  // count entries read by next agree with directory record
+  bool complete(uint64_t count, const zip_directory_t &zd) const;
+
+private:
+  bela::MemView mv_;
+  size_t pos_{0};
+  uint64_t prefix_{0};
+  bool bad_{false};
+};
+
+// locate EOCD by scanning backward over tail window, ZIP64 locator is honored
+bool zip_directory_locate(base::WindowView &wv, zip_directory_t &zd, bela::error_code &ec);
+
+// offset of member data behind local file header, 0 when local header is invalid
+uint64_t zip_data_offset(base::WindowView &wv, uint64_t localoffset, bela::error_code &ec);
+// first bytes of member data, stored member is viewed in place and deflated member is inflated by
+// s. view is valid until s is reused or window is evicted
+bela::MemView zip_member_prefix(base::WindowView &wv, const zip_entry_t &e, inflate_stream &s,
+                                size_t limit, bela::error_code &ec);
+// detect member content from its first few KB
+status_t zip_member_content(base::WindowView &wv, const zip_entry_t &e, inflate_stream &s,
+                            inquisitive_result_t &ir);
+// tell container (OOXML, ODF, APK, JAR...) from central directory entries
+status_t zip_classify(base::WindowView &wv, const zip_directory_t &zd, inquisitive_result_t &ir);
+
 } // namespace inquisitive
 
 #endif
@@ -0,0 +1,89 @@
+/// CRC-32 known answers, hardware kernel is compared with slicing-by-8 on every short length
+#include <cstdio>
+#include <vector>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#include "../lib/inquisitive/inquisitive.hpp"
+
+namespace inquisitive {
+// kernels of crc32.cc, crc is pre-inverted
+uint32_t crc32_slicing8(const uint8_t *p, size_t len, uint32_t crc);
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+uint32_t crc32_pclmul(const uint8_t *p, size_t len, uint32_t crc);
+#endif
+} // namespace inquisitive
+
+namespace {
+int failures = 0;
+
+void check(bool ok, const char *what, size_t len = 0) {
+  if (!ok) {
+    fprintf(stderr, "FAIL %s (length %zu)\n", what, len);
+    failures++;
+  }
+}
+
+// one bit at a time, reference for the table and folding kernels
+uint32_t crc32_bitwise(const uint8_t *p, size_t len) {
+  uint32_t c = 0xFFFFFFFF;
+  for (size_t i = 0; i < len; i++) {
+    c ^= p[i];
+    for (int k = 0; k < 8; k++) {
+      c = (c & 1) != 0 ? (0xEDB88320 ^ (c >> 1)) : (c >> 1);
+    }
+  }
+  return ~c;
+}
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+bool cpu_has_pclmul() {
+#if defined(_MSC_VER) && !defined(__clang__)
+  int regs[4] = {0};
+  __cpuid(regs, 1);
+  return (regs[2] & (1 << 1)) != 0;
+#else
+  return __builtin_cpu_supports("pclmul") != 0;
+#endif
+}
+#endif
+} // namespace
+
+int main() {
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+  auto pclmul = cpu_has_pclmul();
+  if (!pclmul) {
+    fprintf(stderr, "crc32: no pclmul on this cpu, folding kernel skipped\n");
+  }
+#endif
+  check(inquisitive::byte_crc32("123456789", 9) == 0xCBF43926, "check value of 123456789");
+  check(inquisitive::byte_crc32("", 0) == 0, "empty input");
+  // continued over two calls
+  check(inquisitive::byte_crc32("6789", 4, inquisitive::byte_crc32("12345", 5)) == 0xCBF43926,
+        "continued crc");
+
+  std::vector<uint8_t> buf(300 + 16);
+  uint32_t x = 2463534242;
+  for (auto &b : buf) {
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    b = static_cast<uint8_t>(x);
+  }
+  // every length up to 300 at a few misalignments, folding starts at 64 bytes
+  for (size_t offset : {0, 1, 3, 8, 15}) {
+    for (size_t len = 0; len <= 300; len++) {
+      auto p = buf.data() + offset;
+      auto want = crc32_bitwise(p, len);
+      check(~inquisitive::crc32_slicing8(p, len, 0xFFFFFFFF) == want, "slicing-by-8", len);
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+      check(!pclmul || ~inquisitive::crc32_pclmul(p, len, 0xFFFFFFFF) == want, "pclmul", len);
+#endif
+      check(inquisitive::byte_crc32(p, len) == want, "byte_crc32", len);
+    }
+  }
+  if (failures == 0) {
+    fprintf(stderr, "crc32: all passed\n");
+  }
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,245 @@
+/// known-answer tests of inflate_stream, vectors are raw DEFLATE made by zlib 1.2.13
+#include <cstdio>
+#include <string>
+#include "../lib/inquisitive/inflate.hpp"
+
+namespace {
+// "stored block, copied as is\n" at level 0
+constexpr uint8_t stored_block[] = {
+    0x01, 0x1b, 0x00, 0xe4, 0xff, 0x73, 0x74, 0x6f, 0x72, 0x65, 0x64, 0x20, 0x62, 0x6c, 0x6f, 0x63,
+    0x6b, 0x2c, 0x20, 0x63, 0x6f, 0x70, 0x69, 0x65, 0x64, 0x20, 0x61, 0x73, 0x20, 0x69, 0x73, 0x0a,
+};
+// "The quick brown fox jumps over the lazy dog. " three times, Z_FIXED
+constexpr uint8_t fixed_block[] = {
+    0x0b, 0xc9, 0x48, 0x55, 0x28, 0x2c, 0xcd, 0x4c, 0xce, 0x56, 0x48, 0x2a, 0xca, 0x2f, 0xcf, 0x53,
+    0x48, 0xcb, 0xaf, 0x50, 0xc8, 0x2a, 0xcd, 0x2d, 0x28, 0x56, 0xc8, 0x2f, 0x4b, 0x2d, 0x52, 0x28,
+    0x01, 0x4a, 0xe7, 0x24, 0x56, 0x55, 0x2a, 0xa4, 0xe4, 0xa7, 0xeb, 0x29, 0x84, 0xd0, 0x4c, 0x31,
+    0x00,
+};
+// pattern(150000), dynamic Huffman
+constexpr uint8_t dynamic_block[] = {
+    0xed, 0xda, 0x5b, 0xb2, 0xd3, 0x3a, 0x00, 0x05, 0xd1, 0xb1, 0xca, 0x7a, 0x59, 0x92, 0xf5, 0x98,
+    0xff, 0x17, 0xca, 0x30, 0x80, 0x55, 0x7c, 0xc0, 0xad, 0xcb, 0x09, 0x8e, 0xdb, 0xdd, 0x5b, 0x55,
+    0x49, 0xec, 0xef, 0xbb, 0x9e, 0x12, 0x63, 0xcf, 0xdf, 0xd8, 0x6f, 0x2f, 0x75, 0xad, 0x33, 0x73,
+    0xf8, 0x72, 0xef, 0xe1, 0x2d, 0xa7, 0xe4, 0x37, 0x85, 0x35, 0x76, 0xce, 0xef, 0xfb, 0xc6, 0xd2,
+    0x63, 0xcd, 0xef, 0x0c, 0x2d, 0x9e, 0xfa, 0x94, 0x10, 0xc3, 0xd8, 0xcf, 0xf3, 0x95, 0xfa, 0x7e,
+    0x2b, 0xd6, 0x19, 0x66, 0xcd, 0xfb, 0x94, 0x14, 0xf6, 0x19, 0xf5, 0xeb, 0x25, 0xe6, 0x67, 0xee,
+    0xa7, 0xef, 0xb3, 0xeb, 0x17, 0x72, 0xfb, 0xfd, 0xd7, 0x0e, 0xfb, 0xdb, 0x6b, 0xa4, 0x67, 0x8f,
+    0x3c, 0xbe, 0xb9, 0x6a, 0x58, 0xad, 0xc4, 0x52, 0xce, 0x33, 0x72, 0xc9, 0x3b, 0xdd, 0x1f, 0x1a,
+    0x75, 0x9e, 0x99, 0x4a, 0x3c, 0x3b, 0x8f, 0xd6, 0x5a, 0x7f, 0x46, 0xda, 0xbb, 0xc4, 0x16, 0xc2,
+    0xb7, 0x43, 0xcb, 0x75, 0xce, 0xf5, 0xc4, 0x10, 0xfb, 0x28, 0x27, 0x3d, 0x65, 0xee, 0x74, 0xca,
+    0x2c, 0xef, 0x9c, 0x7b, 0xce, 0x33, 0x62, 0x28, 0x2b, 0xd4, 0x94, 0xef, 0x05, 0xee, 0x37, 0xf4,
+    0xb1, 0x43, 0x3f, 0xf3, 0x4b, 0xf1, 0x0b, 0xa9, 0xa7, 0xb3, 0xfb, 0xb3, 0xf2, 0x6c, 0xdf, 0x08,
+    0x35, 0xbc, 0xdf, 0xd7, 0xeb, 0x3b, 0x5b, 0x1c, 0x27, 0x85, 0x39, 0x53, 0xc8, 0x73, 0x9f, 0x56,
+    0xcb, 0xfb, 0xec, 0xb0, 0x9e, 0xe7, 0x5e, 0x43, 0x6e, 0x23, 0x96, 0x33, 0x72, 0xed, 0x25, 0xf5,
+    0x1e, 0x57, 0x8c, 0xa3, 0x3f, 0x6d, 0xcd, 0x16, 0xda, 0xca, 0x5f, 0x98, 0xe1, 0xbe, 0x89, 0xef,
+    0xad, 0x69, 0x85, 0xf6, 0xb5, 0xb7, 0xb7, 0x91, 0x57, 0xed, 0x39, 0x87, 0xfb, 0xcf, 0x7e, 0xb5,
+    0xde, 0xf7, 0x33, 0xee, 0xdd, 0x5a, 0xf7, 0xc5, 0x77, 0xbb, 0xd7, 0x12, 0x62, 0x9a, 0x69, 0xc7,
+    0xd6, 0xf7, 0xec, 0xf9, 0xed, 0xe1, 0x2b, 0xcf, 0x7a, 0x4b, 0xef, 0xf9, 0x5e, 0x51, 0xf8, 0xd6,
+    0xdc, 0x23, 0xe6, 0xd6, 0x67, 0xff, 0x66, 0xa9, 0xb5, 0xc5, 0x95, 0x7e, 0xff, 0xfb, 0xf4, 0xef,
+    0xbd, 0x6f, 0x7e, 0xa5, 0xfb, 0x03, 0x4f, 0x5c, 0xdf, 0xc8, 0xdf, 0xfd, 0x2d, 0xa6, 0x54, 0x72,
+    0x79, 0x57, 0x7b, 0xc6, 0xd7, 0x53, 0x49, 0x79, 0x94, 0x1c, 0x77, 0x8a, 0xf7, 0x5e, 0x84, 0x77,
+    0xae, 0xaf, 0xac, 0xf7, 0xfe, 0x74, 0x7c, 0xc2, 0x7d, 0xa9, 0x34, 0xfa, 0x1a, 0x67, 0xb5, 0xef,
+    0x5b, 0xad, 0x87, 0x18, 0x4b, 0xee, 0xbb, 0xd4, 0x1e, 0xe7, 0x59, 0x5f, 0x2c, 0x23, 0x95, 0xb2,
+    0xea, 0xbe, 0x7f, 0x6a, 0x25, 0x84, 0x39, 0x46, 0x7c, 0x9e, 0xf1, 0xbc, 0xa5, 0x8c, 0xf7, 0x42,
+    0xaf, 0x67, 0xcf, 0x78, 0xfa, 0x8e, 0xf7, 0xca, 0x62, 0xa8, 0x31, 0xdf, 0x0b, 0xdc, 0x5f, 0x3b,
+    0xbb, 0x3c, 0xe9, 0xfe, 0x53, 0xbb, 0x9f, 0x73, 0x2f, 0x7d, 0xec, 0x55, 0xe3, 0xbd, 0xa9, 0xcf,
+    0x13, 0xce, 0x65, 0xd4, 0x7f, 0x7f, 0x27, 0x7c, 0x61, 0xa7, 0xda, 0xee, 0x4f, 0xe5, 0x5e, 0xc7,
+    0xac, 0x6f, 0x78, 0x4e, 0xbf, 0x77, 0xf5, 0xde, 0xfc, 0x9c, 0x67, 0xed, 0x6d, 0xbd, 0xbd, 0xde,
+    0x37, 0xff, 0xc3, 0x10, 0xfa, 0x6e, 0x17, 0x63, 0x0b, 0xcf, 0x4c, 0xf7, 0xb1, 0x89, 0xf7, 0x6f,
+    0xc7, 0x79, 0x9f, 0x88, 0x19, 0xea, 0xb3, 0x2f, 0xa4, 0x39, 0xea, 0xba, 0x77, 0xf4, 0x2d, 0xbb,
+    0xe5, 0x30, 0xfb, 0xe9, 0x7d, 0x8f, 0x37, 0x3f, 0xfb, 0xe4, 0x78, 0x7f, 0x8b, 0xe1, 0x29, 0xcf,
+    0xdb, 0xe7, 0xbb, 0xf6, 0x0c, 0xa3, 0xa5, 0x4b, 0x34, 0x8c, 0x53, 0xef, 0x5b, 0x38, 0x61, 0x9e,
+    0x34, 0xe6, 0xfa, 0xdd, 0xbd, 0x0b, 0xfb, 0x4b, 0xf5, 0xac, 0xfb, 0xaa, 0x97, 0xe4, 0xbd, 0x23,
+    0xf7, 0x6d, 0xfc, 0x1e, 0xa1, 0x7b, 0xc3, 0xd3, 0xb9, 0x17, 0x3f, 0xcb, 0xf8, 0x61, 0x3f, 0xa3,
+    0x94, 0xf7, 0x3e, 0x63, 0xe5, 0xf7, 0xb8, 0x5f, 0xfa, 0x97, 0x4c, 0x38, 0x97, 0xff, 0x09, 0xef,
+    0x7d, 0xf5, 0xba, 0xea, 0xd3, 0xbe, 0x53, 0x7b, 0xb8, 0x17, 0xfe, 0xd4, 0xd6, 0x73, 0x1c, 0x6b,
+    0x5e, 0x96, 0xf7, 0x69, 0x69, 0xbb, 0xdd, 0x17, 0x4d, 0xe3, 0xf4, 0xf8, 0xc5, 0xf7, 0x5e, 0xef,
+    0xfd, 0xd5, 0x5a, 0x4d, 0x7b, 0xae, 0x54, 0xbf, 0x6b, 0x54, 0xb8, 0x77, 0x2c, 0x5d, 0x2c, 0xfd,
+    0xb4, 0x2f, 0x94, 0xef, 0xec, 0xfb, 0xe8, 0xb6, 0x94, 0xe3, 0x37, 0x7e, 0x8f, 0xdd, 0x13, 0xaf,
+    0x40, 0x3b, 0xb5, 0xfa, 0x8c, 0xf6, 0x7c, 0xfd, 0xbb, 0x22, 0xbe, 0x39, 0xac, 0x72, 0x9f, 0xf8,
+    0x7b, 0xe9, 0xe9, 0x99, 0xf7, 0xad, 0x86, 0x67, 0xf4, 0xde, 0xd3, 0xd7, 0x6a, 0x2e, 0xe7, 0xbd,
+    0x0f, 0x4c, 0x78, 0x7f, 0xf7, 0xf6, 0x3e, 0xf3, 0x6d, 0xd6, 0xf1, 0xf4, 0x1a, 0x4f, 0x2c, 0xeb,
+    0x22, 0x7b, 0xd2, 0xbd, 0xff, 0xf7, 0x42, 0xe3, 0x2e, 0xed, 0x84, 0x3c, 0xee, 0x2b, 0xf7, 0x79,
+    0xef, 0xe8, 0x9b, 0xea, 0x88, 0xf3, 0xad, 0x67, 0xbe, 0xe3, 0x49, 0xd7, 0x9d, 0x15, 0xee, 0x9b,
+    0xe7, 0x3f, 0xff, 0xf9, 0xcf, 0x7f, 0xfe, 0xf3, 0x9f, 0xff, 0xfc, 0xe7, 0x3f, 0xff, 0xf9, 0xff,
+    0xdf, 0xf8, 0x8f, 0xbf, 0xfe, 0xeb, 0xbf, 0xfe, 0xf3, 0x5f, 0xff, 0xf1, 0xd7, 0x7f, 0xfd, 0xd7,
+    0x7f, 0xfe, 0xeb, 0x3f, 0xfe, 0xfa, 0xaf, 0xff, 0xff, 0x7e, 0xff, 0xf1, 0xb7, 0xff, 0xfa, 0x6f,
+    0xff, 0xf1, 0xb7, 0xff, 0xfa, 0x6f, 0xff, 0xf1, 0xb7, 0xff, 0xfa, 0x6f, 0xff, 0xf1, 0xb7, 0xff,
+    0xfa, 0x6f, 0xff, 0xf1, 0xc7, 0x1f, 0x7f, 0xe7, 0x3f, 0xfb, 0xef, 0xfc, 0x87, 0xbf, 0xf3, 0x9f,
+    0xfe, 0xdb, 0x7f, 0xfc, 0xf1, 0xc7, 0xdf, 0xf9, 0xcf, 0xfe, 0xdb, 0x7f, 0xfe, 0xf3, 0x9f, 0xff,
+    0xfc, 0xe7, 0x3f, 0xff, 0xf9, 0xcf, 0x7f, 0xfe, 0xf3, 0x9f, 0xff, 0xfc, 0xe7, 0x3f, 0xff, 0xf9,
+    0xef, 0xf3, 0x1f, 0xfc, 0xf5, 0x5f, 0xff, 0xf5, 0x9f, 0xff, 0xfa, 0x8f, 0xbf, 0xfe, 0xeb, 0xbf,
+    0xfe, 0xf3, 0x5f, 0xff, 0xf1, 0xd7, 0x7f, 0xfd, 0xf7, 0xfd, 0x1f, 0xfc, 0xed, 0xbf, 0xfe, 0xdb,
+    0x7f, 0xfc, 0xed, 0xbf, 0xfe, 0xdb, 0x7f, 0xfc, 0xed, 0xbf, 0xfe, 0xdb, 0x7f, 0xfc, 0xed, 0xbf,
+    0xfe, 0xdb, 0x7f, 0xfc, 0xf1, 0xc7, 0xdf, 0xf9, 0xcf, 0xfe, 0x3b, 0xff, 0xe1, 0xef, 0xfc, 0xa7,
+    0xff, 0xf6, 0x1f, 0x7f, 0xfc, 0xf1, 0x77, 0xfe, 0xb3, 0xff, 0xf6, 0x9f, 0xff, 0xfc, 0xe7, 0x3f,
+    0xff, 0xf9, 0xcf, 0x7f, 0xfe, 0xf3, 0x9f, 0xff, 0xfc, 0xe7, 0x3f, 0xff, 0xf9, 0xcf, 0x7f, 0xfe,
+    0xfb, 0xfc, 0x07, 0x7f, 0xfd, 0xd7, 0x7f, 0xfd, 0xe7, 0xbf, 0xfe, 0xe3, 0xaf, 0xff, 0xfa, 0xaf,
+    0xff, 0xfc, 0xd7, 0x7f, 0xfc, 0xf5, 0x5f, 0xff, 0x7d, 0xff, 0xc7, 0xfe, 0xeb, 0xbf, 0xfd, 0xc7,
+    0xdf, 0xfe, 0xeb, 0xbf, 0xfd, 0xc7, 0xdf, 0xfe, 0xeb, 0xbf, 0xfd, 0xc7, 0xdf, 0xfe, 0xeb, 0xbf,
+    0xfd, 0xc7, 0x1f, 0x7f, 0xfc, 0x9d, 0xff, 0xec, 0xbf, 0xf3, 0x1f, 0xfe, 0xce, 0x7f, 0xfa, 0x6f,
+    0xff, 0xf1, 0xc7, 0x1f, 0x7f, 0xe7, 0x3f, 0xfb, 0x6f, 0xff, 0xf9, 0xcf, 0x7f, 0xfe, 0xf3, 0x9f,
+    0xff, 0xfc, 0xe7, 0x3f, 0xff, 0xf9, 0xcf, 0x7f, 0xfe, 0xf3, 0x9f, 0xff, 0xfc, 0xe7, 0xbf, 0xcf,
+    0x7f, 0xf0, 0xd7, 0x7f, 0xfd, 0xd7, 0x7f, 0xfe, 0xeb, 0x3f, 0xfe, 0xfa, 0xaf, 0xff, 0xfa, 0xcf,
+    0x7f, 0xfd, 0xc7, 0x5f, 0xff, 0xf5, 0xdf, 0xf7, 0x7f, 0xf0, 0xb7, 0xff, 0xfa, 0x6f, 0xff, 0xf1,
+    0xb7, 0xff, 0xfa, 0x6f, 0xff, 0xf1, 0xb7, 0xff, 0xfa, 0x6f, 0xff, 0xf1, 0xb7, 0xff, 0xfa, 0x6f,
+    0xff, 0xf1, 0xc7, 0x1f, 0x7f, 0xe7, 0x3f, 0xfb, 0xef, 0xfc, 0x87, 0xbf, 0xf3, 0x9f, 0xfe, 0xdb,
+    0x7f, 0xfc, 0xf1, 0xc7, 0xdf, 0xf9, 0xcf, 0xfe, 0xdb, 0x7f, 0xfe, 0xf3, 0x9f, 0xff, 0xfc, 0xe7,
+    0x3f, 0xff, 0xf9, 0xcf, 0x7f, 0xfe, 0xf3, 0x9f, 0xff, 0xfc, 0xe7, 0x3f, 0xff, 0xf9, 0xef, 0xf3,
+    0x1f, 0xfc, 0xf5, 0x5f, 0xff, 0xf5, 0x9f, 0xff, 0xfa, 0x8f, 0xbf, 0xfe, 0xeb, 0xbf, 0xfe, 0xf3,
+    0x5f, 0xff, 0xf1, 0xd7, 0x7f, 0xfd, 0xf7, 0xfd, 0x1f, 0xfc, 0xf5, 0xdf, 0xfe, 0xe3, 0x6f, 0xff,
+    0xf5, 0xdf, 0xfe, 0xe3, 0x6f, 0xff, 0xf5, 0xdf, 0xfe, 0xe3, 0x6f, 0xff, 0xf5, 0xdf, 0xfe, 0xe3,
+    0x8f, 0x3f, 0xfe, 0xce, 0x7f, 0xf6, 0xdf, 0xf9, 0x0f, 0x7f, 0xe7, 0x3f, 0xfd, 0xb7, 0xff, 0xf8,
+    0xe3, 0x8f, 0xbf, 0xf3, 0x9f, 0xfd, 0xb7, 0xff, 0xfc, 0xe7, 0x3f, 0xff, 0xf9, 0xcf, 0x7f, 0xfe,
+    0xf3, 0x9f, 0xff, 0xfc, 0xe7, 0x3f, 0xff, 0xf9, 0xcf, 0x7f, 0xfe, 0xf3, 0xdf, 0xe7, 0x3f, 0xf8,
+    0xeb, 0xbf, 0xfe, 0xeb, 0x3f, 0xff, 0xf5, 0x1f, 0x7f, 0xfd, 0xd7, 0x7f, 0xfd, 0xe7, 0xbf, 0xfe,
+    0xe3, 0xaf, 0xff, 0xfa, 0xef, 0xfb, 0x3f, 0xf8, 0xdb, 0x7f, 0xfd, 0xb7, 0xff, 0xf8, 0xdb, 0x7f,
+    0xfd, 0xb7, 0xff, 0xf8, 0xdb, 0x7f, 0xfd, 0xb7, 0xff, 0xf8, 0xdb, 0x7f, 0xfd, 0xb7, 0xff, 0xf8,
+    0xe3, 0x8f, 0xbf, 0xf3, 0x9f, 0xfd, 0x77, 0xfe, 0xc3, 0xdf, 0xf9, 0x4f, 0xff, 0xed, 0x3f, 0xfe,
+    0xf8, 0xe3, 0xef, 0xfc, 0x67, 0xff, 0xed, 0x3f, 0xff, 0xf9, 0xcf, 0x7f, 0xfe, 0xf3, 0x9f, 0xff,
+    0xfc, 0xe7, 0x3f, 0xff, 0xf9, 0xcf, 0x7f, 0xfe, 0xf3, 0x9f, 0xff, 0xfc, 0xf7, 0xf9, 0x0f, 0xfe,
+    0xfa, 0xaf, 0xff, 0xfa, 0xcf, 0x7f, 0xfd, 0xc7, 0x5f, 0xff, 0xf5, 0x5f, 0xff, 0xf9, 0xaf, 0xff,
+    0xf8, 0xeb, 0xbf, 0xfe, 0xfb, 0xfe, 0x0f, 0xfe, 0xf6, 0xdf, 0xfe, 0xe3, 0x6f, 0xff, 0xf5, 0xdf,
+    0xfe, 0xe3, 0x6f, 0xff, 0xf5, 0xdf, 0xfe, 0xe3, 0x6f, 0xff, 0xf5, 0xdf, 0xfe, 0xe3, 0x8f, 0x3f,
+    0xfe, 0xce, 0x7f, 0xf6, 0xdf, 0xf9, 0x0f, 0x7f, 0xe7, 0x3f, 0xfd, 0xb7, 0xff, 0xf8, 0xe3, 0x8f,
+    0xbf, 0xf3, 0x9f, 0xfd, 0xb7, 0xff, 0xfc, 0xe7, 0x3f, 0xff, 0xf9, 0xcf, 0x7f, 0xfe, 0xf3, 0x9f,
+    0xff, 0xfc, 0xe7, 0x3f, 0xff, 0xf9, 0xcf, 0x7f, 0xfe, 0xf3, 0xdf, 0xe7, 0x3f, 0xf8, 0xeb, 0xbf,
+    0xfe, 0xeb, 0x3f, 0xff, 0xf5, 0x1f, 0x7f, 0xfd, 0xd7, 0x7f, 0xfd, 0xe7, 0xbf, 0xfe, 0xe3, 0xaf,
+    0xff, 0xfa, 0xef, 0xfb, 0x3f, 0xf8, 0xdb, 0x7f, 0xfd, 0xb7, 0xff, 0xf8, 0xdb, 0x7f, 0xfd, 0xb7,
+    0xff, 0xf8, 0xdb, 0x7f, 0xfd, 0xb7, 0xff, 0xf8, 0xdb, 0x7f, 0xfd, 0xb7, 0xff, 0xf8, 0xe3, 0x8f,
+    0xbf, 0xf3, 0x9f, 0xfd, 0x77, 0xfe, 0xc3, 0xdf, 0xf9, 0x4f, 0xff, 0xed, 0x3f, 0xfe, 0xf8, 0xe3,
+    0xef, 0xfc, 0x67, 0xff, 0xed, 0x3f, 0xff, 0xf9, 0xcf, 0x7f, 0xfe, 0xf3, 0x9f, 0xff, 0xfc, 0xe7,
+    0x3f, 0xff, 0xf9, 0xcf, 0x7f, 0xfe, 0xf3, 0x9f, 0xff, 0xfc, 0xf7, 0xf9, 0x0f, 0xfe, 0xfa, 0xaf,
+    0xff, 0xfa, 0xcf, 0x7f, 0xfd, 0xc7, 0x5f, 0xff, 0xf5, 0x5f, 0xff, 0xf9, 0xaf, 0xff, 0xf8, 0xeb,
+    0xbf, 0xfe, 0xfb, 0xfe, 0x0f, 0xfe, 0xf6, 0x5f, 0xff, 0xf1, 0xb7, 0xff, 0xfa, 0x6f, 0xff, 0xf1,
+    0xb7, 0xff, 0xfa, 0x6f, 0xff, 0xf1, 0xb7, 0xff, 0xfa, 0x6f, 0xff, 0xf1, 0xc7, 0x1f, 0x7f, 0xe7,
+    0x3f, 0xfb, 0xef, 0xfc, 0x87, 0xbf, 0xf3, 0x9f, 0xfe, 0xdb, 0x7f, 0xfc, 0xf1, 0xc7, 0xdf, 0xf9,
+    0xcf, 0xfe, 0xdb, 0x7f, 0xfe, 0xf3, 0x9f, 0xff, 0xfc, 0xe7, 0x3f, 0xff, 0xf9, 0xcf, 0x7f, 0xfe,
+    0xff, 0x1d, 0xfe, 0xff, 0x01,
+};
+// MSZIP style, second stream is compressed with first output as dictionary
+constexpr uint8_t mszip_first[] = {
+    0xf3, 0x0d, 0x8e, 0xf2, 0x0c, 0x50, 0x48, 0xca, 0xc9, 0x4f, 0xce, 0x56, 0xc8, 0xcf, 0x4b, 0xd5,
+    0x51, 0xc8, 0x49, 0x2c, 0x49, 0x2d, 0x82, 0x08, 0x14, 0x2b, 0x14, 0xa5, 0xa6, 0x81, 0x38, 0x89,
+    0x40, 0xc9, 0x92, 0x7c, 0x85, 0x92, 0x8c, 0xcc, 0x62, 0x85, 0x92, 0xd4, 0x8a, 0x12, 0x3d, 0x05,
+    0xdf, 0xa1, 0xa0, 0x0d, 0x00,
+};
+constexpr uint8_t mszip_second[] = {
+    0x43, 0xd6, 0x56, 0x52, 0x9e, 0x0f, 0x51, 0x58, 0x0c, 0x56, 0x69, 0x45, 0x9e, 0xcd, 0x00,
+};
+
+int failures = 0;
+
+void check(bool ok, const char *what) {
+  if (!ok) {
+    fprintf(stderr, "FAIL %s\n", what);
+    failures++;
+  }
+}
+
+// 1024 pseudo-random letters, then copies from 1024 to 2560 bytes back, 258-byte matches
+// straddle every 64K output chunk
+std::string pattern(size_t n) {
+  std::string out;
+  uint32_t x = 2463534242;
+  for (size_t i = 0; i < n; i++) {
+    if (i < 1024) {
+      x ^= x << 13;
+      x ^= x >> 17;
+      x ^= x << 5;
+      out.push_back(static_cast<char>('a' + (x >> 28)));
+      continue;
+    }
+    out.push_back(out[i - 1024 - 512 * ((i / 4096) % 4)]);
+  }
+  return out;
+}
+
+std::string drain(inquisitive::inflate_stream &s, size_t max = inquisitive::inflate_chunk_size) {
+  std::string out;
+  while (!s.eof()) {
+    auto v = s.read(max);
+    out.append(reinterpret_cast<const char *>(v.data()), v.size());
+  }
+  return out;
+}
+
+// input handed in parts of window bytes, as verify does with mapped windows
+std::string feed(inquisitive::inflate_stream &s, const uint8_t *data, size_t size, size_t window) {
+  std::string out;
+  size_t pos = 0;
+  auto part = [&](bool first) {
+    auto n = size - pos < window ? size - pos : window;
+    if (first) {
+      s.reset(data + pos, n, pos + n < size);
+    } else {
+      s.feed(data + pos, n, pos + n < size);
+    }
+  };
+  part(true);
+  while (!s.eof()) {
+    auto v = s.read();
+    out.append(reinterpret_cast<const char *>(v.data()), v.size());
+    if (s.starved()) {
+      pos += s.input_used();
+      part(false);
+    }
+  }
+  return out;
+}
+} // namespace
+
+int main() {
+  inquisitive::inflate_stream s;
+  s.reset(stored_block, sizeof(stored_block));
+  check(drain(s) == "stored block, copied as is\n" && s.done(), "stored block");
+
+  std::string fox;
+  for (int i = 0; i < 3; i++) {
+    fox.append("The quick brown fox jumps over the lazy dog. ");
+  }
+  s.reset(fixed_block, sizeof(fixed_block));
+  check(drain(s) == fox && s.done(), "fixed block");
+  s.reset(fixed_block, sizeof(fixed_block));
+  check(drain(s, 7) == fox && s.done(), "fixed block read 7 bytes at a time");
+
+  auto big = pattern(150000);
+  s.reset(dynamic_block, sizeof(dynamic_block));
+  check(drain(s) == big && s.done() && s.total_out() == big.size(),
+        "dynamic block over 64K chunks");
+  check(s.consumed() == sizeof(dynamic_block), "consumed ends at stream end");
+
+  // gzip trailer follows stream, consumed() points at it
+  std::string trailed(reinterpret_cast<const char *>(dynamic_block), sizeof(dynamic_block));
+  trailed.append(8, '\x55');
+  s.reset(reinterpret_cast<const uint8_t *>(trailed.data()), trailed.size());
+  check(drain(s) == big && s.consumed() == sizeof(dynamic_block), "consumed before trailer");
+
+  for (size_t cut : {size_t(1), sizeof(dynamic_block) / 2, sizeof(dynamic_block) - 1}) {
+    s.reset(dynamic_block, cut);
+    auto out = drain(s);
+    check(!s.done() && !s.bad() && big.compare(0, out.size(), out) == 0, "truncated input");
+  }
+
+  for (size_t window : {size_t(1025), size_t(1100), size_t(1500), sizeof(dynamic_block)}) {
+    check(feed(s, dynamic_block, sizeof(dynamic_block), window) == big && s.done(),
+          "dynamic block fed in parts");
+  }
+
+  std::string first;
+  for (int i = 0; i < 4; i++) {
+    first.append("MSZIP block one, later blocks refer back to this text. ");
+  }
+  s.reset(mszip_first, sizeof(mszip_first));
+  check(drain(s) == first && s.done(), "first MSZIP block");
+  std::string second = "MSZIP block two refers back: later blocks refer back to this text. ";
+  second.append("MSZIP block one");
+  s.resume(mszip_second, sizeof(mszip_second));
+  check(drain(s) == second && s.done(), "resume refers to previous block");
+
+  if (failures == 0) {
+    fprintf(stderr, "inflate: all passed\n");
+  }
+  return failures == 0 ? 0 : 1;
+}
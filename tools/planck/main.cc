@@ -1,6 +1,10 @@
 ///
+#include <cmath>
 #include <string>
 #include <string_view>
+#include <optional>
+#include <bela/numbers.hpp>
+#include <bela/terminal.hpp>
 #include "resolve.hpp"
 #include "console/console.hpp"
 #include "inquisitive.hpp"
@@ -9,6 +13,11 @@
 struct AppArgv {
   std::vector<std::wstring_view> files;
   bool verbose{false};
+  bool list{false};
+  bool recursive{false};
+  bool verify{false};
+  std::wstring_view exportname; /// --export=NAME
+  inquisitive::nested_options_t nested;
   void push_back(std::wstring_view sv) { files.push_back(sv); }
   auto empty() const { return files.empty(); }
   auto begin() const { return files.begin(); }
@@ -27,15 +36,44 @@ template <typename... Args> bool IsSameArg(std::wstring_view sv, Args... args) {
   return false;
 }
 
+// --name=N with N in [lo, hi], bad is set when arg is this option but N is not such number
+std::optional<uint64_t> OptionValue(std::wstring_view arg, std::wstring_view name, uint64_t lo,
+                                    uint64_t hi, bool &bad) {
+  if (arg.size() < name.size() || arg.compare(0, name.size(), name) != 0) {
+    return std::nullopt;
+  }
+  uint64_t v = 0;
+  if (!bela::SimpleAtoi(arg.substr(name.size()), &v) || v < lo || v > hi) {
+    bad = true;
+    return std::nullopt;
+  }
+  return std::make_optional(v);
+}
+
+bool ProcessList(std::wstring_view sv, FILE *out);
+
 void Usage() {
-  constexpr const auto kUsage = LR"(FileView)";
+  constexpr const auto kUsage = LR"(planck - file type detect tools
+usage: planck [option] file ...
+  -h|--help        Show usage text and quit
+  -v|--version     Show version number and quit
+  -V|--verbose     Make the operation more talkative
+  -l|--list        List entries of ZIP (JAR, APK, OOXML...) or TAR archive, - reads TAR from stdin
+  -r|--recursive   Open ZIP, TAR, ar, CAB, gzip and stored 7z recursively, detect every member
+  --depth=N        Containers nested deeper than N are not opened (default 8)
+  --max-members=N  Detect at most N members (default 1000000)
+  --ratio=N        Refuse members expanding more than N times (default 200)
+  --memory=N       Hold at most N MiB of decompressed members at once (default 512)
+  --verify         Check CRC-32 of ZIP members, CRC-32 and size of gzip members, Mach-O page hashes
+  --export=NAME    Look up export NAME (or #ordinal) of PE image
+)";
   planck::PrintNone(L"%s", kUsage);
 }
 
 bool ParseArgv(int argc, wchar_t **argv, AppArgv &av) {
   for (int i = 1; i < argc; i++) {
     auto arg = argv[i];
-    if (arg[0] != L'-') {
+    if (arg[0] != L'-' || arg[1] == 0) {
       av.push_back(arg);
       continue;
     }
@@ -44,6 +82,39 @@ bool ParseArgv(int argc, wchar_t **argv, AppArgv &av) {
       planck::VerboseEnable();
       continue;
     }
+    if (IsSameArg(arg, L"-l", L"--list")) {
+      av.list = true;
+      continue;
+    }
+    if (IsSameArg(arg, L"-r", L"--recursive")) {
+      av.recursive = true;
+      continue;
+    }
+    if (IsSameArg(arg, L"--verify")) {
+      av.verify = true;
+      continue;
+    }
+    if (std::wstring_view sv(arg); sv.size() > 9 && sv.compare(0, 9, L"--export=") == 0) {
+      av.exportname = sv.substr(9);
+      continue;
+    }
+    bool bad = false;
+    if (auto v = OptionValue(arg, L"--depth=", 0, UINT32_MAX, bad); v) {
+      av.nested.depth = static_cast<uint32_t>(*v);
+      continue;
+    }
+    if (auto v = OptionValue(arg, L"--max-members=", 1, UINT64_MAX, bad); v) {
+      av.nested.members = *v;
+      continue;
+    }
+    if (auto v = OptionValue(arg, L"--ratio=", 1, UINT64_MAX, bad); v) {
+      av.nested.ratio = *v;
+      continue;
+    }
+    if (auto v = OptionValue(arg, L"--memory=", 1, UINT64_MAX >> 20, bad); v) {
+      av.nested.memory = *v << 20;
+      continue;
+    }
     if (IsSameArg(arg, L"-v", L"--version")) {
       printf("1.0\n");
       exit(0);
@@ -52,6 +123,12 @@ bool ParseArgv(int argc, wchar_t **argv, AppArgv &av) {
       Usage();
       exit(0);
     }
+    if (bad) {
+      bela::FPrintF(stderr, L"planck: invalid value '%s'\n", arg);
+    } else {
+      bela::FPrintF(stderr, L"planck: unknown option '%s', see --help\n", arg);
+    }
+    exit(1);
   }
   if (av.empty()) {
     //
@@ -65,39 +142,229 @@ std::optional<std::wstring> FileTarget(std::wstring_view sv, bool verbose) {
   return std::nullopt;
 }
 
-int wmain(int argc, wchar_t **argv) {
-  planck::VerboseEnable();
-  if (argc < 2) {
-    wprintf(L"%s usage file\n", argv[0]);
-    return 1;
-  }
+int ProcessFile(std::wstring_view file, bool verify) {
   bela::error_code ec;
-  auto hlink = inquisitive::ResolveTarget(argv[1], ec);
-  auto link = inquisitive::ResolveLinks(argv[1], ec);
+  auto hlink = inquisitive::ResolveTarget(file, ec);
+  auto link = inquisitive::ResolveLinks(file, ec);
   if (link) {
     wprintf(L"File %s hardlinks:\n", link->self.c_str());
     for (const auto &l : link->links) {
       wprintf(L"    %s\n", l.data());
     }
   }
-  auto ir = inquisitive::inquisitive(argv[1], ec);
+  auto ir = inquisitive::inquisitive(file, ec);
   if (ec) {
     planck::error(L"Error %s\n", ec.message);
     return 0;
   }
   if (ir) {
     if (ir->typeex() == inquisitive::types::PECOFF) {
-      auto ps = inquisitive::inquisitive_pecoff(argv[1], ec);
+      auto ps = inquisitive::inquisitive_pecoff(
+          file, ec,
+          inquisitive::PeResources | inquisitive::PeClr | inquisitive::PeSections);
       if (!ec && ps) {
         ir->add(L"Machine", ps->machine);
         ir->add(L"Subsystem", ps->subsystem);
         if (!ps->clrmsg.empty()) {
           ir->add(L"CLR", ps->clrmsg);
         }
+        if (ps->clr) {
+          auto display = [](const inquisitive::pe_assembly_t &a) {
+            return bela::StringCat(a.name, L", Version=", a.version, L", Culture=",
+                                   a.culture.empty() ? L"neutral" : a.culture,
+                                   L", PublicKeyToken=", a.token.empty() ? L"null" : a.token);
+          };
+          const auto &clr = *ps->clr;
+          if (clr.assembly) {
+            ir->add(L"Assembly", display(*clr.assembly));
+          }
+          ir->add(L"Types", clr.typedefs);
+          ir->add(L"Methods", clr.methoddefs);
+          if (clr.readytorun) {
+            ir->add(L"ReadyToRun", bela::StringCat(clr.r2rmajor, L".", clr.r2rminor));
+          }
+          std::vector<std::wstring> refs;
+          for (const auto &r : clr.references) {
+            refs.emplace_back(display(r));
+          }
+          if (!refs.empty()) {
+            ir->add(L"References", std::move(refs));
+          }
+        }
         ir->add(L"Depends", ps->depends);
         if (!ps->delays.empty()) {
           ir->add(L"Delay Depends", ps->delays);
         }
+        if (ps->version) {
+          ir->add(L"Product Name", ps->version->ProductName);
+          ir->add(L"Product Version", ps->version->ProductVersion);
+          ir->add(L"File Version", ps->version->FileVersion);
+          ir->add(L"Copyright", ps->version->LegalCopyright);
+        }
+        if (ps->pdb) {
+          ir->add(L"PDB", ps->pdb->path);
+          ir->add(L"PDB GUID", bela::StringCat(ps->pdb->guid, L" age ", ps->pdb->age));
+        }
+        if (!ps->rich.empty()) {
+          std::vector<std::wstring> rich;
+          for (const auto &r : ps->rich) {
+            rich.emplace_back(
+                bela::StringCat(L"product ", r.product, L" build ", r.build, L" count ", r.count));
+          }
+          ir->add(ps->richvalid ? L"Rich" : L"Rich (bad checksum)", std::move(rich));
+        }
+        if (ps->exportcount != 0) {
+          ir->add(L"Export Name", ps->exportname);
+          ir->add(L"Exports", ps->exportcount);
+        }
+        // two decimals is enough for entropy
+        auto entropy = [](double e) { return std::round(e * 100) / 100; };
+        std::vector<std::wstring> sections;
+        for (const auto &s : ps->sections) {
+          sections.emplace_back(bela::StringCat(s.name, L" entropy ", entropy(s.entropy),
+                                                L" raw ", s.rawsize, L" virtual ", s.virtualsize));
+        }
+        if (!sections.empty()) {
+          ir->add(L"Sections", std::move(sections));
+        }
+        if (ps->overlay) {
+          ir->add(L"Overlay", bela::StringCat(L"offset ", ps->overlay->offset, L" size ",
+                                              ps->overlay->size, L" entropy ",
+                                              entropy(ps->overlay->entropy)));
+        }
+        if (!ps->packer.empty()) {
+          ir->add(L"Packer", ps->packer);
+        }
+        if (!ps->anomalies.empty()) {
+          ir->add(L"Anomalies", ps->anomalies);
+        }
+      }
+    }
+    if (ir->typeex() == inquisitive::types::MACHO) {
+      // hashing every code page reads the whole image, only --verify asks for it
+      auto ms = inquisitive::inquisitive_macho(
+          file, ec,
+          inquisitive::MachOCodeSign | (verify ? inquisitive::MachOVerifyPages : 0));
+      if (!ec && ms) {
+        ir->add(L"Machine", ms->machine);
+        ir->add(L"Mach-O type", ms->mtype);
+        std::vector<std::wstring> slices;
+        for (const auto &s : ms->slices) {
+          slices.emplace_back(bela::StringCat(s.machine, L" ", s.mtype, L" offset ", s.offset,
+                                              L" size ", s.size));
+        }
+        if (!slices.empty()) {
+          ir->add(L"Slices", std::move(slices));
+        }
+        if (!ms->uuid.empty()) {
+          ir->add(L"UUID", ms->uuid);
+        }
+        if (!ms->platform.empty()) {
+          ir->add(L"Platform", ms->platform);
+          ir->add(L"Minimum OS", ms->minos);
+          ir->add(L"SDK", ms->sdk);
+        }
+        if (!ms->dylibid.empty()) {
+          ir->add(L"Install name", ms->dylibid);
+        }
+        ir->add(L"Code signature", std::wstring_view(ms->signature ? L"yes" : L"no"));
+        if (ms->codesign) {
+          const auto &cs = *ms->codesign;
+          ir->add(L"Identifier", cs.identifier);
+          if (!cs.teamid.empty()) {
+            ir->add(L"Team ID", cs.teamid);
+          }
+          ir->add(L"Signature type",
+                  std::wstring_view(cs.cms ? L"CMS" : (cs.adhoc ? L"ad hoc" : L"none")));
+          ir->add(L"CDHash", bela::StringCat(cs.cdhash, L" (", cs.hashtype, L")"));
+          ir->add(L"Page size", cs.pagesize);
+          if (cs.entitlementssize != 0) {
+            ir->add(L"Entitlements", bela::StringCat(L"offset ", cs.entitlementsoffset, L" size ",
+                                                     cs.entitlementssize));
+          }
+          if (cs.pagesverified) {
+            ir->add(L"Page hashes",
+                    cs.mismatched.empty()
+                        ? bela::StringCat(cs.codeslots, L" pages verified")
+                        : bela::StringCat(cs.mismatched.size(), L" of ", cs.codeslots,
+                                          L" pages mismatched, first page ", cs.mismatched[0]));
+          }
+        }
+        std::vector<std::wstring> depends;
+        for (const auto &d : ms->depends) {
+          depends.emplace_back(bela::StringCat(d.name, L" (", d.version, L")"));
+        }
+        for (const auto &d : ms->weakdepends) {
+          depends.emplace_back(bela::StringCat(d.name, L" (", d.version, L", weak)"));
+        }
+        ir->add(L"Depends", std::move(depends));
+        if (!ms->rpaths.empty()) {
+          ir->add(L"Rpaths", ms->rpaths);
+        }
+      }
+    }
+    if (ir->type() == inquisitive::types::elf_core) {
+      auto cs = inquisitive::inquisitive_elfcore(file, ec);
+      if (!ec && cs) {
+        ir->add(L"Machine", cs->machine);
+        if (!cs->command.empty()) {
+          ir->add(L"Command", cs->command);
+        }
+        ir->add(L"Pid", cs->pid);
+        ir->add(L"Signal", cs->signal);
+        ir->add(L"Threads", cs->threads);
+        ir->add(L"Load segments", cs->loads);
+        std::vector<std::wstring> files;
+        for (const auto &f : cs->files) {
+          files.emplace_back(bela::StringCat(bela::Hex(f.start), L"-", bela::Hex(f.end), L" ",
+                                             f.path));
+        }
+        ir->add(L"Mapped files", std::move(files));
+        if (cs->incomplete) {
+          ir->add(L"Notes", std::wstring_view(L"incomplete, core is truncated"));
+        }
+      }
+    } else if (ir->typeex() == inquisitive::types::ELF) {
+      auto es = inquisitive::inquisitive_elf(file, ec, inquisitive::ElfSections);
+      if (!ec && es) {
+        ir->add(L"Machine", es->machine);
+        ir->add(L"OS ABI", es->osabi);
+        if (!es->soname.empty()) {
+          ir->add(L"Soname", es->soname);
+        }
+        if (!es->glibc.empty()) {
+          ir->add(L"Minimum glibc", es->glibc);
+        }
+        if (!es->glibcxx.empty()) {
+          ir->add(L"Minimum libstdc++", es->glibcxx);
+        }
+        ir->add(L"Depends", es->depends);
+        for (const auto &n : es->verneeds) {
+          std::vector<std::wstring> versions;
+          for (const auto &v : n.versions) {
+            versions.emplace_back(bela::StringCat(v.name, L" (", v.symbols, L" symbols)"));
+          }
+          ir->add(bela::StringCat(L"Versions ", n.file), std::move(versions));
+        }
+        if (es->sections) {
+          const auto &s = *es->sections;
+          ir->add(L"Text size", s.text);
+          ir->add(L"Rodata size", s.rodata);
+          ir->add(L"Data size", s.data);
+          ir->add(L"Bss size", s.bss);
+          ir->add(L"Debug size", s.debug);
+          ir->add(L"Relocations size", s.relocations);
+          ir->add(L"Symbols size", s.symbols);
+          ir->add(L"Strippable", s.strippable);
+          std::vector<std::wstring> compressed;
+          for (const auto &c : s.compressed) {
+            compressed.emplace_back(bela::StringCat(c.name, L" ", c.compression, L" ", c.size,
+                                                    L" -> ", c.uncompressed));
+          }
+          if (!compressed.empty()) {
+            ir->add(L"Compressed sections", std::move(compressed));
+          }
+        }
       }
     }
     auto al = ir->alignlen() + 4;
@@ -119,4 +386,145 @@ int wmain(int argc, wchar_t **argv) {
     }
   }
   return 0;
-}
\ No newline at end of file
+}
+
+std::wstring NestedFlags(uint32_t flags) {
+  constexpr struct {
+    uint32_t flag;
+    std::wstring_view name;
+  } names[] = {
+      {inquisitive::NestedDepthLimit, L"depth limit"},
+      {inquisitive::NestedMemberLimit, L"member limit"},
+      {inquisitive::NestedBomb, L"ratio over cap"},
+      {inquisitive::NestedMemoryLimit, L"memory limit"},
+      {inquisitive::NestedDamaged, L"damaged"},
+      {inquisitive::NestedUnsupported, L"unsupported"},
+      {inquisitive::NestedEncrypted, L"encrypted"},
+      {inquisitive::NestedMemoryBudget, L"memory budget exceeded"},
+  };
+  std::wstring s;
+  for (const auto &n : names) {
+    if ((flags & n.flag) != 0) {
+      s.append(s.empty() ? L" [" : L", ").append(n.name);
+    }
+  }
+  if (!s.empty()) {
+    s.push_back(L']');
+  }
+  return s;
+}
+
+void PrintNode(const inquisitive::inquisitive_node_t &node, size_t indent) {
+  std::wstring space(indent * 2, L' ');
+  planck::PrintNone(L"%s%s: %s (%d bytes)%s\n", space, node.name,
+                    node.description.empty() ? L"data" : node.description, node.size,
+                    NestedFlags(node.flags));
+  for (const auto &c : node.children) {
+    PrintNode(c, indent + 1);
+  }
+}
+
+int ProcessNested(std::wstring_view file, const inquisitive::nested_options_t &opts) {
+  bela::error_code ec;
+  auto node = inquisitive::inquisitive_nested(file, ec, opts);
+  if (!node) {
+    planck::error(L"Error %s\n", ec.message);
+    return 1;
+  }
+  PrintNode(*node, 0);
+  return 0;
+}
+
+int ProcessVerify(std::wstring_view file) {
+  bela::error_code ec;
+  // Mach-O page hashes are checked and printed with the other Mach-O details
+  if (auto ir = inquisitive::inquisitive(file, ec);
+      ir && ir->typeex() == inquisitive::types::MACHO) {
+    return ProcessFile(file, true);
+  }
+  auto vr = inquisitive::inquisitive_verify(file, ec);
+  if (!vr) {
+    planck::error(L"Error %s\n", ec.message);
+    return 1;
+  }
+  for (const auto &f : vr->failures) {
+    switch (f.status) {
+    case inquisitive::VerifyCRC:
+      planck::PrintNone(L"%s: CRC-32 mismatch, expected %08x got %08x\n", f.name, f.crc,
+                        f.computed);
+      break;
+    case inquisitive::VerifySize:
+      planck::PrintNone(L"%s: size mismatch, expected %d got %d\n", f.name, f.size, f.actual);
+      break;
+    case inquisitive::VerifyDamaged:
+      planck::PrintNone(L"%s: data damaged after %d bytes\n", f.name, f.actual);
+      break;
+    case inquisitive::VerifyUnsupported:
+      planck::PrintNone(L"%s: compression method not supported, skipped\n", f.name);
+      break;
+    case inquisitive::VerifyEncrypted:
+      planck::PrintNone(L"%s: encrypted, skipped\n", f.name);
+      break;
+    default:
+      break;
+    }
+  }
+  planck::PrintNone(L"%s: %d of %d members verified, %d bytes checked\n", file, vr->verified,
+                    vr->members, vr->bytes);
+  return vr->verified == vr->members ? 0 : 1;
+}
+
+int ProcessExport(std::wstring_view file, std::wstring_view name) {
+  bela::error_code ec;
+  auto e = inquisitive::inquisitive_pe_export(file, name, ec);
+  if (!e) {
+    planck::error(L"Error %s: %s\n", name, ec.message);
+    return 1;
+  }
+  if (!e->forwarder.empty()) {
+    planck::PrintNone(L"%s: %s ordinal %d forwarded to %s\n", file, e->name, e->ordinal,
+                      e->forwarder);
+    return 0;
+  }
+  planck::PrintNone(L"%s: %s ordinal %d RVA 0x%08x\n", file, e->name, e->ordinal, e->address);
+  return 0;
+}
+
+int wmain(int argc, wchar_t **argv) {
+  AppArgv av;
+  if (!ParseArgv(argc, argv, av)) {
+    Usage();
+    return 1;
+  }
+  int rc = 0;
+  for (const auto file : av) {
+    if (av.list) {
+      if (!ProcessList(file, stdout)) {
+        rc = 1;
+      }
+      continue;
+    }
+    if (!av.exportname.empty()) {
+      if (ProcessExport(file, av.exportname) != 0) {
+        rc = 1;
+      }
+      continue;
+    }
+    if (av.verify) {
+      if (ProcessVerify(file) != 0) {
+        rc = 1;
+      }
+      continue;
+    }
+    if (av.recursive) {
+      if (ProcessNested(file, av.nested) != 0) {
+        rc = 1;
+      }
+      continue;
+    }
+    if (ProcessFile(file, false) != 0) {
+      rc = 1;
+    }
+  }
+  return rc;
+}
@@ -0,0 +1,378 @@
+/////////// LIST ZIP AND TAR ENTRIES
+#include <cstdio>
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <charconv>
+#include <bela/base.hpp>
+#include <bela/terminal.hpp>
+#include <mapview.hpp>
+#include "console/console.hpp"
+#include "zip.hpp"
+#include "tar.hpp"
+
+// IBM437 upper half, names without EFS flag are encoded by it
+static const char16_t cp437[] = {
+    0x00C7, 0x00FC, 0x00E9, 0x00E2, 0x00E4, 0x00E0, 0x00E5, 0x00E7, 0x00EA, 0x00EB, 0x00E8,
+    0x00EF, 0x00EE, 0x00EC, 0x00C4, 0x00C5, 0x00C9, 0x00E6, 0x00C6, 0x00F4, 0x00F6, 0x00F2,
+    0x00FB, 0x00F9, 0x00FF, 0x00D6, 0x00DC, 0x00A2, 0x00A3, 0x00A5, 0x20A7, 0x0192, 0x00E1,
+    0x00ED, 0x00F3, 0x00FA, 0x00F1, 0x00D1, 0x00AA, 0x00BA, 0x00BF, 0x2310, 0x00AC, 0x00BD,
+    0x00BC, 0x00A1, 0x00AB, 0x00BB, 0x2591, 0x2592, 0x2593, 0x2502, 0x2524, 0x2561, 0x2562,
+    0x2556, 0x2555, 0x2563, 0x2551, 0x2557, 0x255D, 0x255C, 0x255B, 0x2510, 0x2514, 0x2534,
+    0x252C, 0x251C, 0x2500, 0x253C, 0x255E, 0x255F, 0x255A, 0x2554, 0x2569, 0x2566, 0x2560,
+    0x2550, 0x256C, 0x2567, 0x2568, 0x2564, 0x2565, 0x2559, 0x2558, 0x2552, 0x2553, 0x256B,
+    0x256A, 0x2518, 0x250C, 0x2588, 0x2584, 0x258C, 0x2590, 0x2580, 0x03B1, 0x00DF, 0x0393,
+    0x03C0, 0x03A3, 0x03C3, 0x00B5, 0x03C4, 0x03A6, 0x0398, 0x03A9, 0x03B4, 0x221E, 0x03C6,
+    0x03B5, 0x2229, 0x2261, 0x00B1, 0x2265, 0x2264, 0x2320, 0x2321, 0x00F7, 0x2248, 0x00B0,
+    0x2219, 0x00B7, 0x221A, 0x207F, 0x00B2, 0x25A0, 0x00A0};
+
+// Info-ZIP on Unix stores UTF-8 names without EFS flag, IBM437 text is almost never valid UTF-8
+static bool IsValidUTF8(std::string_view sv) {
+  size_t i = 0;
+  while (i < sv.size()) {
+    auto ch = static_cast<uint8_t>(sv[i]);
+    size_t n = 0;
+    if (ch < 0x80) {
+      i++;
+      continue;
+    }
+    if (ch >= 0xC2 && ch <= 0xDF) {
+      n = 1;
+    } else if (ch >= 0xE0 && ch <= 0xEF) {
+      n = 2;
+    } else if (ch >= 0xF0 && ch <= 0xF4) {
+      n = 3;
+    } else {
+      return false;
+    }
+    if (n > sv.size() - i - 1) {
+      return false;
+    }
+    for (size_t k = 1; k <= n; k++) {
+      if ((static_cast<uint8_t>(sv[i + k]) & 0xC0) != 0x80) {
+        return false;
+      }
+    }
+    i += n + 1;
+  }
+  return true;
+}
+
+static std::string_view MethodName(uint16_t method) {
+  switch (method) {
+  case 0:
+    return "Stored";
+  case 1:
+    return "Shrunk";
+  case 6:
+    return "Implode";
+  case 8:
+    return "Deflate";
+  case 9:
+    return "Defl64";
+  case 12:
+    return "BZip2";
+  case 14:
+    return "LZMA";
+  case 93:
+    return "Zstd";
+  case 95:
+    return "XZ";
+  case 98:
+    return "PPMd";
+  case 99:
+    return "AES";
+  default:
+    break;
+  }
+  return "";
+}
+
+// ListWriter formats every entry into one reused UTF-8 buffer, flushed by large chunks
+class ListWriter {
+public:
+  ListWriter(FILE *out) : out(out) {
+    // console takes UTF-16, files and pipes take UTF-8 as is
+    DWORD mode = 0;
+    console = (out == stdout && GetConsoleMode(GetStdHandle(STD_OUTPUT_HANDLE), &mode) == TRUE);
+    buffer.reserve(flushsize + 4096);
+  }
+  ListWriter(const ListWriter &) = delete;
+  ListWriter &operator=(const ListWriter &) = delete;
+  ~ListWriter() { Flush(); }
+  void Append(std::string_view sv) { buffer.append(sv.data(), sv.size()); }
+  void Append(char ch, size_t n = 1) { buffer.append(n, ch); }
+  void AppendNumber(uint64_t v, size_t width, int base = 10, char pad = ' ') {
+    char digits[24];
+    auto r = std::to_chars(digits, digits + sizeof(digits), v, base);
+    auto n = static_cast<size_t>(r.ptr - digits);
+    if (n < width) {
+      buffer.append(width - n, pad);
+    }
+    buffer.append(digits, n);
+  }
+  void AppendName(const inquisitive::zip_entry_t &e) {
+    if (e.utf8 || IsValidUTF8(e.name)) {
+      Append(e.name);
+      return;
+    }
+    for (auto c : e.name) {
+      auto ch = static_cast<uint8_t>(c);
+      if (ch < 0x80) {
+        buffer.push_back(c);
+        continue;
+      }
+      auto u = static_cast<uint32_t>(cp437[ch - 0x80]);
+      if (u < 0x800) {
+        buffer.push_back(static_cast<char>(0xC0 | (u >> 6)));
+      } else {
+        buffer.push_back(static_cast<char>(0xE0 | (u >> 12)));
+        buffer.push_back(static_cast<char>(0x80 | ((u >> 6) & 0x3F)));
+      }
+      buffer.push_back(static_cast<char>(0x80 | (u & 0x3F)));
+    }
+  }
+  void EndLine() {
+    buffer.push_back('\n');
+    // flush only on line boundary, UTF-8 sequence never split
+    if (buffer.size() >= flushsize) {
+      Flush();
+    }
+  }
+  bool Flush() {
+    if (buffer.empty()) {
+      return true;
+    }
+    bool ok = true;
+    if (console) {
+      planck::WriteWide(buffer);
+    } else {
+      ok = fwrite(buffer.data(), 1, buffer.size(), out) == buffer.size();
+    }
+    buffer.clear();
+    return ok;
+  }
+
+private:
+  static constexpr size_t flushsize = 64 * 1024;
+  std::string buffer;
+  FILE *out{nullptr};
+  bool console{false};
+};
+
+// civil date from unix seconds, UTC
+// http://howardhinnant.github.io/date_algorithms.html#civil_from_days
+static void AppendUnixTime(ListWriter &w, int64_t t) {
+  auto days = t >= 0 ? t / 86400 : (t - 86399) / 86400;
+  auto secs = t - days * 86400;
+  auto z = days + 719468;
+  auto era = (z >= 0 ? z : z - 146096) / 146097;
+  auto doe = z - era * 146097;
+  auto yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  auto doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  auto mp = (5 * doy + 2) / 153;
+  auto d = doy - (153 * mp + 2) / 5 + 1;
+  auto m = mp < 10 ? mp + 3 : mp - 9;
+  auto y = yoe + era * 400 + (m <= 2 ? 1 : 0);
+  w.AppendNumber(static_cast<uint64_t>(y), 4, 10, '0');
+  w.Append('-');
+  w.AppendNumber(static_cast<uint64_t>(m), 2, 10, '0');
+  w.Append('-');
+  w.AppendNumber(static_cast<uint64_t>(d), 2, 10, '0');
+  w.Append(' ');
+  w.AppendNumber(static_cast<uint64_t>(secs / 3600), 2, 10, '0');
+  w.Append(':');
+  w.AppendNumber(static_cast<uint64_t>(secs / 60 % 60), 2, 10, '0');
+  w.Append(':');
+  w.AppendNumber(static_cast<uint64_t>(secs % 60), 2, 10, '0');
+}
+
+// DOS date and time, local time of archiver
+static void AppendDosTime(ListWriter &w, uint16_t mdate, uint16_t mtime) {
+  w.AppendNumber(1980 + (mdate >> 9), 4, 10, '0');
+  w.Append('-');
+  w.AppendNumber((mdate >> 5) & 0xF, 2, 10, '0');
+  w.Append('-');
+  w.AppendNumber(mdate & 0x1F, 2, 10, '0');
+  w.Append(' ');
+  w.AppendNumber(mtime >> 11, 2, 10, '0');
+  w.Append(':');
+  w.AppendNumber((mtime >> 5) & 0x3F, 2, 10, '0');
+  w.Append(':');
+  w.AppendNumber((mtime & 0x1F) * 2, 2, 10, '0');
+}
+
+// space saved like unzip -v, clamp expanded entries to zero
+static void AppendRatio(ListWriter &w, uint64_t compressed, uint64_t uncompressed) {
+  uint64_t saved = 0;
+  if (compressed < uncompressed) {
+    auto d = uncompressed - compressed;
+    saved = uncompressed > UINT64_MAX / 100 ? d / (uncompressed / 100) : d * 100 / uncompressed;
+  }
+  w.AppendNumber(saved, 3);
+  w.Append('%');
+}
+
+static bool ListZip(std::wstring_view sv, base::WindowView &wv, FILE *out) {
+  bela::error_code ec;
+  inquisitive::zip_directory_t zd;
+  if (!inquisitive::zip_directory_locate(wv, zd, ec)) {
+    bela::FPrintF(stderr, L"planck: list %s: %s\n", sv, ec.message);
+    return false;
+  }
+  // whole central directory stays mapped, entries are views into it
+  auto cd = wv.Window(zd.offset, static_cast<size_t>(zd.size), ec);
+  if (cd.size() != zd.size) {
+    bela::FPrintF(stderr, L"planck: list %s: central directory unreadable %s\n", sv, ec.message);
+    return false;
+  }
+  ListWriter w(out);
+  w.Append("      Length  Method           Size  Cmpr  Modified             CRC-32    Name\n"
+           "------------  -------  ------------  ----  -------------------  --------  ----\n");
+  inquisitive::zip_central_reader reader(cd, zd.prefix);
+  inquisitive::zip_entry_t e;
+  uint64_t count = 0;
+  uint64_t usize = 0;
+  uint64_t csize = 0;
+  while (reader.next(e)) {
+    count++;
+    usize += e.uncompressedsize;
+    csize += e.compressedsize;
+    w.AppendNumber(e.uncompressedsize, 12);
+    w.Append("  ");
+    auto method = MethodName(e.method);
+    char unknown[8] = {'M'};
+    if (method.empty()) {
+      auto r = std::to_chars(unknown + 1, unknown + sizeof(unknown), e.method);
+      method = std::string_view(unknown, r.ptr - unknown);
+    }
+    w.Append(method);
+    w.Append(' ', 9 - method.size());
+    w.AppendNumber(e.compressedsize, 12);
+    w.Append("  ");
+    AppendRatio(w, e.compressedsize, e.uncompressedsize);
+    w.Append("  ");
+    if (e.unixmtime >= 0) {
+      AppendUnixTime(w, e.unixmtime);
+    } else {
+      AppendDosTime(w, e.mdate, e.mtime);
+    }
+    w.Append("  ");
+    w.AppendNumber(e.crc32, 8, 16, '0');
+    w.Append((e.flags & inquisitive::zip_flag_encrypted) != 0 ? "* " : "  ");
+    w.AppendName(e);
+    w.EndLine();
+  }
+  w.Append("------------           ------------  ----                                 ----\n");
+  w.AppendNumber(usize, 12);
+  w.Append(' ', 11);
+  w.AppendNumber(csize, 12);
+  w.Append("  ");
+  AppendRatio(w, csize, usize);
+  w.Append(' ', 33);
+  w.AppendNumber(count, 1);
+  w.Append(count == 1 ? " file" : " files");
+  w.EndLine();
+  if (!w.Flush()) {
+    return false;
+  }
+  if (!reader.complete(count, zd)) {
+    bela::FPrintF(stderr, L"planck: list %s: central directory damaged, %d of %d entries read\n",
+                  sv, count, zd.entries);
+    return false;
+  }
+  return true;
+}
+
+// ls -l like mode, type from typeflag
+static void AppendMode(ListWriter &w, const inquisitive::tar_entry_t &e) {
+  char type = '-';
+  switch (e.typeflag) {
+  case '1':
+    type = 'h';
+    break;
+  case '2':
+    type = 'l';
+    break;
+  case '3':
+    type = 'c';
+    break;
+  case '4':
+    type = 'b';
+    break;
+  case '5':
+    type = 'd';
+    break;
+  case '6':
+    type = 'p';
+    break;
+  default:
+    break;
+  }
+  w.Append(type);
+  constexpr const char rwx[] = "rwxrwxrwx";
+  for (int i = 0; i < 9; i++) {
+    w.Append((e.mode & (0400 >> i)) != 0 ? rwx[i] : '-');
+  }
+}
+
+static bool ListTar(std::wstring_view sv, inquisitive::tar_reader &reader, FILE *out) {
+  ListWriter w(out);
+  w.Append("Mode              Length  Modified             Name\n"
+           "----------  ------------  -------------------  ----\n");
+  inquisitive::tar_entry_t e;
+  uint64_t count = 0;
+  uint64_t total = 0;
+  while (reader.next(e)) {
+    count++;
+    total += e.realsize;
+    AppendMode(w, e);
+    w.Append("  ");
+    w.AppendNumber(e.realsize, 12);
+    w.Append("  ");
+    AppendUnixTime(w, e.mtime);
+    w.Append(e.sparse ? "* " : "  ");
+    // TAR names are bytes, modern archivers write UTF-8
+    w.Append(e.name);
+    if (e.typeflag == '1' || e.typeflag == '2') {
+      w.Append(e.typeflag == '1' ? " link to " : " -> ");
+      w.Append(e.linkname);
+    }
+    w.EndLine();
+  }
+  w.Append("----------  ------------                       ----\n");
+  w.Append(' ', 12);
+  w.AppendNumber(total, 12);
+  w.Append(' ', 23);
+  w.AppendNumber(count, 1);
+  w.Append(count == 1 ? " file" : " files");
+  w.EndLine();
+  if (!w.Flush()) {
+    return false;
+  }
+  if (reader.bad()) {
+    bela::FPrintF(stderr, L"planck: list %s: archive damaged after %d entries\n", sv, count);
+    return false;
+  }
+  return true;
+}
+
+bool ProcessList(std::wstring_view sv, FILE *out) {
+  if (sv == L"-") {
+    // TAR from pipe, such as: zstd -dc backup.tar.zst | planck -l -
+    inquisitive::tar_reader reader(GetStdHandle(STD_INPUT_HANDLE));
+    return ListTar(L"<stdin>", reader, out);
+  }
+  base::WindowView wv;
+  bela::error_code ec;
+  if (!wv.Open(sv, ec, sizeof(inquisitive::zip_eocd_t))) {
+    bela::FPrintF(stderr, L"planck: list %s: %s\n", sv, ec.message);
+    return false;
+  }
+  auto block = wv.Window(0, inquisitive::tar_block_size, ec);
+  if (block.size() == inquisitive::tar_block_size && inquisitive::tar_checksum(block.data())) {
+    inquisitive::tar_reader reader(wv);
+    return ListTar(sv, reader, out);
+  }
+  return ListZip(sv, wv, out);
+}